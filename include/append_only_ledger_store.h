@@ -0,0 +1,87 @@
+/*
+ * Filename: append_only_ledger_store.h
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ *
+ * This file contains the declaration of the AppendOnlyLedgerStore class. This
+ * class keeps the ledger in the database, with the balances of the wallets
+ * derived from an append-only log of changes.
+ */
+
+#ifndef APPEND_ONLY_LEDGER_STORE_H_
+#define APPEND_ONLY_LEDGER_STORE_H_
+
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "config.h"
+#include "db_manager.h"
+#include "money.h"
+#include "sqlite_ledger_store.h"
+
+/**
+ * @brief Ledger stored in the database, with balances kept as an append-only log
+ *
+ * Every change to the balance of a wallet is appended to WalletLedgerEntry, in
+ * cents, instead of updating the row of the wallet. Every checkpointInterval
+ * entries the balance is written to WalletBalanceCheckpoint, so the balance
+ * after any entry is its last checkpoint plus fewer than checkpointInterval
+ * entries. Writers only append, and never contend for the row of the wallet.
+ *
+ * A wallet enters the ledger when it is created or first changed through this
+ * store, with its balance at that moment as the checkpoint of seq 0. From then
+ * on Wallet.balance keeps that opening value, and the balance must be read
+ * through a store. SqliteLedgerStore, BulkImporter and BalanceReconciler handle
+ * both kinds of wallets, so they can share the database with this store.
+ *
+ * Everything else is stored as SqliteLedgerStore stores it.
+ **/
+class AppendOnlyLedgerStore : public SqliteLedgerStore
+{
+    public:
+        /**
+         * @brief Constructor
+         * @param dbManager The database the ledger is stored in
+         * @param checkpointInterval The number of entries between checkpoints
+         **/
+        explicit AppendOnlyLedgerStore(DBManager& dbManager,
+                                       uint32_t   checkpointInterval =
+                                           config::LEDGER_CHECKPOINT_INTERVAL) noexcept;
+
+        bool InsertWallet(const std::string& name, Money balance) noexcept override;
+
+        /**
+         * @brief Set the balance of a wallet with an entry of the difference
+         **/
+        bool SetWalletBalance(const std::string& name,
+                              Money              balance) noexcept override;
+
+        std::optional<Money>
+        CreditWallet(const std::string& name, Money amount) noexcept override;
+
+        std::optional<Money>
+        DebitWallet(const std::string& name, Money amount) noexcept override;
+
+        /**
+         * @brief Get the balance of a wallet right after one of its entries
+         * @param name The wallet name
+         * @param seq The number of the entry, from 1. Zero is the balance the
+         *        wallet entered the ledger with
+         * @return The balance, or nothing if the wallet is not kept in the ledger
+         **/
+        std::optional<Money> GetBalanceAfterEntry(const std::string& name,
+                                                  int64_t            seq) noexcept;
+
+    private:
+        /**
+         * @brief Move a wallet to the ledger, with its balance at that moment as
+         *        the checkpoint of seq 0
+         **/
+        bool EnterLedger(const std::string& name) noexcept;
+};
+
+#endif // APPEND_ONLY_LEDGER_STORE_H_
@@ -0,0 +1,172 @@
+/*
+ * Filename: async_writer.h
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ *
+ * This file contains the declaration of the AsyncWriter class. This class runs
+ * database writes on a dedicated thread and commits them in groups.
+ */
+
+#ifndef ASYNC_WRITER_H_
+#define ASYNC_WRITER_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "log_manager.h"
+
+class DBManager;
+
+/**
+ * @brief Background writer with group commit
+ *
+ * Operations are pushed onto a lock-free multi-producer single-consumer queue and
+ * run by a dedicated thread. Every operation that arrives within the group commit
+ * window after the first one of a batch runs in the same transaction, so a batch
+ * pays for a single commit. Each operation runs in its own savepoint, so a failed
+ * operation is rolled back without affecting the others of the batch.
+ *
+ * The future returned for an operation is only completed after the transaction of
+ * its batch is committed.
+ **/
+class AsyncWriter
+{
+    public:
+        /**
+         * @brief Counters describing the writer usage
+         **/
+        struct Stats
+        {
+                uint64_t operations = 0;
+                uint64_t failed     = 0;
+                uint64_t batches    = 0;
+        };
+
+    private:
+        /**
+         * @brief Queue node. Owns the operation and the promise of its result
+         **/
+        struct Node
+        {
+                std::atomic<Node*>    next    = nullptr;
+                std::function<bool()> operation;
+                std::promise<bool>    promise;
+                bool                  barrier = false;
+        };
+
+        DBManager&                m_dbManager;
+        LogManager&               m_logger;
+        std::chrono::microseconds m_window;
+        std::size_t               m_maxBatchSize;
+
+        // Intrusive MPSC queue. Producers swap the head, the writer thread owns the
+        // tail. The stub node keeps the queue non-empty so no lock is needed
+        std::atomic<Node*> m_head;
+        Node*              m_tail;
+        Node               m_stub;
+
+        // Used only to put the writer thread to sleep when the queue is empty
+        std::atomic<bool>       m_sleeping;
+        std::atomic<bool>       m_stopping;
+        std::mutex              m_wakeMutex;
+        std::condition_variable m_wakeCondition;
+
+        std::atomic<uint64_t> m_operations;
+        std::atomic<uint64_t> m_failed;
+        std::atomic<uint64_t> m_batches;
+
+        std::thread m_thread;
+
+    public:
+        /**
+         * @brief Constructor. Starts the writer thread
+         * @param dbManager The database the operations write to
+         * @param window Time to wait for more operations before committing a batch
+         * @param maxBatchSize Maximum number of operations committed in one batch
+         **/
+        AsyncWriter(DBManager&                dbManager,
+                    std::chrono::microseconds window,
+                    std::size_t               maxBatchSize) noexcept;
+
+        /**
+         * @brief Destructor. Commits the pending operations and stops the thread
+         **/
+        ~AsyncWriter() noexcept;
+
+        AsyncWriter(const AsyncWriter&)            = delete;
+        AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+        /**
+         * @brief Queue an operation to run on the writer thread
+         * @param operation Function that writes to the database through DBManager.
+         *        It returns false, or throws, to have its changes rolled back
+         * @return std::future<bool> True once the changes of the operation are
+         *         committed, false if it failed
+         **/
+        std::future<bool> Enqueue(std::function<bool()> operation) noexcept;
+
+        /**
+         * @brief Wait until every operation queued before this call is committed
+         * @return bool False if the writer is stopped or if called from an operation
+         **/
+        bool Flush() noexcept;
+
+        /**
+         * @brief Get the writer counters
+         **/
+        Stats GetStats() const noexcept;
+
+    private:
+        /**
+         * @brief Push a node onto the queue and wake the writer thread
+         **/
+        void Push(Node* node) noexcept;
+
+        /**
+         * @brief Append a node to the queue
+         **/
+        void Link(Node* node) noexcept;
+
+        /**
+         * @brief Pop the oldest node from the queue
+         * @return Node* The node, or nullptr if the queue is empty
+         * NOTE: Only called by the writer thread
+         **/
+        Node* Pop() noexcept;
+
+        /**
+         * @brief Pop a node, sleeping until one arrives, the deadline passes or the
+         *        writer is stopped
+         * @param deadline Time to give up waiting
+         * @return Node* The node, or nullptr if none arrived
+         **/
+        Node* WaitForNode(std::chrono::steady_clock::time_point deadline);
+
+        /**
+         * @brief Body of the writer thread
+         **/
+        void Run() noexcept;
+
+        /**
+         * @brief Run a batch of operations in a single transaction
+         * @param first The first operation of the batch
+         **/
+        void ProcessBatch(Node* first) noexcept;
+
+        /**
+         * @brief Run an operation in its own savepoint
+         * @return bool True if the operation succeeded
+         **/
+        bool RunOperation(Node& node) noexcept;
+};
+
+#endif // ASYNC_WRITER_H_
@@ -0,0 +1,131 @@
+/*
+ * Filename: balance_reconciler.h
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ *
+ * This file contains the declaration of the BalanceReconciler class. This class
+ * checks the stored balances of the wallets against their history and repairs
+ * the ones that drifted.
+ */
+
+#ifndef BALANCE_RECONCILER_H_
+#define BALANCE_RECONCILER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "config.h"
+#include "db_manager.h"
+#include "log_manager.h"
+#include "money.h"
+
+/**
+ * @brief Reconciliation of the wallet balances with the transaction log
+ *
+ * The balance of a wallet is recomputed as its opening balance plus its incomes
+ * and received transfers, minus its expenses and sent transfers, summed in
+ * cents. Wallets are split by name in contiguous ranges, one per thread, and
+ * each range is checked with a single query on its own reader connection, so
+ * the wallets are checked concurrently and each one from a consistent snapshot.
+ *
+ * The stored balance of a wallet kept in the append-only ledger is the one its
+ * entries add up to, and a repair appends an entry with the difference.
+ *
+ * Without reader connections, as with in-memory databases, the ranges take
+ * turns on the writer.
+ **/
+class BalanceReconciler
+{
+    public:
+        /**
+         * @brief Wallet whose stored balance differs from its history
+         **/
+        struct Mismatch
+        {
+                std::string wallet;
+                Money       stored;
+                Money       computed;
+        };
+
+        /**
+         * @brief Outcome of a reconciliation
+         **/
+        struct Stats
+        {
+                uint64_t                 wallets    = 0;
+                uint64_t                 mismatches = 0;
+                uint64_t                 repaired   = 0;
+                std::size_t              partitions = 0;
+                std::chrono::nanoseconds elapsed{ 0 };
+        };
+
+    private:
+        /**
+         * @brief Wallets of one thread, from first to last by name, and what the
+         *        thread found
+         **/
+        struct Partition
+        {
+                std::string           first;
+                std::string           last;
+                std::vector<Mismatch> mismatches;
+                uint64_t              wallets = 0;
+                bool                  checked = false;
+        };
+
+        DBManager&  m_dbManager;
+        LogManager& m_logManager;
+        std::size_t m_threads;
+
+    public:
+        /**
+         * @brief Default constructor
+         **/
+        BalanceReconciler() noexcept;
+
+        /**
+         * @brief Constructor
+         * @param dbManager The database whose wallets are reconciled
+         * @param threads The number of threads the wallets are split among
+         **/
+        explicit BalanceReconciler(
+            DBManager&  dbManager,
+            std::size_t threads = config::RECONCILER_THREADS) noexcept;
+
+        /**
+         * @brief Find the wallets whose stored balance differs from their history
+         * @param mismatches The vector to store the mismatches, ordered by wallet
+         * @param stats Filled with the counts and the time taken
+         * @return bool True if every wallet was checked
+         * NOTE: All data stored in the vector will be lost
+         **/
+        bool Check(std::vector<Mismatch>& mismatches, Stats& stats) noexcept;
+
+        /**
+         * @brief Find the mismatches as Check does, and set the balances and the
+         *        daily balances of those wallets from their history
+         *
+         * The repair runs in a single transaction. Each wallet is checked again
+         * inside it, so writes made after the check are taken into account.
+         *
+         * @param mismatches The vector to store the mismatches, ordered by wallet
+         * @param stats Filled with the counts and the time taken
+         * @return bool True if every wallet was checked and every mismatch was
+         *         repaired. Nothing is repaired if false is returned
+         * NOTE: All data stored in the vector will be lost
+         * NOTE: WalletManager caches the balances, call its ReloadCache after a
+         *       repair
+         **/
+        bool Repair(std::vector<Mismatch>& mismatches, Stats& stats) noexcept;
+
+    private:
+        /**
+         * @brief Check the wallets of a partition. Body of each thread
+         **/
+        void CheckPartition(Partition& partition) noexcept;
+};
+
+#endif // BALANCE_RECONCILER_H_
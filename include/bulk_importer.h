@@ -0,0 +1,298 @@
+/*
+ * Filename: bulk_importer.h
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ *
+ * This file contains the declaration of the BulkImporter class. This class loads
+ * bank statements into a wallet, parsing and inserting the rows in a pipeline.
+ */
+
+#ifndef BULK_IMPORTER_H_
+#define BULK_IMPORTER_H_
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "db_manager.h"
+#include "ledger_store.h"
+#include "log_manager.h"
+#include "money.h"
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ **/
+class MappedFile
+{
+    private:
+        const char* m_data;
+        std::size_t m_size;
+
+    public:
+        /**
+         * @brief Map a file. The mapping is empty if the file cannot be mapped
+         * @param path Path of the file
+         **/
+        explicit MappedFile(const std::string& path) noexcept;
+
+        /**
+         * @brief Destructor. Unmaps the file
+         **/
+        ~MappedFile() noexcept;
+
+        MappedFile(const MappedFile&)            = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /**
+         * @brief Check if the file was mapped
+         **/
+        bool IsOpen() const noexcept;
+
+        /**
+         * @brief Get the contents of the file
+         **/
+        std::string_view Data() const noexcept;
+};
+
+/**
+ * @brief Bulk loader of bank statements into a wallet
+ *
+ * The import runs as a pipeline. A parser thread splits the input in rows,
+ * validates them and hands them over in chunks. Meanwhile the calling thread
+ * resolves their categories and inserts them with multi-row inserts, all in a
+ * single transaction. The balance of the wallet is updated once, at the end.
+ *
+ * CSV input has one row per line with the columns date (YYYY-MM-DD),
+ * description, category and amount. Negative amounts are expenses and positive
+ * ones are incomes. Fields may be quoted, with "" standing for a quote, and a
+ * first line starting with "date" is taken as a header.
+ *
+ * OFX input has one STMTTRN block per row. The date comes from DTPOSTED, the
+ * amount from TRNAMT and the description from MEMO, or NAME if there is no memo.
+ *
+ * Rows with no category are put in config::IMPORT_DEFAULT_CATEGORY. Categories
+ * that do not exist are created. Invalid rows are skipped and logged.
+ **/
+class BulkImporter
+{
+    public:
+        enum class Format
+        {
+            Csv,
+            Ofx
+        };
+
+        /**
+         * @brief Outcome of an import
+         **/
+        struct Stats
+        {
+                uint64_t                 rows     = 0;
+                uint64_t                 imported = 0;
+                uint64_t                 rejected = 0;
+                std::chrono::nanoseconds elapsed{ 0 };
+
+                /**
+                 * @brief Get the throughput of the import
+                 **/
+                double RowsPerSecond() const noexcept;
+        };
+
+    private:
+        /**
+         * @brief A validated row. Text fields point into the input, or into the
+         *        storage of their chunk when they had to be unescaped, and the
+         *        amount is rounded to the cent as it is parsed
+         **/
+        struct Row
+        {
+                uint64_t             line;
+                std::array<char, 10> date;
+                std::string_view     description;
+                std::string_view     category;
+                Money                amount;
+        };
+
+        /**
+         * @brief Rows handed over from the parser thread to the inserting thread
+         **/
+        struct Chunk
+        {
+                std::vector<Row>        rows;
+                std::deque<std::string> storage;
+
+                // Line and reason of each rejected row
+                std::vector<std::pair<uint64_t, const char*>> rejected;
+        };
+
+        /**
+         * @brief Bounded queue of chunks between the two stages
+         **/
+        class ChunkQueue
+        {
+            private:
+                std::mutex              m_mutex;
+                std::condition_variable m_changed;
+                std::deque<Chunk>       m_chunks;
+                std::size_t             m_capacity;
+                bool                    m_closed;
+
+            public:
+                explicit ChunkQueue(std::size_t capacity) noexcept;
+
+                /**
+                 * @brief Add a chunk, waiting while the queue is full
+                 * @return bool False if the queue was closed
+                 **/
+                bool Push(Chunk&& chunk);
+
+                /**
+                 * @brief Take the oldest chunk, waiting while the queue is empty
+                 * @return std::optional<Chunk> The chunk, or nothing once the queue
+                 *         is closed and drained
+                 **/
+                std::optional<Chunk> Pop();
+
+                /**
+                 * @brief Wake the waiting threads. Pushes fail from now on
+                 **/
+                void Close() noexcept;
+        };
+
+        /**
+         * @brief Changes of an import, applied once every row is inserted
+         **/
+        struct Totals
+        {
+                // Net change of the wallet, in total and on each day by date
+                Money                                     balanceDelta;
+                std::map<std::string, Money, std::less<>> days;
+
+                // Cells of the spending summary by month, category and kind
+                std::map<std::tuple<std::string, int64_t, std::string>, SpendingCell>
+                    spending;
+        };
+
+        struct CategoryHash
+        {
+                using is_transparent = void;
+
+                std::size_t operator()(std::string_view name) const noexcept
+                {
+                    return std::hash<std::string_view>()(name);
+                }
+        };
+
+        DBManager&  m_dbManager;
+        LogManager& m_logManager;
+
+        // Category ids by name, loaded when an import starts and extended as
+        // categories are created
+        std::unordered_map<std::string, int64_t, CategoryHash, std::equal_to<>>
+            m_categories;
+
+    public:
+        /**
+         * @brief Default constructor
+         **/
+        BulkImporter() noexcept;
+
+        /**
+         * @brief Constructor
+         * @param dbManager The database the rows are imported into
+         **/
+        explicit BulkImporter(DBManager& dbManager) noexcept;
+
+        /**
+         * @brief Import a statement file into a wallet
+         * @param path Path of the file
+         * @param walletName The wallet, which must exist
+         * @param format Format of the file
+         * @param stats Filled with the row counts and the throughput
+         * @return bool True if the valid rows were imported. Nothing is imported
+         *         if false is returned
+         **/
+        bool ImportFile(const std::string& path,
+                        const std::string& walletName,
+                        Format             format,
+                        Stats&             stats) noexcept;
+
+        /**
+         * @brief Import a statement already in memory into a wallet
+         * @param data Contents of the statement
+         * @param walletName The wallet, which must exist
+         * @param format Format of the statement
+         * @param stats Filled with the row counts and the throughput
+         * @return bool True if the valid rows were imported. Nothing is imported
+         *         if false is returned
+         **/
+        bool ImportText(std::string_view   data,
+                        const std::string& walletName,
+                        Format             format,
+                        Stats&             stats) noexcept;
+
+    private:
+        /**
+         * @brief Body of the parser thread. Closes the queue when done
+         * @return bool False if the input could not be parsed to the end. Parsing
+         *         also stops early, but successfully, if the queue is closed
+         **/
+        bool Parse(std::string_view data, Format format, ChunkQueue& queue) noexcept;
+
+        /**
+         * @brief Split CSV input in rows
+         **/
+        void ParseCsv(std::string_view data, ChunkQueue& queue);
+
+        /**
+         * @brief Split OFX input in rows
+         **/
+        void ParseOfx(std::string_view data, ChunkQueue& queue);
+
+        /**
+         * @brief Validate the fields of a row and add it to a chunk
+         * @param date Date as YYYY-MM-DD or YYYYMMDD
+         **/
+        static void AddRow(Chunk&           chunk,
+                           uint64_t         line,
+                           std::string_view date,
+                           std::string_view description,
+                           std::string_view category,
+                           std::string_view amount);
+
+        /**
+         * @brief Insert the rows of a chunk
+         * @param totals Incremented by the rows inserted
+         * @return bool False if an insert failed
+         **/
+        bool InsertChunk(const Chunk&       chunk,
+                         const std::string& walletName,
+                         Totals&            totals) noexcept;
+
+        /**
+         * @brief Get the id of a category, creating it if needed
+         * @return std::optional<int64_t> The id, or nothing on error
+         **/
+        std::optional<int64_t> ResolveCategory(std::string_view name);
+
+        /**
+         * @brief Find the first comma, quote or line break of a CSV buffer
+         * @return const char* The character, or end if there is none
+         **/
+        static const char* FindCsvSpecial(const char* begin, const char* end) noexcept;
+};
+
+#endif // BULK_IMPORTER_H_
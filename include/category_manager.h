@@ -11,8 +11,10 @@
 #define CATEGORY_MANAGER_H_
 
 #include "db_manager.h"
+#include "ledger_store.h"
 #include "log_manager.h"
 #include <cstddef>
+#include <memory>
 #include <string>
 
 /**
@@ -22,8 +24,9 @@
 class CategoryManager
 {
     private:
-        DBManager&  m_dbManager;
-        LogManager& m_logManager;
+        std::unique_ptr<LedgerStore> m_ownedStore;
+        LedgerStore&                 m_store;
+        LogManager&                  m_logManager;
 
     public:
         /**
@@ -31,6 +34,18 @@ class CategoryManager
          **/
         CategoryManager();
 
+        /**
+         * @brief Constructor
+         * @param dbManager The database the categories are stored in
+         **/
+        explicit CategoryManager(DBManager& dbManager);
+
+        /**
+         * @brief Constructor
+         * @param store The store the categories are kept in
+         **/
+        explicit CategoryManager(LedgerStore& store);
+
         /**
          * @brief Default destructor
          **/
@@ -0,0 +1,212 @@
+/*
+ * Filename: connection_pool.h
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ *
+ * This file contains the declaration of the ConnectionPool class. This class owns
+ * the single writer connection to the database and a set of read-only connections
+ * used to run queries concurrently.
+ */
+
+#ifndef CONNECTION_POOL_H_
+#define CONNECTION_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sqlite3.h>
+#include <string>
+#include <vector>
+
+#include "log_manager.h"
+#include "statement_cache.h"
+
+/**
+ * @brief A database connection and the prepared statements cached for it
+ **/
+struct Connection
+{
+        sqlite3*                        handle = nullptr;
+        std::unique_ptr<StatementCache> statementCache;
+
+        // Version of the reader settings last applied to this connection
+        uint64_t settingsVersion = 0;
+};
+
+/**
+ * @brief Pool with one writer connection and up to N read-only connections
+ *
+ * The writer is shared and guarded by a recursive mutex, so a thread can keep it
+ * for a whole transaction. Readers are opened lazily and checked out exclusively.
+ * With the database in WAL mode, each reader sees the last committed snapshot and
+ * is never blocked by the writer.
+ **/
+class ConnectionPool
+{
+    public:
+        /**
+         * @brief RAII checkout of a read-only connection
+         **/
+        class ReaderLease
+        {
+            private:
+                ConnectionPool* m_pool;
+                Connection*     m_connection;
+
+                friend class ConnectionPool;
+
+                ReaderLease(ConnectionPool* pool, Connection* connection) noexcept;
+
+            public:
+                /**
+                 * @brief Construct an empty lease
+                 **/
+                ReaderLease() noexcept;
+
+                ReaderLease(ReaderLease&& other) noexcept;
+                ReaderLease& operator=(ReaderLease&& other) noexcept;
+
+                ReaderLease(const ReaderLease&)            = delete;
+                ReaderLease& operator=(const ReaderLease&) = delete;
+
+                /**
+                 * @brief Return the connection to the pool
+                 **/
+                ~ReaderLease() noexcept;
+
+                /**
+                 * @brief Get the leased connection
+                 * @return Connection* The connection, or nullptr if the lease is empty
+                 **/
+                Connection* Get() const noexcept;
+
+                explicit operator bool() const noexcept;
+        };
+
+    private:
+        LogManager&                              m_logger;
+        std::string                              m_path;
+        Connection                               m_writer;
+        std::recursive_mutex                     m_writerMutex;
+        std::vector<std::unique_ptr<Connection>> m_readers;
+        std::vector<Connection*>                 m_idleReaders;
+        std::size_t                              m_maxReaders;
+        std::function<void(sqlite3*)>            m_connectionSetup;
+        std::function<void(sqlite3*)>            m_readerSettings;
+        uint64_t                                 m_readerSettingsVersion;
+        std::mutex                               m_readerMutex;
+
+    public:
+        /**
+         * @brief Constructor
+         * @param logger The logger
+         **/
+        explicit ConnectionPool(LogManager& logger) noexcept;
+
+        /**
+         * @brief Destructor. Closes all connections
+         **/
+        ~ConnectionPool() noexcept;
+
+        ConnectionPool(const ConnectionPool&)            = delete;
+        ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+        /**
+         * @brief Open the writer connection
+         * @param path Path of the database file, ":memory:" or a SQLite URI
+         * @return bool True if the database was opened
+         **/
+        bool Open(const std::string& path) noexcept;
+
+        /**
+         * @brief Close all connections
+         * NOTE: No reader may be checked out when the pool is closed
+         **/
+        void Close() noexcept;
+
+        /**
+         * @brief Check if the writer connection is open
+         **/
+        bool IsOpen() const noexcept;
+
+        /**
+         * @brief Set the function that runs on every connection, writer or reader,
+         *        right after it is opened
+         * @param setup Function applied to the connection handle
+         * NOTE: Must be set before the pool is opened
+         **/
+        void SetConnectionSetup(std::function<void(sqlite3*)> setup) noexcept;
+
+        /**
+         * @brief Allow up to maxReaders read-only connections to be opened
+         * @param maxReaders Maximum number of readers. Zero disables the readers
+         * NOTE: Readers only help when the database is in WAL mode
+         **/
+        void SetMaxReaders(std::size_t maxReaders) noexcept;
+
+        /**
+         * @brief Set the function that configures reader connections
+         *
+         * The function runs on every reader before its next checkout, so readers
+         * that are in use are updated when they come back to the pool.
+         *
+         * @param settings Function applied to the reader connection handle
+         **/
+        void SetReaderSettings(std::function<void(sqlite3*)> settings) noexcept;
+
+        /**
+         * @brief Get the writer connection
+         * NOTE: The writer mutex must be held while the connection is used
+         **/
+        Connection& Writer() noexcept;
+
+        /**
+         * @brief Get the mutex that guards the writer connection
+         **/
+        std::recursive_mutex& WriterMutex() noexcept;
+
+        /**
+         * @brief Check out an idle reader, opening a new one if the pool allows it
+         * @return ReaderLease Empty lease if no reader is available. The caller
+         *         should then use the writer
+         **/
+        ReaderLease AcquireReader() noexcept;
+
+        /**
+         * @brief Get the number of reader connections currently open
+         **/
+        std::size_t GetReaderCount() noexcept;
+
+        /**
+         * @brief Get the prepared statement cache counters summed over all
+         *        connections
+         **/
+        StatementCache::Stats GetStatementCacheStats() noexcept;
+
+        /**
+         * @brief Finalize the cached statements of the writer and the idle readers
+         * NOTE: The writer mutex must be held by the caller
+         **/
+        void ClearStatementCaches() noexcept;
+
+    private:
+        /**
+         * @brief Return a reader to the pool
+         **/
+        void ReleaseReader(Connection* connection) noexcept;
+
+        /**
+         * @brief Open a new read-only connection
+         * @return std::unique_ptr<Connection> The connection, or nullptr on error
+         **/
+        std::unique_ptr<Connection> OpenReader() noexcept;
+
+        /**
+         * @brief Finalize the cached statements of a connection and close it
+         **/
+        static void CloseConnection(Connection& connection) noexcept;
+};
+
+#endif // CONNECTION_POOL_H_
@@ -12,10 +12,13 @@
 
 #include "category_manager.h"
 #include "db_manager.h"
+#include "ledger_store.h"
 #include "log_manager.h"
+#include "money.h"
 #include "utils.h"
 #include <cmath>
 #include <cstdint>
+#include <memory>
 
 /**
  * @brief The CreditCardManager class is responsible for managing the credit cards in
@@ -25,9 +28,10 @@
 class CreditCardManager
 {
     private:
-        DBManager&      m_dbManager;
-        LogManager&     m_logManager;
-        CategoryManager m_categoryManager;
+        std::unique_ptr<LedgerStore> m_ownedStore;
+        LedgerStore&                 m_store;
+        LogManager&                  m_logManager;
+        CategoryManager              m_categoryManager;
 
     public:
         /**
@@ -35,6 +39,18 @@ class CreditCardManager
          **/
         CreditCardManager() noexcept;
 
+        /**
+         * @brief Constructor
+         * @param dbManager The database the credit cards are stored in
+         **/
+        explicit CreditCardManager(DBManager& dbManager) noexcept;
+
+        /**
+         * @brief Constructor
+         * @param store The store the credit cards are kept in
+         **/
+        explicit CreditCardManager(LedgerStore& store) noexcept;
+
         /**
          * @brief Default destructor
          **/
@@ -58,8 +74,8 @@ class CreditCardManager
          **/
         bool GetCreditCardInfo(const std::string& cardNumber,
                                std::string&       cardName,
-                               double_t&          maxDebt,
-                               double_t&          totalPendingDebt,
+                               Money&             maxDebt,
+                               Money&             totalPendingDebt,
                                uint16_t&          billingDueDay) const noexcept;
 
         /**
@@ -72,7 +88,7 @@ class CreditCardManager
         bool AddCreditCard(const std::string& cardNumber,
                            const uint16_t     billingDueDay,
                            const std::string& cardName,
-                           const double_t     maxDebt) noexcept;
+                           const Money        maxDebt) noexcept;
 
         /**
          * @brief Add a new expense to the credit card
@@ -81,12 +97,13 @@ class CreditCardManager
          * @param date The date of the expense
          * @param totalAmount The total amount of the expense
          * @param description The description of the expense
-         * @param installments The number of installments of the expense
+         * @param installments The number of installments of the expense. The
+         *        installments differ by at most one cent and add up to the total
          **/
         bool AddDebt(const std::string& cardNumber,
                      const std::string& category,
                      const std::string& date,
-                     const double_t     totalAmount,
+                     const Money        totalAmount,
                      const std::string& description,
                      const uint16_t     installments) noexcept;
 
@@ -104,7 +121,7 @@ class CreditCardManager
         bool GetLastExpense(const std::string& cardNumber,
                             std::string&       category,
                             std::string&       date,
-                            double_t&          totalAmount,
+                            Money&             totalAmount,
                             std::string&       description,
                             uint16_t&          installments,
                             uint32_t&          debtId) const noexcept;
@@ -122,32 +139,38 @@ class CreditCardManager
          * @param cardNumber The credit card number
          * @throw std::runtime_error if the credit card does not exist
          **/
-        double_t GetMaxDebt(const std::string& cardNumber) const;
+        Money GetMaxDebt(const std::string& cardNumber) const;
 
         /**
          * @brief Get the total pending debt of a credit card
          * @param cardNumber The credit card number
          * @throw std::runtime_error if the credit card does not exist
          **/
-        double_t GetTotalPendingDebt(const std::string& cardNumber) const;
+        Money GetTotalPendingDebt(const std::string& cardNumber) const;
 
         /**
          * @brief Check if a credit card has enough credit to make a purchase
          * @param cardNumber The credit card number
          * @throw std::runtime_error if the credit card does not exist
          **/
-        bool HasEnoughCredit(const std::string& cardNumber,
-                             const double_t     expense) const;
+        bool HasEnoughCredit(const std::string& cardNumber, const Money expense) const;
 
         /**
-         * @brief Generate the due date of a installment
+         * @brief Get the day of the month the bill of a credit card is due
          * @param cardNumber The credit card number
+         * @return The billing due day
+         * @throw std::invalid_argument if the credit card does not exist
+         **/
+        uint16_t GetBillingDueDay(const std::string& cardNumber) const;
+
+        /**
+         * @brief Generate the due date of a installment
+         * @param billingDueDay The day of the month the bill is due
          * @param purchaseDate The date of the purchase
          * @param installmentNumber The number of the installment
          * @return The due date of the installment
-         * @throw std::runtime_error if the credit card does not exist
          **/
-        std::string GetInstallmentDueDate(const std::string& cardNumber,
+        std::string GetInstallmentDueDate(const uint16_t     billingDueDay,
                                           const std::string& purchaseDate,
                                           uint16_t           installmentNumber) const;
 };
@@ -10,29 +10,303 @@
 #ifndef DB_MANAGER_H_
 #define DB_MANAGER_H_
 
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <sqlite3.h>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "async_writer.h"
+#include "config.h"
+#include "connection_pool.h"
 #include "log_manager.h"
+#include "money.h"
+#include "query_profiler.h"
+#include "row_decoder.h"
+#include "sql_queries.h"
+#include "statement_cache.h"
 
 /**
  * @brief Class responsible for managing the database
+ *
+ * Commands run on a single writer connection. Queries run on read-only connections
+ * from a pool, so they can run concurrently with each other and with the writer.
+ * A thread that holds an open transaction keeps its queries on the writer, so it
+ * sees its own uncommitted changes.
  **/
 class DBManager
 {
+    public:
+        /**
+         * @brief RAII scope of a database transaction
+         *
+         * The outermost scope runs BEGIN IMMEDIATE, so the write lock is taken up
+         * front and the checks done inside the scope stay valid until the commit.
+         * Nested scopes use savepoints, so an inner failure can be rolled back
+         * without discarding the work of the outer scope. A scope that is destroyed
+         * without being committed is rolled back.
+         *
+         * The writer connection is locked for the whole scope, so commands issued
+         * by other threads wait until the transaction ends.
+         **/
+        class Transaction
+        {
+            private:
+                DBManager&                             m_dbManager;
+                std::unique_lock<std::recursive_mutex> m_writerLock;
+                std::string                            m_savepoint;
+                bool                                   m_active;
+
+            public:
+                /**
+                 * @brief Begin a transaction, or a savepoint if a transaction is
+                 *        already open
+                 * @param db The database manager
+                 * NOTE: Check IsActive() to know if the transaction was started
+                 **/
+                explicit Transaction(DBManager& db) noexcept;
+
+                /**
+                 * @brief Roll back the transaction if it was not committed
+                 **/
+                ~Transaction() noexcept;
+
+                Transaction(const Transaction&)            = delete;
+                Transaction& operator=(const Transaction&) = delete;
+
+                /**
+                 * @brief Commit the transaction, or release the savepoint
+                 * @return bool True if the changes were committed
+                 **/
+                bool Commit() noexcept;
+
+                /**
+                 * @brief Roll back the transaction, or roll back to the savepoint
+                 **/
+                void Rollback() noexcept;
+
+                /**
+                 * @brief Check if the transaction is open
+                 * @return bool True if the transaction was started and was not
+                 *         committed or rolled back yet
+                 **/
+                bool IsActive() const noexcept;
+
+            private:
+                /**
+                 * @brief Close the scope and release the writer connection
+                 **/
+                void End() noexcept;
+        };
+
+        /**
+         * @brief Time spent in each phase of the constructor
+         **/
+        struct StartupReport
+        {
+                std::chrono::nanoseconds directory{ 0 };
+                std::chrono::nanoseconds open{ 0 };
+                std::chrono::nanoseconds profile{ 0 };
+                std::chrono::nanoseconds schema{ 0 };
+
+                // True if the stored schema fingerprint matched and no DDL ran
+                bool schemaUpToDate = false;
+
+                /**
+                 * @brief Get the time spent in all the phases
+                 **/
+                std::chrono::nanoseconds Total() const noexcept;
+        };
+
     private:
-        sqlite3*    m_db;
-        LogManager& m_logger;
+        /**
+         * @brief Connection a statement should run on
+         **/
+        enum class Route
+        {
+            Writer,
+            Reader
+        };
 
         /**
-         * @brief Default constructor
+         * @brief Prepared statement together with the connection it was
+         *        checked out from
+         *
+         * Holds either the writer lock or a reader lease. The statement lease is
+         * declared last so it goes back to the cache before the connection is
+         * released.
          **/
-        DBManager();
+        struct StatementHandle
+        {
+                std::unique_lock<std::recursive_mutex> writerLock;
+                ConnectionPool::ReaderLease            reader;
+                StatementCache::Lease                  stmt;
+
+                StatementHandle() noexcept                  = default;
+                StatementHandle(StatementHandle&&) noexcept = default;
+
+                /**
+                 * @brief Release the held statement and connection in the reverse
+                 *        order of the members, as the destructor does
+                 **/
+                StatementHandle& operator=(StatementHandle&& other) noexcept
+                {
+                    this->stmt       = std::move(other.stmt);
+                    this->reader     = std::move(other.reader);
+                    this->writerLock = std::move(other.writerLock);
+                    return *this;
+                }
+
+                sqlite3_stmt* Get() const noexcept
+                {
+                    return this->stmt.Get();
+                }
+
+                explicit operator bool() const noexcept
+                {
+                    return static_cast<bool>(this->stmt);
+                }
+        };
+
+        LogManager&                                m_logger;
+        SlowQueryLog                               m_slowQueryLog;
+        QueryProfiler                              m_profiler;
+        mutable ConnectionPool                     m_pool;
+        std::atomic<std::thread::id>               m_transactionOwner;
+        uint32_t                                   m_transactionDepth;
+
+        std::atomic<uint64_t>                      m_restoreCount;
+        std::atomic<const config::StorageProfile*> m_storageProfile;
+        std::once_flag                             m_asyncWriterOnce;
+        std::unique_ptr<AsyncWriter>               m_asyncWriter;
+
+        // Actions waiting for the outermost commit, with the depth they belong to
+        std::vector<std::pair<uint32_t, std::function<void()>>> m_commitActions;
+
+        // Backups running on background threads, waited for on destruction
+        std::mutex              m_backupMutex;
+        std::condition_variable m_backupFinished;
+        uint32_t                m_activeBackups;
+        std::atomic<bool>       m_closing;
+
+        StartupReport m_startupReport;
 
     public:
         /**
-         * @brief Get the singleton instance of the class
+         * @brief Lazy input range over the rows of a query
+         *
+         * Each increment steps the statement once, so rows are decoded one at a
+         * time and memory use does not grow with the size of the result. Stopping
+         * the iteration early leaves the remaining rows unread.
+         *
+         * The cursor keeps its connection checked out until it is destroyed or the
+         * last row is read. A cursor on the writer connection blocks the writes of
+         * other threads meanwhile, so cursors should be short-lived.
+         **/
+        template<typename Row>
+        class Cursor
+        {
+            public:
+                /**
+                 * @brief Iterator over the rows. Dereferencing decodes the current
+                 *        row, so borrowed columns are valid until the next increment
+                 **/
+                class Iterator
+                {
+                    private:
+                        Cursor* m_cursor;
+
+                    public:
+                        using value_type      = Row;
+                        using difference_type = std::ptrdiff_t;
+
+                        Iterator() noexcept;
+                        explicit Iterator(Cursor* cursor) noexcept;
+
+                        Row       operator*() const;
+                        Iterator& operator++();
+                        void      operator++(int);
+
+                        bool operator==(std::default_sentinel_t) const noexcept;
+                };
+
+            private:
+                const DBManager* m_dbManager;
+                StatementHandle  m_stmt;
+                bool             m_started;
+                bool             m_done;
+                bool             m_failed;
+
+                friend class DBManager;
+
+                Cursor(const DBManager* dbManager, StatementHandle&& stmt) noexcept;
+
+                /**
+                 * @brief Step to the next row, releasing the statement after the
+                 *        last one
+                 **/
+                void Step() noexcept;
+
+            public:
+                Cursor(Cursor&&) noexcept            = default;
+                Cursor& operator=(Cursor&&) noexcept = default;
+
+                Cursor(const Cursor&)            = delete;
+                Cursor& operator=(const Cursor&) = delete;
+
+                /**
+                 * @brief Get an iterator to the first row
+                 * NOTE: A cursor can only be iterated once
+                 **/
+                Iterator begin();
+
+                std::default_sentinel_t end() const noexcept;
+
+                /**
+                 * @brief Check if preparing, binding or stepping the query failed
+                 **/
+                bool HasFailed() const noexcept;
+        };
+
+        /**
+         * @brief Open a database and create its schema
+         *
+         * The open spec is a file path, ":memory:" for a private in-memory
+         * database, or a SQLite URI such as
+         * "file:name?mode=memory&cache=shared". Each DBManager owns its
+         * connections, so managers built on different instances never share data.
+         *
+         * @param openSpec Where the database is
+         * @throw std::runtime_error If the schema cannot be created
+         **/
+        explicit DBManager(const std::string& openSpec);
+
+        DBManager(const DBManager&)            = delete;
+        DBManager& operator=(const DBManager&) = delete;
+
+        /**
+         * @brief Get the instance shared by the application
+         *
+         * It opens the database named by the environment variable
+         * config::DATABASE_ENV, or config::DATABASE_FULL_PATH if it is not set.
+         *
          * @return DBManager& Singleton instance of the class
          **/
         static DBManager& GetInstance() noexcept;
@@ -51,12 +325,324 @@ class DBManager
 
         /**
          * @brief Execute a SQL command and return the result
+         *
+         * Read-only commands run on a reader connection when one is available.
+         *
          * @param query SQL command to be executed
-         * @param callback Function to be called with the result of the query
-         * @return bool SQLITE_OK if the command was executed successfully
+         * @param callback Function to be called with the statement positioned on
+         *        each row of the result
+         * @return bool True if the command was executed successfully and at least
+         *         one row was fetched
+         **/
+        template<typename RowFn>
+        bool ExecuteQueryWithResult(const std::string& query, RowFn&& callback) const;
+
+        /**
+         * @brief Execute a SQL command binding the given parameters
+         *
+         * Parameters are bound in order to the '?' placeholders of the command.
+         * Supported types are strings, integers, floating point numbers, nullptr,
+         * std::nullopt and std::optional of any of those.
+         *
+         * @param query SQL command with '?' placeholders
+         * @param args Values bound to the placeholders
+         * @return bool True if the command was executed successfully
+         **/
+        template<typename... Args>
+        bool Execute(std::string_view query, const Args&... args) noexcept;
+
+        /**
+         * @brief Execute a SQL command whose parameters are bound by the caller
+         *
+         * Meant for commands with a number of placeholders only known at runtime,
+         * such as multi-row inserts. The statement is cached like any other.
+         *
+         * @param query SQL command with '?' placeholders
+         * @param bind Function that binds the parameters with sqlite3_bind_* and
+         *        returns false if any binding failed. Bindings are cleared when
+         *        the statement goes back to the cache, so SQLITE_STATIC may be used
+         * @return bool True if the command was executed successfully
+         **/
+        template<typename BindFn>
+        bool ExecuteBound(std::string_view query, BindFn&& bind) noexcept;
+
+        /**
+         * @brief Execute a SQL query binding the given parameters and call a
+         *        function for each row of the result
+         *
+         * The last argument is the row function, called with the statement
+         * positioned on the current row. All the other arguments are bound in order
+         * to the '?' placeholders of the query, as in Execute.
+         *
+         * @param query SQL query with '?' placeholders
+         * @param argsAndRowFn Values bound to the placeholders followed by the row
+         *        function
+         * @return bool True if the query was executed successfully and at least one
+         *         row was fetched
+         **/
+        template<typename... Args>
+        bool Query(std::string_view query, Args&&... argsAndRowFn);
+
+        /**
+         * @brief Execute a SQL query as Query does, where a result with no rows
+         *        is not a failure
+         * @param query SQL query with '?' placeholders
+         * @param argsAndRowFn Values bound to the placeholders followed by the row
+         *        function
+         * @return bool True if the query was prepared and stepped to the end
+         **/
+        template<typename... Args>
+        bool QueryAll(std::string_view query, Args&&... argsAndRowFn);
+
+        /**
+         * @brief Execute a SQL query binding the given parameters and decode every
+         *        row of the result into a Row
+         *
+         * Row is a std::tuple with one element per column, a struct that declares
+         * its column types (see MappedRow) or a single column type. Rows are
+         * returned by value, so they cannot borrow text from the statement. Use
+         * ForEach to read std::string_view columns without copies.
+         *
+         * @param query SQL query with '?' placeholders
+         * @param args Values bound to the placeholders
+         * @return std::vector<Row> The decoded rows. Empty if the query failed or
+         *         returned no rows
+         **/
+        template<typename Row, typename... Args>
+        std::vector<Row> QueryAs(std::string_view query, const Args&... args);
+
+        /**
+         * @brief Execute a SQL query binding the given parameters and decode the
+         *        first row of the result into a Row
+         * @param query SQL query with '?' placeholders
+         * @param args Values bound to the placeholders
+         * @return std::optional<Row> The decoded row. Empty if the query failed or
+         *         returned no rows
+         **/
+        template<typename Row, typename... Args>
+        std::optional<Row> QueryOne(std::string_view query, const Args&... args);
+
+        /**
+         * @brief Execute a SQL query binding the given parameters and call a
+         *        function with each row of the result decoded into a Row
+         *
+         * The last argument is the row function, called with the decoded Row. Rows
+         * may hold std::string_view columns, which point into the statement and
+         * are only valid until the row function returns.
+         *
+         * @param query SQL query with '?' placeholders
+         * @param argsAndRowFn Values bound to the placeholders followed by the row
+         *        function
+         * @return bool True if the query was executed successfully and at least one
+         *         row was fetched
+         **/
+        template<typename Row, typename... Args>
+        bool ForEach(std::string_view query, Args&&... argsAndRowFn);
+
+        /**
+         * @brief Execute a SQL query binding the given parameters and return a lazy
+         *        range over its rows, e.g.
+         *
+         *        for (auto [name, balance] : db.Stream<WalletRow>(sql)) { ... }
+         *
+         * Text parameters are copied, so temporaries can be passed. Rows may hold
+         * std::string_view columns, valid until the cursor moves to the next row.
+         *
+         * @param query SQL query with '?' placeholders
+         * @param args Values bound to the placeholders
+         * @return Cursor<Row> The range of rows. Empty if the query failed
+         **/
+        template<typename Row, typename... Args>
+        Cursor<Row> Stream(std::string_view query, const Args&... args);
+
+        /**
+         * @brief Queue a write to run on the background writer thread
+         *
+         * Writes queued close together are committed in a single transaction.
+         * The writer thread is started on the first call.
+         *
+         * @param operation Function that writes through this manager. It returns
+         *        false, or throws, to have its changes rolled back
+         * @return std::future<bool> True once the changes are committed
+         **/
+        std::future<bool> Enqueue(std::function<bool()> operation) noexcept;
+
+        /**
+         * @brief Run an action once the writes done so far are committed
+         *
+         * Inside a transaction the action waits for the outermost transaction to
+         * commit, and runs before the writer connection is released, so actions
+         * run in commit order. It is dropped if the transaction or savepoint it
+         * was added in is rolled back. Outside a transaction it runs right away.
+         *
+         * @param action The action. It must not throw
+         **/
+        void AfterCommit(std::function<void()> action) noexcept;
+
+        /**
+         * @brief Wait until every write queued so far is committed
+         * @return bool False if called while holding a transaction, since the
+         *         writer thread could never take the writer connection
+         **/
+        bool Flush() noexcept;
+
+        /**
+         * @brief Get the counters of the background writer
+         **/
+        AsyncWriter::Stats GetAsyncWriterStats() const noexcept;
+
+        /**
+         * @brief Apply one of the storage profiles in config by its name
+         *
+         * The settings are applied to the writer right away, and to each reader
+         * before its next use. Readers are only enabled in WAL mode.
+         *
+         * @param name The name of the profile, e.g. "durable" or "bulk-load"
+         * @return bool True if the profile exists and all settings were applied
+         * NOTE: Profiles cannot be changed while a transaction is open
+         **/
+        bool SetStorageProfile(std::string_view name) noexcept;
+
+        /**
+         * @brief Get the storage profile in use
+         * @return const config::StorageProfile& The profile last applied, one of
+         *         config::STORAGE_PROFILES
+         **/
+        const config::StorageProfile& GetStorageProfile() const noexcept;
+
+        /**
+         * @brief Function called after each step of a backup
+         * @param remaining Pages still to be copied
+         * @param total Pages in the database
+         **/
+        using BackupProgress = std::function<void(int remaining, int total)>;
+
+        /**
+         * @brief Copy the database to a file while it stays in use
+         *
+         * The copy runs on a background thread, a few pages at a time. The writer
+         * connection is only held during each step, so writes of other threads run
+         * between steps and are included in the copy.
+         *
+         * @param destination Path or URI of the copy. It is overwritten
+         * @param pagesPerStep Pages copied in each step
+         * @param progress Called on the backup thread after each step
+         * @return std::future<bool> True once the copy is complete
+         * NOTE: Do not wait for the result while holding a transaction, since the
+         *       backup needs the writer connection to make progress
+         **/
+        std::future<bool>
+        Backup(const std::string& destination,
+               int                pagesPerStep = config::BACKUP_PAGES_PER_STEP,
+               BackupProgress     progress     = nullptr) noexcept;
+
+        /**
+         * @brief Replace the contents of the database with a copy made by Backup
+         *
+         * The copy is made in a single step, holding the writer connection. The
+         * missing tables are then created and the schema is migrated, so copies
+         * of older versions can be restored. The cached statements are dropped and
+         * GetRestoreCount changes, so caches of the data know to reload.
+         *
+         * @param source Path or URI of the copy
+         * @return bool True if the database was restored
+         * NOTE: Cannot be called inside a transaction
+         **/
+        bool Restore(const std::string& source) noexcept;
+
+        /**
+         * @brief Get the number of copies restored into the database. Data cached
+         *        under another count may be stale
+         **/
+        uint64_t GetRestoreCount() const noexcept;
+
+        /**
+         * @brief Get the latency and row counters of every statement template run
+         *        on the database, e.g. to find which queries dominate the runtime
+         * @return std::vector<QueryProfiler::Stats> Counters sorted by total time,
+         *         largest first
+         **/
+        std::vector<QueryProfiler::Stats> GetQueryStats() const;
+
+        /**
+         * @brief Discard the counters returned by GetQueryStats
+         **/
+        void ResetQueryStats() noexcept;
+
+        /**
+         * @brief Set the time above which a statement is written to the slow query
+         *        log, next to the main log
+         * @param threshold The threshold. Zero logs every statement
+         **/
+        void SetSlowQueryThreshold(std::chrono::nanoseconds threshold) noexcept;
+
+        /**
+         * @brief Get the number of entries written to the slow query log
+         **/
+        uint64_t GetSlowQueryCount() const noexcept;
+
+        /**
+         * @brief Get the query plan captured by the slow query log for a statement
+         * @param sql SQL text of the statement. The terminating semicolon is
+         *        optional
+         * @return std::string The plan, or an empty string if the statement was
+         *         never slow
+         **/
+        std::string GetSlowQueryPlan(std::string_view sql) noexcept;
+
+        /**
+         * @brief Get the version of the schema, stored in PRAGMA user_version
+         * @return uint32_t The version of the last migration applied
+         **/
+        uint32_t GetSchemaVersion() const noexcept;
+
+        /**
+         * @brief Get the fingerprint of the schema defined by query::TABLES and
+         *        query::MIGRATIONS
+         *
+         * It is stored in the database once the schema is set up. Startup skips the
+         * DDL and the migrations when the stored fingerprint matches, so a change
+         * to any table or migration makes the next startup apply them again.
+         *
+         * @return uint64_t FNV-1a hash of the table definitions and migrations
+         **/
+        static uint64_t GetSchemaFingerprint() noexcept;
+
+        /**
+         * @brief Get the time spent opening the database, by phase
+         **/
+        const StartupReport& GetStartupReport() const noexcept;
+
+        /**
+         * @brief Apply the migrations newer than the schema version
+         *
+         * Each migration runs in its own transaction, which also updates the schema
+         * version, so a failed migration leaves the schema as it was before it.
+         * Migrations already applied are skipped.
+         *
+         * @param migrations Migrations sorted by version
+         * @return bool True if the schema is up to date with the migrations
+         **/
+        bool Migrate(std::span<const query::Migration> migrations) noexcept;
+
+        /**
+         * @brief Get the rowid of the last row inserted by the writer connection
+         * NOTE: Call it inside the transaction that made the insert
+         * @return int64_t The rowid of the last inserted row
+         **/
+        int64_t LastInsertRowId() const noexcept;
+
+        /**
+         * @brief Get the counters of the prepared statement caches
+         * @return StatementCache::Stats Hits, misses, evictions and current size
+         *         summed over all connections
          **/
-        bool ExecuteQueryWithResult(const std::string&                 query,
-                                    std::function<void(sqlite3_stmt*)> callback) const;
+        StatementCache::Stats GetStatementCacheStats() const noexcept;
+
+        /**
+         * @brief Finalize the idle prepared statements held by the caches
+         **/
+        void ClearStatementCache() noexcept;
 
         /**
          * @brief Reset the database
@@ -70,5 +656,496 @@ class DBManager
          * @brief Create the tables in the database
          **/
         void CreateTables();
+
+        /**
+         * @brief Apply a storage profile to the connections
+         * @param profile One of config::STORAGE_PROFILES, which the manager keeps
+         *        pointing to
+         * @return bool True if all the settings were applied
+         **/
+        bool SetStorageProfile(const config::StorageProfile& profile) noexcept;
+
+        /**
+         * @brief Read the schema fingerprint stored in the database
+         * @return std::optional<uint64_t> The fingerprint, or nothing if the
+         *         database has none yet
+         **/
+        std::optional<uint64_t> ReadSchemaFingerprint() const noexcept;
+
+        /**
+         * @brief Get the background writer, starting it if needed
+         **/
+        AsyncWriter& GetAsyncWriter() noexcept;
+
+        /**
+         * @brief Body of a backup thread
+         * @return bool True if the copy is complete
+         **/
+        bool RunBackup(const std::string&    destination,
+                       int                   pagesPerStep,
+                       const BackupProgress& progress) noexcept;
+
+        /**
+         * @brief Check out the cached prepared statement for a query
+         *
+         * With Route::Reader the statement runs on a reader, unless the calling
+         * thread owns the open transaction, no reader is idle or the statement
+         * writes to the database. In those cases it runs on the writer.
+         *
+         * @param query SQL text of a single statement
+         * @param route Connection the statement should run on
+         * @return StatementHandle Empty handle if the query could not be prepared
+         **/
+        StatementHandle PrepareStatement(std::string_view query,
+                                         Route            route) const noexcept;
+
+        /**
+         * @brief Text parameter that SQLite must copy, for statements that outlive
+         *        the call that binds them
+         **/
+        struct CopiedText
+        {
+                std::string_view value;
+        };
+
+        /**
+         * @brief Bind values to the placeholders of a statement
+         * @return bool True if all values were bound
+         **/
+        template<typename... Args>
+        bool BindParameters(sqlite3_stmt* stmt, const Args&... args) const noexcept;
+
+        /**
+         * @brief Wrap text parameters into CopiedText. Other values are returned
+         *        unchanged
+         **/
+        template<typename T>
+        static decltype(auto) CopyText(const T& value) noexcept;
+
+        /**
+         * @brief Bind functions for the supported parameter types
+         * @return int SQLite result code
+         **/
+        static int BindParameter(sqlite3_stmt* stmt,
+                                 int           index,
+                                 std::nullptr_t) noexcept;
+        static int BindParameter(sqlite3_stmt* stmt,
+                                 int           index,
+                                 std::nullopt_t) noexcept;
+        static int BindParameter(sqlite3_stmt* stmt, int index, double value) noexcept;
+        static int BindParameter(sqlite3_stmt* stmt, int index, Money value) noexcept;
+        static int BindParameter(sqlite3_stmt*    stmt,
+                                 int              index,
+                                 std::string_view value) noexcept;
+        static int BindParameter(sqlite3_stmt* stmt,
+                                 int           index,
+                                 CopiedText    value) noexcept;
+
+        template<std::integral T>
+        static int BindParameter(sqlite3_stmt* stmt, int index, T value) noexcept;
+
+        template<typename T>
+        static int BindParameter(sqlite3_stmt*           stmt,
+                                 int                     index,
+                                 const std::optional<T>& value) noexcept;
+
+        /**
+         * @brief Step a statement until it is done, calling a function for each row
+         * @param allowEmpty If false, a result with no rows is a failure
+         * @return bool True if no error happened and at least one row was fetched,
+         *         unless allowEmpty is set
+         **/
+        template<typename RowFn>
+        bool StepRows(sqlite3_stmt* stmt, RowFn& rowFn, bool allowEmpty = false) const;
+
+        /**
+         * @brief Bind the first elements of a tuple of arguments and step the query
+         *        calling the row function
+         **/
+        template<typename Tuple, typename RowFn, std::size_t... I>
+        bool QueryImpl(std::string_view query,
+                       Tuple&           args,
+                       RowFn&           rowFn,
+                       std::index_sequence<I...>,
+                       bool allowEmpty = false);
+
+        /**
+         * @brief Log the last error of a connection
+         * @param db The connection
+         * @param context Description of the failed operation
+         **/
+        void LogError(sqlite3* db, const std::string& context) const noexcept;
 };
+
+template<typename... Args>
+bool DBManager::Execute(std::string_view query, const Args&... args) noexcept
+{
+    StatementHandle stmt = this->PrepareStatement(query, Route::Writer);
+
+    if (not stmt or not this->BindParameters(stmt.Get(), args...))
+    {
+        return false;
+    }
+
+    int rc;
+    do
+    {
+        rc = sqlite3_step(stmt.Get());
+    } while (rc == SQLITE_ROW);
+
+    if (rc != SQLITE_DONE)
+    {
+        this->LogError(sqlite3_db_handle(stmt.Get()), "SQL error on step");
+        return false;
+    }
+
+    return true;
+}
+
+template<typename BindFn>
+bool DBManager::ExecuteBound(std::string_view query, BindFn&& bind) noexcept
+{
+    StatementHandle stmt = this->PrepareStatement(query, Route::Writer);
+
+    if (not stmt)
+    {
+        return false;
+    }
+
+    if (not bind(stmt.Get()))
+    {
+        this->LogError(sqlite3_db_handle(stmt.Get()), "Error binding parameters");
+        return false;
+    }
+
+    int rc;
+    do
+    {
+        rc = sqlite3_step(stmt.Get());
+    } while (rc == SQLITE_ROW);
+
+    if (rc != SQLITE_DONE)
+    {
+        this->LogError(sqlite3_db_handle(stmt.Get()), "SQL error on step");
+        return false;
+    }
+
+    return true;
+}
+
+template<typename RowFn>
+bool DBManager::ExecuteQueryWithResult(const std::string& query,
+                                       RowFn&&            callback) const
+{
+    StatementHandle stmt = this->PrepareStatement(query, Route::Reader);
+
+    if (not stmt)
+    {
+        return false;
+    }
+
+    return this->StepRows(stmt.Get(), callback);
+}
+
+template<typename... Args>
+bool DBManager::Query(std::string_view query, Args&&... argsAndRowFn)
+{
+    static_assert(sizeof...(Args) >= 1, "Query requires a row function");
+
+    auto args = std::forward_as_tuple(std::forward<Args>(argsAndRowFn)...);
+
+    return this->QueryImpl(query,
+                           args,
+                           std::get<sizeof...(Args) - 1>(args),
+                           std::make_index_sequence<sizeof...(Args) - 1>());
+}
+
+template<typename... Args>
+bool DBManager::QueryAll(std::string_view query, Args&&... argsAndRowFn)
+{
+    static_assert(sizeof...(Args) >= 1, "QueryAll requires a row function");
+
+    auto args = std::forward_as_tuple(std::forward<Args>(argsAndRowFn)...);
+
+    return this->QueryImpl(query,
+                           args,
+                           std::get<sizeof...(Args) - 1>(args),
+                           std::make_index_sequence<sizeof...(Args) - 1>(),
+                           true);
+}
+
+template<typename Row, typename... Args>
+std::vector<Row> DBManager::QueryAs(std::string_view query, const Args&... args)
+{
+    static_assert(not BorrowedRow<Row>,
+                  "Rows returned by value cannot borrow columns, use ForEach");
+
+    std::vector<Row> rows;
+
+    auto params = std::forward_as_tuple(args...);
+    auto decode = [&rows](sqlite3_stmt* stmt) {
+        rows.push_back(RowDecoder<Row>::Decode(stmt));
+    };
+
+    this->QueryImpl(query, params, decode, std::index_sequence_for<Args...>());
+
+    return rows;
+}
+
+template<typename Row, typename... Args>
+std::optional<Row> DBManager::QueryOne(std::string_view query, const Args&... args)
+{
+    static_assert(not BorrowedRow<Row>,
+                  "Rows returned by value cannot borrow columns, use ForEach");
+
+    std::optional<Row> row;
+
+    auto params = std::forward_as_tuple(args...);
+    auto decode = [&row](sqlite3_stmt* stmt) {
+        if (not row)
+        {
+            row.emplace(RowDecoder<Row>::Decode(stmt));
+        }
+    };
+
+    this->QueryImpl(query, params, decode, std::index_sequence_for<Args...>());
+
+    return row;
+}
+
+template<typename Row, typename... Args>
+bool DBManager::ForEach(std::string_view query, Args&&... argsAndRowFn)
+{
+    static_assert(sizeof...(Args) >= 1, "ForEach requires a row function");
+
+    auto  args   = std::forward_as_tuple(std::forward<Args>(argsAndRowFn)...);
+    auto& rowFn  = std::get<sizeof...(Args) - 1>(args);
+    auto  decode = [&rowFn](sqlite3_stmt* stmt) {
+        rowFn(RowDecoder<Row>::Decode(stmt));
+    };
+
+    return this->QueryImpl(query,
+                           args,
+                           decode,
+                           std::make_index_sequence<sizeof...(Args) - 1>());
+}
+
+template<typename Row, typename... Args>
+DBManager::Cursor<Row> DBManager::Stream(std::string_view query, const Args&... args)
+{
+    StatementHandle stmt = this->PrepareStatement(query, Route::Reader);
+
+    if (stmt and not this->BindParameters(stmt.Get(), CopyText(args)...))
+    {
+        stmt = StatementHandle();
+    }
+
+    return Cursor<Row>(this, std::move(stmt));
+}
+
+template<typename Row>
+DBManager::Cursor<Row>::Cursor(const DBManager* dbManager,
+                               StatementHandle&& stmt) noexcept
+    : m_dbManager(dbManager),
+      m_stmt(std::move(stmt)),
+      m_started(false),
+      m_done(not m_stmt),
+      m_failed(not m_stmt)
+{ }
+
+template<typename Row>
+typename DBManager::Cursor<Row>::Iterator DBManager::Cursor<Row>::begin()
+{
+    if (not this->m_started)
+    {
+        this->m_started = true;
+
+        if (not this->m_done)
+        {
+            this->Step();
+        }
+    }
+
+    return Iterator(this);
+}
+
+template<typename Row>
+std::default_sentinel_t DBManager::Cursor<Row>::end() const noexcept
+{
+    return std::default_sentinel;
+}
+
+template<typename Row>
+bool DBManager::Cursor<Row>::HasFailed() const noexcept
+{
+    return this->m_failed;
+}
+
+template<typename Row>
+void DBManager::Cursor<Row>::Step() noexcept
+{
+    int rc = sqlite3_step(this->m_stmt.Get());
+
+    if (rc == SQLITE_ROW)
+    {
+        return;
+    }
+
+    if (rc != SQLITE_DONE)
+    {
+        this->m_failed = true;
+        this->m_dbManager->LogError(sqlite3_db_handle(this->m_stmt.Get()),
+                                    "SQL error on step");
+    }
+
+    // Give the connection back as soon as the result is exhausted
+    this->m_done = true;
+    this->m_stmt = StatementHandle();
+}
+
+template<typename Row>
+DBManager::Cursor<Row>::Iterator::Iterator() noexcept
+    : m_cursor(nullptr)
+{ }
+
+template<typename Row>
+DBManager::Cursor<Row>::Iterator::Iterator(Cursor* cursor) noexcept
+    : m_cursor(cursor)
+{ }
+
+template<typename Row>
+Row DBManager::Cursor<Row>::Iterator::operator*() const
+{
+    return RowDecoder<Row>::Decode(this->m_cursor->m_stmt.Get());
+}
+
+template<typename Row>
+typename DBManager::Cursor<Row>::Iterator&
+DBManager::Cursor<Row>::Iterator::operator++()
+{
+    this->m_cursor->Step();
+    return *this;
+}
+
+template<typename Row>
+void DBManager::Cursor<Row>::Iterator::operator++(int)
+{
+    this->m_cursor->Step();
+}
+
+template<typename Row>
+bool DBManager::Cursor<Row>::Iterator::operator==(
+    std::default_sentinel_t) const noexcept
+{
+    return not this->m_cursor or this->m_cursor->m_done;
+}
+
+template<typename Tuple, typename RowFn, std::size_t... I>
+bool DBManager::QueryImpl(std::string_view query,
+                          Tuple&           args,
+                          RowFn&           rowFn,
+                          std::index_sequence<I...>,
+                          bool allowEmpty)
+{
+    StatementHandle stmt = this->PrepareStatement(query, Route::Reader);
+
+    if (not stmt or not this->BindParameters(stmt.Get(), std::get<I>(args)...))
+    {
+        return false;
+    }
+
+    return this->StepRows(stmt.Get(), rowFn, allowEmpty);
+}
+
+template<typename... Args>
+bool DBManager::BindParameters(sqlite3_stmt* stmt, const Args&... args) const noexcept
+{
+    if (sqlite3_bind_parameter_count(stmt) != static_cast<int>(sizeof...(Args)))
+    {
+        this->m_logger.Log("Wrong number of parameters for query: " +
+                               std::string(sqlite3_sql(stmt)),
+                           spdlog::level::err);
+        return false;
+    }
+
+    int index = 0;
+    int rc    = SQLITE_OK;
+
+    ((rc = (rc == SQLITE_OK ? BindParameter(stmt, ++index, args) : rc)), ...);
+
+    if (rc != SQLITE_OK)
+    {
+        this->LogError(sqlite3_db_handle(stmt), "SQL error on bind");
+        return false;
+    }
+
+    return true;
+}
+
+template<typename T>
+decltype(auto) DBManager::CopyText(const T& value) noexcept
+{
+    if constexpr (std::is_convertible_v<const T&, std::string_view>)
+    {
+        return CopiedText{ std::string_view(value) };
+    }
+    else if constexpr (requires { typename T::value_type; } and
+                       std::is_same_v<T, std::optional<typename T::value_type>>)
+    {
+        using Copied = decltype(CopyText(std::declval<typename T::value_type>()));
+
+        return value ? std::optional<std::decay_t<Copied>>(CopyText(*value))
+                     : std::optional<std::decay_t<Copied>>();
+    }
+    else
+    {
+        return (value);
+    }
+}
+
+template<std::integral T>
+int DBManager::BindParameter(sqlite3_stmt* stmt, int index, T value) noexcept
+{
+    return sqlite3_bind_int64(stmt, index, static_cast<sqlite3_int64>(value));
+}
+
+template<typename T>
+int DBManager::BindParameter(sqlite3_stmt*           stmt,
+                             int                     index,
+                             const std::optional<T>& value) noexcept
+{
+    if (not value)
+    {
+        return sqlite3_bind_null(stmt, index);
+    }
+
+    return BindParameter(stmt, index, *value);
+}
+
+template<typename RowFn>
+bool DBManager::StepRows(sqlite3_stmt* stmt, RowFn& rowFn, bool allowEmpty) const
+{
+    int  rc;
+    bool rowFetched = false;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        rowFetched = true;
+        rowFn(stmt);
+    }
+
+    if (rc != SQLITE_DONE)
+    {
+        this->LogError(sqlite3_db_handle(stmt), "SQL error on step");
+        return false;
+    }
+
+    if (not rowFetched and not allowEmpty)
+    {
+        this->m_logger.Log("No rows fetched by query", spdlog::level::debug);
+        return false;
+    }
+
+    return true;
+}
+
 #endif // DB_MANAGER_H_
@@ -13,12 +13,16 @@
 #    define TEST_ENVIRONMENT true
 #endif
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <ctime>
 #include <filesystem>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <string>
+#include <string_view>
 
 /**
  * @brief Configuration of the project.
@@ -34,6 +38,9 @@ namespace config
     const std::string LOG_FILE      = "mfn.log";
     const std::string LOG_FULL_PATH = LOG_PATH + LOG_FILE;
 
+    const std::string SLOW_QUERY_LOG_FILE      = "mfn_slow_queries.log";
+    const std::string SLOW_QUERY_LOG_FULL_PATH = LOG_PATH + SLOW_QUERY_LOG_FILE;
+
     // Database configuration
     const std::string DATABASE_PATH      = "/tmp/mfn/";
     const std::string DATABASE_FILE      = "mfn_test.db";
@@ -44,12 +51,137 @@ namespace config
     const std::string LOG_FILE      = "mfn.log";
     const std::string LOG_FULL_PATH = LOG_PATH + LOG_FILE;
 
+    const std::string SLOW_QUERY_LOG_FILE      = "mfn_slow_queries.log";
+    const std::string SLOW_QUERY_LOG_FULL_PATH = LOG_PATH + SLOW_QUERY_LOG_FILE;
+
     // Database configuration
     const std::string DATABASE_PATH      = HOME_PATH + ".config/mfn/";
     const std::string DATABASE_FILE      = "mfn.db";
     const std::string DATABASE_FULL_PATH = DATABASE_PATH + DATABASE_FILE;
 #endif
 
+    // The database opened by the application can be overridden at runtime by
+    // setting the environment variable below to a file path, ":memory:" or a
+    // SQLite URI
+    constexpr const char* DATABASE_ENV       = "MFN_DATABASE";
+    constexpr const char* IN_MEMORY_DATABASE = ":memory:";
+
+    // Maximum number of idle prepared statements kept by each connection
+    constexpr std::size_t STATEMENT_CACHE_CAPACITY = 64;
+
+    // Maximum number of read-only connections used to run queries concurrently.
+    // Readers are only used when the database is in WAL mode
+    constexpr std::size_t READER_CONNECTIONS = 4;
+
+    // Asynchronous writes that arrive within this window after the first one are
+    // committed together in a single transaction
+    constexpr std::chrono::microseconds GROUP_COMMIT_WINDOW{ 2000 };
+
+    // Maximum number of asynchronous writes committed in a single transaction
+    constexpr std::size_t GROUP_COMMIT_MAX_OPERATIONS = 512;
+
+    // Online backups copy this many pages at a time, pausing between steps so the
+    // writes of the application are not stalled
+    constexpr int                       BACKUP_PAGES_PER_STEP = 256;
+    constexpr std::chrono::milliseconds BACKUP_STEP_PAUSE{ 5 };
+
+    // Bulk imports parse the input in chunks of this many rows, while the previous
+    // chunks are inserted with multi-row inserts of IMPORT_ROWS_PER_INSERT rows
+    constexpr std::size_t IMPORT_CHUNK_ROWS      = 4096;
+    constexpr std::size_t IMPORT_QUEUED_CHUNKS   = 4;
+    constexpr std::size_t IMPORT_ROWS_PER_INSERT = 128;
+
+    // Category of imported rows that name none
+    constexpr const char* IMPORT_DEFAULT_CATEGORY = "Imported";
+
+    // Batches recorded by WalletManager::RecordBatch are inserted with multi-row
+    // inserts of this many rows
+    constexpr std::size_t BATCH_ROWS_PER_INSERT = 128;
+
+    // Balance reconciliations split the wallets among this many threads, each
+    // reading on its own reader connection
+    constexpr std::size_t RECONCILER_THREADS = READER_CONNECTIONS;
+
+    // Wallets kept in the append-only ledger checkpoint their balance every this
+    // many entries, so reading a balance sums fewer entries than this
+    constexpr uint32_t LEDGER_CHECKPOINT_INTERVAL = 64;
+
+    // Exports are written in whole buffers of EXPORT_BUFFER_SIZE bytes, aligned to
+    // EXPORT_BUFFER_ALIGNMENT so the output could be opened with O_DIRECT. The
+    // columnar format encodes EXPORT_ROW_GROUP_ROWS rows at a time
+    constexpr std::size_t EXPORT_BUFFER_SIZE      = 1 << 20;
+    constexpr std::size_t EXPORT_BUFFER_ALIGNMENT = 4096;
+    constexpr std::size_t EXPORT_ROW_GROUP_ROWS   = 65536;
+
+    // Statements that take longer than this are written to the slow query log
+    constexpr std::chrono::milliseconds SLOW_QUERY_THRESHOLD{ 50 };
+
+    /**
+     * @brief Storage engine settings applied to the database connection.
+     *
+     * Values follow the SQLite pragmas of the same name: a negative cacheSize is a
+     * size in KiB, a positive one is a number of pages. pageSize only takes effect
+     * on a database that has no tables yet.
+     **/
+    struct StorageProfile
+    {
+            const char* name;
+            const char* journalMode;
+            const char* synchronous;
+            int64_t     mmapSize;
+            int64_t     cacheSize;
+            const char* tempStore;
+            uint32_t    pageSize;
+            uint32_t    busyTimeoutMs;
+    };
+
+    // Every commit is synced to disk before it returns
+    constexpr StorageProfile STORAGE_PROFILE_DURABLE = { "durable",
+                                                         "WAL",
+                                                         "FULL",
+                                                         0,
+                                                         -8192,
+                                                         "DEFAULT",
+                                                         4096,
+                                                         5000 };
+
+    // A power loss may lose the last commits, but never corrupts the database
+    constexpr StorageProfile STORAGE_PROFILE_BALANCED = { "balanced",
+                                                          "WAL",
+                                                          "NORMAL",
+                                                          256LL << 20,
+                                                          -16384,
+                                                          "MEMORY",
+                                                          4096,
+                                                          5000 };
+
+    // No syncs at all. Meant for imports that can be rerun from the source files
+    constexpr StorageProfile STORAGE_PROFILE_BULK_LOAD = { "bulk-load",
+                                                           "WAL",
+                                                           "OFF",
+                                                           1LL << 30,
+                                                           -65536,
+                                                           "MEMORY",
+                                                           4096,
+                                                           30000 };
+
+    constexpr StorageProfile STORAGE_PROFILES[] = { STORAGE_PROFILE_DURABLE,
+                                                    STORAGE_PROFILE_BALANCED,
+                                                    STORAGE_PROFILE_BULK_LOAD };
+
+    // Profile used when the database is opened. It can be overridden at runtime
+    // by setting the environment variable below to the name of another profile
+    constexpr const char* DEFAULT_STORAGE_PROFILE = "balanced";
+    constexpr const char* STORAGE_PROFILE_ENV     = "MFN_STORAGE_PROFILE";
+
+    /**
+     * @brief Find a storage profile by its name
+     * @param name The name of the profile
+     * @return Pointer to the profile, or nullptr if there is no profile with the
+     *         given name
+     **/
+    const StorageProfile* FindStorageProfile(std::string_view name) noexcept;
+
     constexpr uint64_t WORLD_GDP = 10e13; // 100 trillion dollars
 
     constexpr uint16_t MIN_BILLING_DAY = 1;
@@ -7,13 +7,19 @@
 #ifndef SQL_QUERIES_H_
 #define SQL_QUERIES_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 /**
  * @brief Namespace that contains the queries to be executed in the database
  **/
 namespace query
 {
+    // Tables as they were first released. MIGRATION_MONEY_CENTS turns the REAL
+    // amounts and balances into INTEGER cents, and the opening_balance column is
+    // added by MIGRATION_WALLET_OPENING_BALANCES
     const std::string CREATE_TABLE_WALLET = "CREATE TABLE IF NOT EXISTS Wallet ("
                                             "name CHAR(50) PRIMARY KEY,"
                                             "balance REAL NOT NULL"
@@ -83,6 +89,94 @@ namespace query
         "FOREIGN KEY (debt_id) REFERENCES CreditCardDebt(debt_id)"
         ");";
 
+    // Net change and closing balance of a wallet on each day it moved
+    const std::string CREATE_TABLE_WALLET_DAILY_BALANCE =
+        "CREATE TABLE IF NOT EXISTS WalletDailyBalance ("
+        "wallet CHAR(50) NOT NULL,"
+        "date DATE NOT NULL,"
+        "delta REAL NOT NULL,"
+        "balance REAL NOT NULL,"
+        "PRIMARY KEY (wallet, date),"
+        "FOREIGN KEY (wallet) REFERENCES Wallet(name)"
+        ") WITHOUT ROWID;";
+
+    // Signed changes, in cents, of the wallets kept in the append-only ledger,
+    // numbered from 1 in each wallet
+    const std::string CREATE_TABLE_WALLET_LEDGER_ENTRY =
+        "CREATE TABLE IF NOT EXISTS WalletLedgerEntry ("
+        "wallet CHAR(50) NOT NULL,"
+        "seq INTEGER NOT NULL,"
+        "amount INTEGER NOT NULL,"
+        "PRIMARY KEY (wallet, seq),"
+        "FOREIGN KEY (wallet) REFERENCES Wallet(name)"
+        ") WITHOUT ROWID;";
+
+    // Balance, in cents, of a wallet kept in the ledger after its entry seq. Seq
+    // 0 holds the balance the wallet entered the ledger with
+    const std::string CREATE_TABLE_WALLET_BALANCE_CHECKPOINT =
+        "CREATE TABLE IF NOT EXISTS WalletBalanceCheckpoint ("
+        "wallet CHAR(50) NOT NULL,"
+        "seq INTEGER NOT NULL,"
+        "balance INTEGER NOT NULL,"
+        "PRIMARY KEY (wallet, seq),"
+        "FOREIGN KEY (wallet) REFERENCES Wallet(name)"
+        ") WITHOUT ROWID;";
+
+    // Sum, count, min and max of the amounts of each month, category and wallet
+    // or credit card. The source is the wallet name for incomes and expenses, and
+    // the card number for credit card debts
+    const std::string CREATE_TABLE_SPENDING_SUMMARY =
+        "CREATE TABLE IF NOT EXISTS SpendingSummary ("
+        "month CHAR(7) NOT NULL,"
+        "category_id INTEGER NOT NULL,"
+        "kind TEXT CHECK(kind IN ('INCOME', 'EXPENSE', 'CREDIT_CARD')) NOT NULL,"
+        "source CHAR(50) NOT NULL,"
+        "total REAL NOT NULL,"
+        "count INTEGER NOT NULL,"
+        "min_amount REAL NOT NULL,"
+        "max_amount REAL NOT NULL,"
+        "PRIMARY KEY (month, category_id, kind, source)"
+        ") WITHOUT ROWID;";
+
+    // Fingerprint of the schema the database was last set up with. Startup skips
+    // the DDL when it matches the fingerprint of the schema below
+    const std::string CREATE_TABLE_SCHEMA_INFO =
+        "CREATE TABLE IF NOT EXISTS SchemaInfo ("
+        "id INTEGER PRIMARY KEY CHECK (id = 1),"
+        "fingerprint INTEGER NOT NULL"
+        ");";
+
+    const std::string SELECT_SCHEMA_FINGERPRINT =
+        "SELECT fingerprint FROM SchemaInfo WHERE id = 1;";
+
+    const std::string UPDATE_SCHEMA_FINGERPRINT =
+        "INSERT OR REPLACE INTO SchemaInfo (id, fingerprint) VALUES (1, ?);";
+
+    /**
+     * @brief Table created at startup
+     **/
+    struct Table
+    {
+            std::string_view   name;
+            const std::string& create;
+    };
+
+    // Tables in the order they are created
+    const Table TABLES[] = { { "Wallet", CREATE_TABLE_WALLET },
+                             { "Category", CREATE_TABLE_CATEGORY },
+                             { "WalletTransaction", CREATE_TABLE_WALLET_TRANSACTION },
+                             { "Transfer", CREATE_TABLE_TRANSFER },
+                             { "CreditCard", CREATE_TABLE_CREDIT_CARD },
+                             { "CreditCardDebt", CREATE_TABLE_CREDIT_CARD_DEBT },
+                             { "CreditCardPayment", CREATE_TABLE_CREDIT_CARD_PAYMENT },
+                             { "WalletDailyBalance",
+                               CREATE_TABLE_WALLET_DAILY_BALANCE },
+                             { "SpendingSummary", CREATE_TABLE_SPENDING_SUMMARY },
+                             { "WalletLedgerEntry", CREATE_TABLE_WALLET_LEDGER_ENTRY },
+                             { "WalletBalanceCheckpoint",
+                               CREATE_TABLE_WALLET_BALANCE_CHECKPOINT },
+                             { "SchemaInfo", CREATE_TABLE_SCHEMA_INFO } };
+
     // Queries to delete data from the database
     const std::string DELETE_TABLE_WALLET   = "DELETE FROM Wallet;";
     const std::string DELETE_TABLE_CATEGORY = "DELETE FROM Category;";
@@ -93,6 +187,494 @@ namespace query
     const std::string DELETE_TABLE_CREDIT_CARD_DEBT = "DELETE FROM CreditCardDebt;";
     const std::string DELETE_TABLE_CREDIT_CARD_PAYMENT =
         "DELETE FROM CreditCardPayment;";
+    const std::string DELETE_TABLE_WALLET_DAILY_BALANCE =
+        "DELETE FROM WalletDailyBalance;";
+    const std::string DELETE_TABLE_SPENDING_SUMMARY = "DELETE FROM SpendingSummary;";
+    const std::string DELETE_TABLE_WALLET_LEDGER_ENTRY =
+        "DELETE FROM WalletLedgerEntry;";
+    const std::string DELETE_TABLE_WALLET_BALANCE_CHECKPOINT =
+        "DELETE FROM WalletBalanceCheckpoint;";
+
+    // Wallet queries
+    const std::string SELECT_WALLET_NAMES = "SELECT name FROM Wallet;";
+
+    const std::string SELECT_WALLET_NAMES_AND_BALANCES =
+        "SELECT name, balance FROM Wallet;";
+
+    const std::string SELECT_WALLET_BALANCE =
+        "SELECT balance FROM Wallet WHERE name = ?;";
+
+    const std::string COUNT_WALLET = "SELECT COUNT(*) FROM Wallet WHERE name = ?;";
+
+    // A new wallet opens with its balance
+    const std::string INSERT_WALLET =
+        "INSERT INTO Wallet (name, balance, opening_balance) VALUES (?1, ?2, ?2);";
+
+    const std::string SELECT_WALLET_NAMES_ORDERED =
+        "SELECT name FROM Wallet ORDER BY name;";
+
+    // Balance, in cents, of the wallet of the enclosing query if it is kept in
+    // the ledger: its last checkpoint plus the fewer than
+    // config::LEDGER_CHECKPOINT_INTERVAL entries after it. NULL otherwise
+    const std::string WALLET_LEDGER_BALANCE =
+        "(SELECT c.balance + COALESCE((SELECT SUM(e.amount) FROM WalletLedgerEntry "
+        "AS e WHERE e.wallet = c.wallet AND e.seq > c.seq), 0) "
+        "FROM WalletBalanceCheckpoint AS c WHERE c.wallet = Wallet.name "
+        "ORDER BY c.seq DESC LIMIT 1)";
+
+    // Balance of a wallet, whether it is kept in the ledger or in place
+    const std::string SELECT_WALLET_CURRENT_BALANCE =
+        std::string("SELECT COALESCE(") + WALLET_LEDGER_BALANCE +
+        ", balance) FROM Wallet WHERE name = ?;";
+
+    const std::string SELECT_WALLET_NAMES_AND_CURRENT_BALANCES =
+        std::string("SELECT name, COALESCE(") + WALLET_LEDGER_BALANCE +
+        ", balance) FROM Wallet;";
+
+    // Balance of the wallets named from ?1 to ?2, and the balance recomputed from
+    // the opening balance and the history. Each wallet reads its rows through
+    // the wallet indexes of WalletTransaction and Transfer
+    const std::string SELECT_WALLET_LEDGER_BALANCES =
+        std::string("SELECT name, COALESCE(") + WALLET_LEDGER_BALANCE +
+        ", balance), opening_balance"
+        " + COALESCE((SELECT SUM(CASE type WHEN 'INCOME' THEN amount ELSE -amount"
+        " END) FROM WalletTransaction WHERE wallet = Wallet.name), 0)"
+        " - COALESCE((SELECT SUM(amount) FROM Transfer"
+        " WHERE sender_wallet = Wallet.name), 0)"
+        " + COALESCE((SELECT SUM(amount) FROM Transfer"
+        " WHERE receiver_wallet = Wallet.name), 0) "
+        "FROM Wallet WHERE name >= ?1 AND name <= ?2 ORDER BY name;";
+
+    const std::string DELETE_WALLET = "DELETE FROM Wallet WHERE name = ?;";
+
+    const std::string UPDATE_WALLET_BALANCE =
+        "UPDATE Wallet SET balance = ? WHERE name = ?;";
+
+    const std::string INSERT_WALLET_TRANSACTION =
+        "INSERT INTO WalletTransaction (wallet, category_id, type, date, amount, "
+        "description) VALUES (?, ?, ?, ?, ?, ?);";
+
+    // Multi-row insert, completed with one WALLET_TRANSACTION_ROW per row
+    const std::string INSERT_WALLET_TRANSACTIONS =
+        "INSERT INTO WalletTransaction (wallet, category_id, type, date, amount, "
+        "description) VALUES ";
+    const std::string WALLET_TRANSACTION_ROW = "(?, ?, ?, ?, ?, ?)";
+
+    // Delta updates that return the new balance. A debit only matches when the
+    // balance covers it, so no row is returned if it does not. Wallets kept in
+    // the ledger are left out, since the row does not hold their balance
+    const std::string CREDIT_WALLET_BALANCE =
+        "UPDATE Wallet SET balance = balance + ?1 WHERE name = ?2 "
+        "AND NOT EXISTS (SELECT 1 FROM WalletBalanceCheckpoint WHERE wallet = ?2) "
+        "RETURNING balance;";
+
+    const std::string DEBIT_WALLET_BALANCE =
+        "UPDATE Wallet SET balance = balance - ?1 "
+        "WHERE name = ?2 AND balance >= ?1 "
+        "AND NOT EXISTS (SELECT 1 FROM WalletBalanceCheckpoint WHERE wallet = ?2) "
+        "RETURNING balance;";
+
+    const std::string INSERT_TRANSFER =
+        "INSERT INTO Transfer (sender_wallet, receiver_wallet, date, amount) "
+        "VALUES (?, ?, ?, ?);";
+
+    // Multi-row insert, completed with one TRANSFER_ROW per row
+    const std::string INSERT_TRANSFERS =
+        "INSERT INTO Transfer (sender_wallet, receiver_wallet, date, amount) VALUES ";
+    const std::string TRANSFER_ROW = "(?, ?, ?, ?)";
+
+    // Daily balances. A change on a day first adds the row of the day, with the
+    // closing balance of the day before it, and then patches that row and the
+    // ones after it. Earlier days are never touched. Without any row before the
+    // day, the opening balance is taken from the first row after it or, if the
+    // wallet has no rows, from ?3
+    const std::string INSERT_WALLET_DAILY_BALANCE =
+        "INSERT INTO WalletDailyBalance (wallet, date, delta, balance) "
+        "VALUES (?1, ?2, 0, COALESCE("
+        "(SELECT balance FROM WalletDailyBalance WHERE wallet = ?1 AND date < ?2 "
+        "ORDER BY date DESC LIMIT 1),"
+        "(SELECT balance - delta FROM WalletDailyBalance WHERE wallet = ?1 "
+        "AND date > ?2 ORDER BY date LIMIT 1),"
+        "?3)) "
+        "ON CONFLICT (wallet, date) DO NOTHING;";
+
+    const std::string ADD_TO_WALLET_DAILY_BALANCES =
+        "UPDATE WalletDailyBalance SET balance = balance + ?3, "
+        "delta = delta + CASE WHEN date = ?2 THEN ?3 ELSE 0 END "
+        "WHERE wallet = ?1 AND date >= ?2;";
+
+    // Closing balance of the last day up to ?2. Before the first row, it is the
+    // opening balance of that row, and without rows it is the wallet balance
+    const std::string SELECT_WALLET_BALANCE_AS_OF =
+        "SELECT COALESCE("
+        "(SELECT balance FROM WalletDailyBalance WHERE wallet = ?1 AND date <= ?2 "
+        "ORDER BY date DESC LIMIT 1),"
+        "(SELECT balance - delta FROM WalletDailyBalance WHERE wallet = ?1 "
+        "AND date > ?2 ORDER BY date LIMIT 1),"
+        "balance) "
+        "FROM Wallet WHERE name = ?1;";
+
+    const std::string SELECT_WALLET_BALANCE_SERIES =
+        "SELECT date, balance FROM WalletDailyBalance "
+        "WHERE wallet = ? AND date BETWEEN ? AND ? ORDER BY date;";
+
+    const std::string DELETE_WALLET_DAILY_BALANCES =
+        "DELETE FROM WalletDailyBalance WHERE wallet = ?;";
+
+    // Append-only ledger queries. A wallet enters the ledger with its balance as
+    // the checkpoint of seq 0, and entries are only appended to wallets that did
+    const std::string INSERT_WALLET_LEDGER_START =
+        "INSERT OR IGNORE INTO WalletBalanceCheckpoint (wallet, seq, balance) "
+        "SELECT name, 0, balance FROM Wallet "
+        "WHERE name = ?;";
+
+    const std::string COUNT_WALLET_BALANCE_CHECKPOINTS =
+        "SELECT COUNT(*) FROM WalletBalanceCheckpoint WHERE wallet = ?;";
+
+    const std::string APPEND_WALLET_LEDGER_ENTRY =
+        "INSERT INTO WalletLedgerEntry (wallet, seq, amount) "
+        "SELECT ?1, COALESCE(MAX(seq), 0) + 1, ?2 FROM WalletLedgerEntry "
+        "WHERE wallet = ?1 "
+        "HAVING EXISTS (SELECT 1 FROM WalletBalanceCheckpoint WHERE wallet = ?1);";
+
+    // Checkpoint the balance of wallet ?1 once ?2 entries follow its last one
+    const std::string INSERT_WALLET_BALANCE_CHECKPOINT =
+        "INSERT INTO WalletBalanceCheckpoint (wallet, seq, balance) "
+        "SELECT ?1, MAX(e.seq), c.balance + SUM(e.amount) "
+        "FROM (SELECT seq, balance FROM WalletBalanceCheckpoint WHERE wallet = ?1 "
+        "ORDER BY seq DESC LIMIT 1) AS c "
+        "JOIN WalletLedgerEntry AS e ON e.wallet = ?1 AND e.seq > c.seq "
+        "HAVING COUNT(*) >= ?2;";
+
+    // Balance, in cents, of wallet ?1 right after its entry ?2, from the last
+    // checkpoint up to that entry
+    const std::string SELECT_WALLET_BALANCE_AFTER_ENTRY =
+        "SELECT c.balance + COALESCE((SELECT SUM(amount) FROM WalletLedgerEntry "
+        "WHERE wallet = ?1 AND seq > c.seq AND seq <= ?2), 0) "
+        "FROM WalletBalanceCheckpoint AS c WHERE c.wallet = ?1 AND c.seq <= ?2 "
+        "ORDER BY c.seq DESC LIMIT 1;";
+
+    const std::string DELETE_WALLET_LEDGER_ENTRIES =
+        "DELETE FROM WalletLedgerEntry WHERE wallet = ?;";
+
+    const std::string DELETE_WALLET_BALANCE_CHECKPOINTS =
+        "DELETE FROM WalletBalanceCheckpoint WHERE wallet = ?;";
+
+    // Daily balances of a wallet recomputed from its opening balance and its
+    // history, after its rows were deleted
+    const std::string REBUILD_WALLET_DAILY_BALANCES =
+        "INSERT INTO WalletDailyBalance (wallet, date, delta, balance) "
+        "SELECT ?1, date, SUM(delta), "
+        "(SELECT opening_balance FROM Wallet WHERE name = ?1)"
+        " + SUM(SUM(delta)) OVER (ORDER BY date) "
+        "FROM (SELECT date, CASE type WHEN 'INCOME' THEN amount ELSE -amount END "
+        "AS delta FROM WalletTransaction WHERE wallet = ?1 "
+        "UNION ALL SELECT date, -amount FROM Transfer WHERE sender_wallet = ?1 "
+        "UNION ALL SELECT date, amount FROM Transfer WHERE receiver_wallet = ?1) "
+        "GROUP BY date;";
+
+    /**
+     * @brief Complete a multi-row insert with the placeholders of a number of rows
+     * @param insert The insert up to VALUES
+     * @param row The placeholders of one row
+     * @param rows The number of rows
+     **/
+    inline std::string
+    MultiRowInsert(const std::string& insert, const std::string& row, std::size_t rows)
+    {
+        std::string sql = insert;
+
+        sql.reserve(sql.size() + rows * (row.size() + 2) + 1);
+
+        for (std::size_t i = 0; i < rows; i++)
+        {
+            if (i > 0)
+            {
+                sql += ", ";
+            }
+
+            sql += row;
+        }
+
+        sql += ';';
+        return sql;
+    }
+
+    // Category queries
+    const std::string SELECT_CATEGORY_NAMES = "SELECT name FROM Category;";
+
+    const std::string SELECT_CATEGORY_ID =
+        "SELECT category_id FROM Category WHERE name = ?;";
+
+    const std::string SELECT_CATEGORY_NAMES_AND_IDS =
+        "SELECT name, category_id FROM Category;";
+
+    const std::string COUNT_CATEGORY = "SELECT COUNT(*) FROM Category WHERE name = ?;";
+
+    const std::string INSERT_CATEGORY = "INSERT INTO Category (name) VALUES (?);";
+
+    // Credit card queries
+    const std::string SELECT_CREDIT_CARD_NUMBERS = "SELECT number FROM CreditCard;";
+
+    const std::string SELECT_CREDIT_CARD_INFO =
+        "SELECT name, max_debt, billing_due_day FROM CreditCard WHERE number = ?;";
+
+    const std::string SELECT_CREDIT_CARD_MAX_DEBT =
+        "SELECT max_debt FROM CreditCard WHERE number = ?;";
+
+    const std::string SELECT_CREDIT_CARD_BILLING_DUE_DAY =
+        "SELECT billing_due_day FROM CreditCard WHERE number = ?;";
+
+    const std::string COUNT_CREDIT_CARD =
+        "SELECT COUNT(*) FROM CreditCard WHERE number = ?;";
+
+    const std::string INSERT_CREDIT_CARD =
+        "INSERT INTO CreditCard (number, name, max_debt, billing_due_day) "
+        "VALUES (?, ?, ?, ?);";
+
+    const std::string INSERT_CREDIT_CARD_DEBT =
+        "INSERT INTO CreditCardDebt (crc_number, category_id, date, total_amount, "
+        "description) VALUES (?, ?, ?, ?, ?);";
+
+    const std::string INSERT_CREDIT_CARD_PAYMENT =
+        "INSERT INTO CreditCardPayment (debt_id, date, amount, installment) "
+        "VALUES (?, ?, ?, ?);";
+
+    const std::string INSERT_PAID_CREDIT_CARD_PAYMENT =
+        "INSERT INTO CreditCardPayment (debt_id, wallet, date, amount, installment) "
+        "VALUES (?, ?, ?, ?, ?);";
+
+    const std::string SELECT_LAST_CREDIT_CARD_EXPENSE =
+        "SELECT CreditCardDebt.debt_id, Category.name, CreditCardDebt.date, "
+        "CreditCardDebt.total_amount, CreditCardDebt.description, "
+        "COUNT(CreditCardPayment.installment) AS installments "
+        "FROM CreditCardDebt "
+        "INNER JOIN Category "
+        "ON CreditCardDebt.category_id = Category.category_id "
+        "INNER JOIN CreditCardPayment "
+        "ON CreditCardDebt.debt_id = CreditCardPayment.debt_id "
+        "WHERE CreditCardDebt.crc_number = ? "
+        "GROUP BY CreditCardDebt.debt_id "
+        "ORDER BY CreditCardDebt.debt_id DESC LIMIT 1;";
+
+    // CreditCardPayment.wallet NULL means that the installment has not been paid yet
+    const std::string SELECT_CREDIT_CARD_PENDING_DEBT =
+        "SELECT SUM(CreditCardPayment.amount) AS total_amount "
+        "FROM CreditCardDebt "
+        "INNER JOIN CreditCardPayment "
+        "ON CreditCardDebt.debt_id = CreditCardPayment.debt_id "
+        "WHERE CreditCardDebt.crc_number = ? "
+        "AND CreditCardPayment.wallet IS NULL;";
+
+    // Export queries. Category ids are replaced by their names, amounts are
+    // written in units rather than cents and rows come in the order they were
+    // inserted
+    const std::string EXPORT_WALLET_TRANSACTIONS =
+        "SELECT t.wallet_transaction_id, t.wallet, c.name, t.type, t.date, "
+        "t.amount / 100.0, t.description FROM WalletTransaction t "
+        "LEFT JOIN Category c ON c.category_id = t.category_id "
+        "ORDER BY t.wallet_transaction_id;";
+
+    const std::string EXPORT_TRANSFERS =
+        "SELECT transfer_id, sender_wallet, receiver_wallet, date, amount / 100.0, "
+        "description FROM Transfer ORDER BY transfer_id;";
+
+    const std::string EXPORT_CREDIT_CARD_DEBTS =
+        "SELECT d.debt_id, d.crc_number, c.name, d.date, d.total_amount / 100.0, "
+        "d.description FROM CreditCardDebt d "
+        "LEFT JOIN Category c ON c.category_id = d.category_id "
+        "ORDER BY d.debt_id;";
+
+    const std::string EXPORT_CREDIT_CARD_PAYMENTS =
+        "SELECT payment_id, wallet, debt_id, date, amount / 100.0, installment "
+        "FROM CreditCardPayment ORDER BY payment_id;";
+
+    // Spending summary queries. A cell is merged into the one of its key, so each
+    // write touches a single row
+    const std::string ADD_TO_SPENDING_SUMMARY =
+        "INSERT INTO SpendingSummary (month, category_id, kind, source, total, count, "
+        "min_amount, max_amount) VALUES (?, ?, ?, ?, ?, ?, ?, ?) "
+        "ON CONFLICT (month, category_id, kind, source) DO UPDATE SET "
+        "total = total + excluded.total, count = count + excluded.count, "
+        "min_amount = MIN(min_amount, excluded.min_amount), "
+        "max_amount = MAX(max_amount, excluded.max_amount);";
+
+    const std::string SELECT_SPENDING_SUMMARY =
+        "SELECT month, category_id, kind, source, total, count, min_amount, "
+        "max_amount FROM SpendingSummary WHERE month BETWEEN ? AND ? "
+        "ORDER BY month, category_id, kind, source;";
+
+    // Compute the spending summary again from the history
+    constexpr std::string_view REBUILD_SPENDING_SUMMARY =
+        "DELETE FROM SpendingSummary;"
+        "INSERT INTO SpendingSummary (month, category_id, kind, source, total, count, "
+        "min_amount, max_amount) "
+        "SELECT substr(date, 1, 7), category_id, type, wallet, SUM(amount), "
+        "COUNT(*), MIN(amount), MAX(amount) FROM WalletTransaction "
+        "GROUP BY substr(date, 1, 7), category_id, type, wallet;"
+        "INSERT INTO SpendingSummary (month, category_id, kind, source, total, count, "
+        "min_amount, max_amount) "
+        "SELECT substr(date, 1, 7), category_id, 'CREDIT_CARD', crc_number, "
+        "SUM(total_amount), COUNT(*), MIN(total_amount), MAX(total_amount) "
+        "FROM CreditCardDebt GROUP BY substr(date, 1, 7), category_id, crc_number;";
+
+    /**
+     * @brief Versioned change to the schema, applied once to each database
+     **/
+    struct Migration
+    {
+            uint32_t         version;
+            std::string_view description;
+            std::string_view script;
+    };
+
+    // Indexes designed around the queries above. The partial index on pending
+    // installments covers SELECT_CREDIT_CARD_PENDING_DEBT, so the sum is computed
+    // from the index without reading the paid installments or the table rows
+    constexpr std::string_view MIGRATION_MANAGER_INDEXES =
+        "CREATE INDEX IF NOT EXISTS idx_wallet_transaction_wallet_date "
+        "ON WalletTransaction (wallet, date);"
+        "CREATE INDEX IF NOT EXISTS idx_transfer_sender_date "
+        "ON Transfer (sender_wallet, date);"
+        "CREATE INDEX IF NOT EXISTS idx_transfer_receiver_date "
+        "ON Transfer (receiver_wallet, date);"
+        "CREATE INDEX IF NOT EXISTS idx_credit_card_debt_crc_number "
+        "ON CreditCardDebt (crc_number);"
+        "CREATE INDEX IF NOT EXISTS idx_credit_card_payment_debt "
+        "ON CreditCardPayment (debt_id, installment);"
+        "CREATE INDEX IF NOT EXISTS idx_credit_card_payment_pending "
+        "ON CreditCardPayment (debt_id, amount) WHERE wallet IS NULL;"
+        "CREATE INDEX IF NOT EXISTS idx_credit_card_payment_wallet "
+        "ON CreditCardPayment (wallet) WHERE wallet IS NOT NULL;"
+        "CREATE UNIQUE INDEX IF NOT EXISTS idx_category_name ON Category (name);";
+
+    // Fill the daily balances of the wallets from their history. The closing
+    // balance of a day is the current balance minus every change after that day
+    constexpr std::string_view MIGRATION_WALLET_DAILY_BALANCES =
+        "WITH moves (wallet, date, delta) AS ("
+        "SELECT wallet, date, CASE type WHEN 'INCOME' THEN amount ELSE -amount END "
+        "FROM WalletTransaction "
+        "UNION ALL SELECT sender_wallet, date, -amount FROM Transfer "
+        "UNION ALL SELECT receiver_wallet, date, amount FROM Transfer), "
+        "days (wallet, date, delta) AS ("
+        "SELECT wallet, date, SUM(delta) FROM moves GROUP BY wallet, date) "
+        "INSERT OR IGNORE INTO WalletDailyBalance (wallet, date, delta, balance) "
+        "SELECT days.wallet, days.date, days.delta, Wallet.balance "
+        "- SUM(days.delta) OVER (PARTITION BY days.wallet) "
+        "+ SUM(days.delta) OVER (PARTITION BY days.wallet ORDER BY days.date) "
+        "FROM days JOIN Wallet ON Wallet.name = days.wallet;";
+
+    // Fill the spending summary from the history. A frozen copy of the rebuild
+    // as it was released, so later changes to REBUILD_SPENDING_SUMMARY do not
+    // change this migration
+    constexpr std::string_view MIGRATION_SPENDING_SUMMARY =
+        "DELETE FROM SpendingSummary;"
+        "INSERT INTO SpendingSummary (month, category_id, kind, source, total, count, "
+        "min_amount, max_amount) "
+        "SELECT substr(date, 1, 7), category_id, type, wallet, SUM(amount), "
+        "COUNT(*), MIN(amount), MAX(amount) FROM WalletTransaction "
+        "GROUP BY substr(date, 1, 7), category_id, type, wallet;"
+        "INSERT INTO SpendingSummary (month, category_id, kind, source, total, count, "
+        "min_amount, max_amount) "
+        "SELECT substr(date, 1, 7), category_id, 'CREDIT_CARD', crc_number, "
+        "SUM(total_amount), COUNT(*), MIN(total_amount), MAX(total_amount) "
+        "FROM CreditCardDebt GROUP BY substr(date, 1, 7), category_id, crc_number;";
+
+    // Opening balance of each wallet, from which its balance can be recomputed.
+    // The balances of the wallets that already exist are trusted, so each one
+    // opens with its balance minus its history
+    constexpr std::string_view MIGRATION_WALLET_OPENING_BALANCES =
+        "ALTER TABLE Wallet ADD COLUMN opening_balance REAL NOT NULL DEFAULT 0;"
+        "UPDATE Wallet SET opening_balance = ROUND(balance"
+        " - COALESCE((SELECT SUM(CASE type WHEN 'INCOME' THEN amount ELSE -amount END)"
+        " FROM WalletTransaction WHERE wallet = Wallet.name), 0)"
+        " + COALESCE((SELECT SUM(amount) FROM Transfer"
+        " WHERE sender_wallet = Wallet.name), 0)"
+        " - COALESCE((SELECT SUM(amount) FROM Transfer"
+        " WHERE receiver_wallet = Wallet.name), 0), 2);";
+
+    // Store every amount and balance as INTEGER cents, so sums are exact. SQLite
+    // cannot change the type of a column, so each one is replaced by a new
+    // column of the converted values. The pending installments index covers a
+    // converted column, so it is dropped meanwhile
+    constexpr std::string_view MIGRATION_MONEY_CENTS =
+        "DROP INDEX IF EXISTS idx_credit_card_payment_pending;"
+        "ALTER TABLE Wallet ADD COLUMN balance_cents INTEGER NOT NULL DEFAULT 0;"
+        "ALTER TABLE Wallet ADD COLUMN opening_balance_cents INTEGER NOT NULL "
+        "DEFAULT 0;"
+        "UPDATE Wallet SET balance_cents = CAST(ROUND(balance * 100) AS INTEGER), "
+        "opening_balance_cents = CAST(ROUND(opening_balance * 100) AS INTEGER);"
+        "ALTER TABLE Wallet DROP COLUMN balance;"
+        "ALTER TABLE Wallet DROP COLUMN opening_balance;"
+        "ALTER TABLE Wallet RENAME COLUMN balance_cents TO balance;"
+        "ALTER TABLE Wallet RENAME COLUMN opening_balance_cents TO opening_balance;"
+        "ALTER TABLE WalletTransaction ADD COLUMN amount_cents INTEGER NOT NULL "
+        "DEFAULT 0;"
+        "UPDATE WalletTransaction SET amount_cents = "
+        "CAST(ROUND(amount * 100) AS INTEGER);"
+        "ALTER TABLE WalletTransaction DROP COLUMN amount;"
+        "ALTER TABLE WalletTransaction RENAME COLUMN amount_cents TO amount;"
+        "ALTER TABLE Transfer ADD COLUMN amount_cents INTEGER NOT NULL DEFAULT 0;"
+        "UPDATE Transfer SET amount_cents = CAST(ROUND(amount * 100) AS INTEGER);"
+        "ALTER TABLE Transfer DROP COLUMN amount;"
+        "ALTER TABLE Transfer RENAME COLUMN amount_cents TO amount;"
+        "ALTER TABLE CreditCard ADD COLUMN max_debt_cents INTEGER NOT NULL "
+        "DEFAULT 0;"
+        "UPDATE CreditCard SET max_debt_cents = "
+        "CAST(ROUND(max_debt * 100) AS INTEGER);"
+        "ALTER TABLE CreditCard DROP COLUMN max_debt;"
+        "ALTER TABLE CreditCard RENAME COLUMN max_debt_cents TO max_debt;"
+        "ALTER TABLE CreditCardDebt ADD COLUMN total_amount_cents INTEGER NOT NULL "
+        "DEFAULT 0;"
+        "UPDATE CreditCardDebt SET total_amount_cents = "
+        "CAST(ROUND(total_amount * 100) AS INTEGER);"
+        "ALTER TABLE CreditCardDebt DROP COLUMN total_amount;"
+        "ALTER TABLE CreditCardDebt RENAME COLUMN total_amount_cents TO total_amount;"
+        "ALTER TABLE CreditCardPayment ADD COLUMN amount_cents INTEGER NOT NULL "
+        "DEFAULT 0;"
+        "UPDATE CreditCardPayment SET amount_cents = "
+        "CAST(ROUND(amount * 100) AS INTEGER);"
+        "ALTER TABLE CreditCardPayment DROP COLUMN amount;"
+        "ALTER TABLE CreditCardPayment RENAME COLUMN amount_cents TO amount;"
+        "ALTER TABLE WalletDailyBalance ADD COLUMN delta_cents INTEGER NOT NULL "
+        "DEFAULT 0;"
+        "ALTER TABLE WalletDailyBalance ADD COLUMN balance_cents INTEGER NOT NULL "
+        "DEFAULT 0;"
+        "UPDATE WalletDailyBalance SET delta_cents = "
+        "CAST(ROUND(delta * 100) AS INTEGER), "
+        "balance_cents = CAST(ROUND(balance * 100) AS INTEGER);"
+        "ALTER TABLE WalletDailyBalance DROP COLUMN delta;"
+        "ALTER TABLE WalletDailyBalance DROP COLUMN balance;"
+        "ALTER TABLE WalletDailyBalance RENAME COLUMN delta_cents TO delta;"
+        "ALTER TABLE WalletDailyBalance RENAME COLUMN balance_cents TO balance;"
+        "ALTER TABLE SpendingSummary ADD COLUMN total_cents INTEGER NOT NULL "
+        "DEFAULT 0;"
+        "ALTER TABLE SpendingSummary ADD COLUMN min_amount_cents INTEGER NOT NULL "
+        "DEFAULT 0;"
+        "ALTER TABLE SpendingSummary ADD COLUMN max_amount_cents INTEGER NOT NULL "
+        "DEFAULT 0;"
+        "UPDATE SpendingSummary SET total_cents = "
+        "CAST(ROUND(total * 100) AS INTEGER), "
+        "min_amount_cents = CAST(ROUND(min_amount * 100) AS INTEGER), "
+        "max_amount_cents = CAST(ROUND(max_amount * 100) AS INTEGER);"
+        "ALTER TABLE SpendingSummary DROP COLUMN total;"
+        "ALTER TABLE SpendingSummary DROP COLUMN min_amount;"
+        "ALTER TABLE SpendingSummary DROP COLUMN max_amount;"
+        "ALTER TABLE SpendingSummary RENAME COLUMN total_cents TO total;"
+        "ALTER TABLE SpendingSummary RENAME COLUMN min_amount_cents TO min_amount;"
+        "ALTER TABLE SpendingSummary RENAME COLUMN max_amount_cents TO max_amount;"
+        "CREATE INDEX IF NOT EXISTS idx_credit_card_payment_pending "
+        "ON CreditCardPayment (debt_id, amount) WHERE wallet IS NULL;";
 
+    // Migrations in the order they are applied. PRAGMA user_version holds the
+    // version of the last migration applied. Released migrations must never be
+    // changed, new ones are appended with the next version
+    constexpr Migration MIGRATIONS[] = {
+        { 1, "Indexes for the manager queries", MIGRATION_MANAGER_INDEXES },
+        { 2, "Daily wallet balances", MIGRATION_WALLET_DAILY_BALANCES },
+        { 3, "Spending summary", MIGRATION_SPENDING_SUMMARY },
+        { 4, "Wallet opening balances", MIGRATION_WALLET_OPENING_BALANCES },
+        { 5, "Amounts and balances in cents", MIGRATION_MONEY_CENTS }
+    };
 } // namespace query
 #endif // SQL_QUERIES_H_
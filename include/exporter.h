@@ -0,0 +1,286 @@
+/*
+ * Filename: exporter.h
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ *
+ * This file contains the declaration of the Exporter class. This class streams
+ * the transaction history out of the database to CSV, NDJSON or a columnar binary
+ * file.
+ */
+
+#ifndef EXPORTER_H_
+#define EXPORTER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <sqlite3.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "db_manager.h"
+#include "log_manager.h"
+
+/**
+ * @brief Output file written in whole, aligned buffers
+ *
+ * Data is gathered in a buffer of config::EXPORT_BUFFER_SIZE bytes aligned to
+ * config::EXPORT_BUFFER_ALIGNMENT, and only full buffers are written, except the
+ * last one when the file is closed.
+ **/
+class BufferedWriter
+{
+    private:
+        int         m_fd;
+        char*       m_buffer;
+        std::size_t m_used;
+        uint64_t    m_written;
+        bool        m_failed;
+
+    public:
+        /**
+         * @brief Create or truncate a file
+         * @param path Path of the file
+         **/
+        explicit BufferedWriter(const std::string& path) noexcept;
+
+        /**
+         * @brief Destructor. Closes the file, discarding the data still buffered
+         *        if Close was not called
+         **/
+        ~BufferedWriter() noexcept;
+
+        BufferedWriter(const BufferedWriter&)            = delete;
+        BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+        /**
+         * @brief Check if the file was opened and every write succeeded
+         **/
+        bool IsGood() const noexcept;
+
+        /**
+         * @brief Append bytes to the file
+         **/
+        void Write(const void* data, std::size_t size) noexcept;
+
+        /**
+         * @brief Append text to the file
+         **/
+        void Write(std::string_view text) noexcept;
+
+        /**
+         * @brief Write the buffered data and close the file
+         * @return bool True if every write succeeded
+         **/
+        bool Close() noexcept;
+
+        /**
+         * @brief Get the number of bytes appended so far
+         **/
+        uint64_t GetSize() const noexcept;
+
+    private:
+        /**
+         * @brief Write the buffered data to the file
+         **/
+        void Flush() noexcept;
+};
+
+/**
+ * @brief Streaming export of the transaction history
+ *
+ * Rows are read one at a time and written as they are read, so memory does not
+ * grow with the size of the table. Queries run on a reader connection when the
+ * database has them, so an export does not hold the writer back.
+ *
+ * Category ids are exported as category names. Every export starts with the
+ * names of the columns: a header line in CSV, the keys of each object in NDJSON
+ * and the file header in the columnar format.
+ *
+ * The columnar format stores rows in groups of config::EXPORT_ROW_GROUP_ROWS.
+ * Each group holds its columns one after the other, so a reader can skip the
+ * columns it does not need. Numbers are little-endian:
+ *
+ *     file       := "MFNCOL1\0" u32 columns column-def* group* u32 0
+ *     column-def := u8 type, u16 length, name
+ *     group      := u32 rows column-data*
+ *     column-data:= null-bitmap[(rows + 7) / 8] values
+ *     values     := i64[rows]                            (Integer)
+ *                 | f64[rows]                            (Real)
+ *                 | u32 offsets[rows + 1] bytes          (Text)
+ *                 | u32 entries {u32 length, bytes}*     (Dictionary)
+ *                   u32 codes[rows]
+ *
+ * Bit i of a null bitmap is set if the value of row i is NULL. Dictionary
+ * columns, used for wallets, categories and other repeated names, list only the
+ * entries first seen in the group. Codes index the entries of the whole file in
+ * the order they were listed.
+ **/
+class Exporter
+{
+    public:
+        enum class Table
+        {
+            WalletTransaction,
+            Transfer,
+            CreditCardDebt,
+            CreditCardPayment
+        };
+
+        enum class Format
+        {
+            Csv,
+            Ndjson,
+            Columnar
+        };
+
+        enum class ColumnType : uint8_t
+        {
+            Integer    = 0,
+            Real       = 1,
+            Text       = 2,
+            Dictionary = 3
+        };
+
+        /**
+         * @brief Outcome of an export
+         **/
+        struct Stats
+        {
+                uint64_t                 rows  = 0;
+                uint64_t                 bytes = 0;
+                std::chrono::nanoseconds elapsed{ 0 };
+        };
+
+        /**
+         * @brief Name and type of an exported column
+         **/
+        struct Column
+        {
+                std::string_view name;
+                ColumnType       type;
+        };
+
+    private:
+        /**
+         * @brief Row group of the columnar format being filled
+         **/
+        class ColumnarEncoder
+        {
+            private:
+                struct EntryHash
+                {
+                        using is_transparent = void;
+
+                        std::size_t operator()(std::string_view entry) const noexcept
+                        {
+                            return std::hash<std::string_view>()(entry);
+                        }
+                };
+
+                using Dictionary = std::
+                    unordered_map<std::string, uint32_t, EntryHash, std::equal_to<>>;
+
+                struct ColumnData
+                {
+                        std::vector<uint8_t>  nulls;
+                        std::vector<int64_t>  integers;
+                        std::vector<double>   reals;
+                        std::vector<uint32_t> offsets;
+                        std::string           bytes;
+                        std::vector<uint32_t> codes;
+
+                        // Entries of a dictionary column, and those not written yet
+                        Dictionary                    dictionary;
+                        std::vector<std::string_view> newEntries;
+                };
+
+                std::span<const Column> m_columns;
+                std::vector<ColumnData> m_data;
+                uint32_t                m_rows;
+
+            public:
+                explicit ColumnarEncoder(std::span<const Column> columns);
+
+                /**
+                 * @brief Write the file header
+                 **/
+                void WriteHeader(BufferedWriter& writer) const noexcept;
+
+                /**
+                 * @brief Add the current row of a statement, writing the group
+                 *        once it is full
+                 **/
+                void Add(sqlite3_stmt* stmt, BufferedWriter& writer);
+
+                /**
+                 * @brief Write the last group and the end marker
+                 **/
+                void Finish(BufferedWriter& writer);
+
+            private:
+                /**
+                 * @brief Write the rows added since the last group
+                 **/
+                void WriteGroup(BufferedWriter& writer);
+        };
+
+        DBManager&  m_dbManager;
+        LogManager& m_logManager;
+
+    public:
+        /**
+         * @brief Default constructor
+         **/
+        Exporter() noexcept;
+
+        /**
+         * @brief Constructor
+         * @param dbManager The database the rows are exported from
+         **/
+        explicit Exporter(DBManager& dbManager) noexcept;
+
+        /**
+         * @brief Export every row of a table to a file
+         * @param table The table
+         * @param format Format of the file
+         * @param path Path of the file, which is created or truncated
+         * @param stats Filled with the number of rows and bytes written
+         * @return bool True if the whole table was written
+         **/
+        bool Export(Table              table,
+                    Format             format,
+                    const std::string& path,
+                    Stats&             stats) noexcept;
+
+        /**
+         * @brief Get the columns exported for a table
+         **/
+        static std::span<const Column> GetColumns(Table table) noexcept;
+
+    private:
+        /**
+         * @brief Get the query that reads a table for export
+         **/
+        static const std::string& GetQuery(Table table) noexcept;
+
+        /**
+         * @brief Append the current row of a statement as a CSV line
+         **/
+        static void WriteCsvRow(sqlite3_stmt*           stmt,
+                                std::span<const Column> columns,
+                                std::string&            line);
+
+        /**
+         * @brief Append the current row of a statement as a JSON object line
+         **/
+        static void WriteNdjsonRow(sqlite3_stmt*           stmt,
+                                   std::span<const Column> columns,
+                                   std::string&            line);
+};
+
+#endif // EXPORTER_H_
@@ -0,0 +1,454 @@
+/*
+ * Filename: ledger_store.h
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ *
+ * This file contains the declaration of the LedgerStore interface. This interface
+ * is the storage the managers keep wallets, categories, credit cards, debts and
+ * payments in.
+ */
+
+#ifndef LEDGER_STORE_H_
+#define LEDGER_STORE_H_
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "money.h"
+
+/**
+ * @brief Expense or income of a wallet
+ **/
+struct WalletTransactionRecord
+{
+        std::string wallet;
+        int64_t     categoryId;
+        std::string type;
+        std::string date;
+        Money       amount;
+        std::string description;
+};
+
+/**
+ * @brief Transfer between two wallets
+ **/
+struct TransferRecord
+{
+        std::string sender;
+        std::string receiver;
+        std::string date;
+        Money       amount;
+};
+
+/**
+ * @brief Credit card
+ **/
+struct CreditCardRecord
+{
+        std::string number;
+        std::string name;
+        Money       maxDebt;
+        uint16_t    billingDueDay;
+};
+
+/**
+ * @brief Purchase made with a credit card
+ **/
+struct CreditCardDebtRecord
+{
+        std::string cardNumber;
+        int64_t     categoryId;
+        std::string date;
+        Money       totalAmount;
+        std::string description;
+};
+
+/**
+ * @brief Installment of a credit card debt. The wallet is empty while the
+ *        installment is not paid
+ **/
+struct CreditCardPaymentRecord
+{
+        int64_t                    debtId;
+        std::optional<std::string> wallet;
+        std::string                date;
+        Money                      amount;
+        uint16_t                   installment;
+};
+
+/**
+ * @brief Debt of a credit card as it is shown to the user
+ **/
+struct CreditCardExpense
+{
+        uint32_t    debtId;
+        std::string category;
+        std::string date;
+        Money       totalAmount;
+        std::string description;
+        uint16_t    installments;
+};
+
+/**
+ * @brief Sum, count, min and max of the amounts of a month, category and wallet or
+ *        credit card
+ **/
+struct SpendingCell
+{
+        std::string month; // YYYY-MM
+        int64_t     categoryId;
+        std::string kind;   // INCOME, EXPENSE or CREDIT_CARD
+        std::string source; // Wallet name, or card number for CREDIT_CARD
+        Money       total;
+        int64_t     count;
+        Money       minAmount;
+        Money       maxAmount;
+
+        /**
+         * @brief Add an amount to the cell
+         **/
+        void Add(Money amount) noexcept;
+
+        /**
+         * @brief Add the amounts of another cell to the cell
+         **/
+        void Merge(const SpendingCell& other) noexcept;
+};
+
+/**
+ * @brief Get the cell of a single amount
+ * @param date The date of the amount, as YYYY-MM-DD
+ **/
+SpendingCell SpendingOf(const std::string& date,
+                        int64_t            categoryId,
+                        const std::string& kind,
+                        const std::string& source,
+                        Money              amount) noexcept;
+
+/**
+ * @brief Storage of the ledger
+ *
+ * The managers only talk to this interface, so the same business logic runs on
+ * the database (SqliteLedgerStore) or entirely in memory (MemoryLedgerStore).
+ * Category and debt ids are assigned by the store.
+ *
+ * Writes done while a Transaction is open are committed or rolled back
+ * together. Transactions may be nested: an inner transaction that is rolled back
+ * only discards its own writes.
+ **/
+class LedgerStore
+{
+    public:
+        /**
+         * @brief Transaction opened by a store
+         **/
+        class Scope
+        {
+            public:
+                virtual ~Scope() noexcept = default;
+
+                /**
+                 * @brief Commit the writes done since the scope was opened
+                 * @return bool True if the writes were committed
+                 **/
+                virtual bool Commit() noexcept = 0;
+
+                /**
+                 * @brief Discard the writes done since the scope was opened
+                 **/
+                virtual void Rollback() noexcept = 0;
+
+                /**
+                 * @brief Check if the scope is still open
+                 **/
+                virtual bool IsActive() const noexcept = 0;
+        };
+
+        /**
+         * @brief RAII transaction on a store. Rolled back on destruction if it was
+         *        not committed
+         **/
+        class Transaction
+        {
+            private:
+                std::unique_ptr<Scope> m_scope;
+
+            public:
+                /**
+                 * @brief Begin a transaction, nested in the open one if any
+                 * @param store The store
+                 * NOTE: Check IsActive() to know if the transaction was started
+                 **/
+                explicit Transaction(LedgerStore& store) noexcept;
+
+                Transaction(const Transaction&)            = delete;
+                Transaction& operator=(const Transaction&) = delete;
+
+                /**
+                 * @brief Commit the transaction
+                 * @return bool True if the changes were committed
+                 **/
+                bool Commit() noexcept;
+
+                /**
+                 * @brief Roll back the transaction
+                 **/
+                void Rollback() noexcept;
+
+                /**
+                 * @brief Check if the transaction was started and not finished
+                 **/
+                bool IsActive() const noexcept;
+        };
+
+        virtual ~LedgerStore() noexcept = default;
+
+        /**
+         * @brief Open a transaction
+         * @return The scope of the transaction, or nullptr if it could not be
+         *         started
+         **/
+        virtual std::unique_ptr<Scope> BeginTransaction() noexcept = 0;
+
+        /**
+         * @brief Run an operation in the background of the store
+         * @param operation Returns true if its writes must be kept
+         * @return A future that holds the result once the writes are committed
+         **/
+        virtual std::future<bool>
+        Enqueue(std::function<bool()> operation) noexcept = 0;
+
+        /**
+         * @brief Run an action once the writes done so far are committed
+         *
+         * Inside a transaction the action waits for the outermost transaction to
+         * commit, and is dropped if the transaction it was added in is rolled
+         * back. Outside a transaction it runs right away.
+         *
+         * @param action The action. It must not throw
+         **/
+        virtual void AfterCommit(std::function<void()> action) noexcept = 0;
+
+        /**
+         * @brief Get the generation of the contents of the store. It changes when
+         *        the contents are replaced as a whole, e.g. by a database restore,
+         *        so data cached under another generation must be loaded again
+         **/
+        virtual uint64_t GetGeneration() noexcept = 0;
+
+        /**
+         * @brief Get the names of the wallets
+         **/
+        virtual std::vector<std::string> GetWalletNames() noexcept = 0;
+
+        /**
+         * @brief Get the names and balances of the wallets
+         **/
+        virtual std::vector<std::pair<std::string, Money>>
+        GetWalletBalances() noexcept = 0;
+
+        /**
+         * @brief Check if a wallet exists
+         **/
+        virtual bool WalletExists(const std::string& name) noexcept = 0;
+
+        /**
+         * @brief Get the balance of a wallet
+         * @return The balance, or nothing if the wallet does not exist
+         **/
+        virtual std::optional<Money>
+        GetWalletBalance(const std::string& name) noexcept = 0;
+
+        /**
+         * @brief Add a wallet, which opens with the given balance
+         * @return bool True if the wallet was added
+         **/
+        virtual bool InsertWallet(const std::string& name,
+                                  Money              balance) noexcept = 0;
+
+        /**
+         * @brief Remove a wallet and its daily balances
+         * @return bool True if the wallet was removed
+         **/
+        virtual bool DeleteWallet(const std::string& name) noexcept = 0;
+
+        /**
+         * @brief Set the balance of a wallet
+         * @return bool True if the balance was set
+         **/
+        virtual bool SetWalletBalance(const std::string& name,
+                                      Money              balance) noexcept = 0;
+
+        /**
+         * @brief Add to the balance of a wallet
+         * @return The new balance, or nothing if the wallet does not exist
+         **/
+        virtual std::optional<Money>
+        CreditWallet(const std::string& name, Money amount) noexcept = 0;
+
+        /**
+         * @brief Subtract from the balance of a wallet, if the balance covers it
+         * @return The new balance, or nothing if the wallet does not exist or its
+         *         balance is lower than the amount
+         **/
+        virtual std::optional<Money>
+        DebitWallet(const std::string& name, Money amount) noexcept = 0;
+
+        /**
+         * @brief Apply a change of a wallet on a day to its daily balances
+         *
+         * Adds the day if the wallet did not move on it yet, and patches its
+         * closing balance and the ones of the days after it.
+         *
+         * @param name The wallet name
+         * @param date The day of the change
+         * @param delta The change
+         * @param openingBalance The balance of the wallet before any change its
+         *        daily balances hold. Only used when it has none yet
+         * @return bool True if the daily balances were updated
+         **/
+        virtual bool AddToDailyBalance(const std::string& name,
+                                       const std::string& date,
+                                       Money              delta,
+                                       Money              openingBalance) noexcept = 0;
+
+        /**
+         * @brief Get the balance of a wallet at the end of a day
+         * @return The balance, or nothing if the wallet does not exist
+         **/
+        virtual std::optional<Money>
+        GetBalanceAsOf(const std::string& name, const std::string& date) noexcept = 0;
+
+        /**
+         * @brief Get the closing balance of a wallet on each day it moved, between
+         *        two days inclusive, oldest first
+         **/
+        virtual std::vector<std::pair<std::string, Money>>
+        GetBalanceSeries(const std::string& name,
+                         const std::string& from,
+                         const std::string& to) noexcept = 0;
+
+        /**
+         * @brief Record an expense or income. The balance is not changed
+         **/
+        virtual bool
+        InsertWalletTransaction(const WalletTransactionRecord& record) noexcept = 0;
+
+        /**
+         * @brief Record many expenses and incomes. The balances are not changed
+         * NOTE: The default implementation records them one at a time
+         **/
+        virtual bool InsertWalletTransactions(
+            std::span<const WalletTransactionRecord> records) noexcept;
+
+        /**
+         * @brief Record a transfer. The balances are not changed
+         **/
+        virtual bool InsertTransfer(const TransferRecord& record) noexcept = 0;
+
+        /**
+         * @brief Record many transfers. The balances are not changed
+         * NOTE: The default implementation records them one at a time
+         **/
+        virtual bool InsertTransfers(std::span<const TransferRecord> records) noexcept;
+
+        /**
+         * @brief Get the names of the categories
+         **/
+        virtual std::vector<std::string> GetCategoryNames() noexcept = 0;
+
+        /**
+         * @brief Get the names and ids of the categories
+         **/
+        virtual std::vector<std::pair<std::string, int64_t>>
+        GetCategories() noexcept = 0;
+
+        /**
+         * @brief Get the id of a category
+         * @return The id, or nothing if the category does not exist
+         **/
+        virtual std::optional<int64_t>
+        FindCategory(const std::string& name) noexcept = 0;
+
+        /**
+         * @brief Add a category
+         * @return The id of the new category, or nothing if it was not added
+         **/
+        virtual std::optional<int64_t>
+        InsertCategory(const std::string& name) noexcept = 0;
+
+        /**
+         * @brief Merge a cell into the spending summary
+         * @return bool True if the summary was updated
+         **/
+        virtual bool AddToSpendingSummary(const SpendingCell& cell) noexcept = 0;
+
+        /**
+         * @brief Get the spending summary of the months between two months
+         *        inclusive, ordered by month, category, kind and source
+         * @param fromMonth The first month, as YYYY-MM
+         * @param toMonth The last month, as YYYY-MM
+         **/
+        virtual std::vector<SpendingCell>
+        GetSpendingSummary(const std::string& fromMonth,
+                           const std::string& toMonth) noexcept = 0;
+
+        /**
+         * @brief Compute the spending summary again from the expenses, incomes and
+         *        credit card debts
+         * @return bool True if the summary was rebuilt
+         **/
+        virtual bool RebuildSpendingSummary() noexcept = 0;
+
+        /**
+         * @brief Get the numbers of the credit cards
+         **/
+        virtual std::vector<std::string> GetCreditCardNumbers() noexcept = 0;
+
+        /**
+         * @brief Get a credit card
+         * @return The credit card, or nothing if it does not exist
+         **/
+        virtual std::optional<CreditCardRecord>
+        FindCreditCard(const std::string& number) noexcept = 0;
+
+        /**
+         * @brief Add a credit card
+         **/
+        virtual bool InsertCreditCard(const CreditCardRecord& record) noexcept = 0;
+
+        /**
+         * @brief Add a credit card debt
+         * @return The id of the new debt, or nothing if it was not added
+         **/
+        virtual std::optional<int64_t>
+        InsertCreditCardDebt(const CreditCardDebtRecord& record) noexcept = 0;
+
+        /**
+         * @brief Add an installment of a credit card debt
+         **/
+        virtual bool
+        InsertCreditCardPayment(const CreditCardPaymentRecord& record) noexcept = 0;
+
+        /**
+         * @brief Get the sum of the unpaid installments of a credit card
+         **/
+        virtual Money GetPendingDebt(const std::string& number) noexcept = 0;
+
+        /**
+         * @brief Get the most recent debt of a credit card that has installments
+         * @return The debt, or nothing if the card has none
+         **/
+        virtual std::optional<CreditCardExpense>
+        GetLastCreditCardExpense(const std::string& number) noexcept = 0;
+};
+
+#endif // LEDGER_STORE_H_
@@ -10,6 +10,8 @@
 #ifndef LOG_MANAGER_H_
 #define LOG_MANAGER_H_
 
+#include <memory>
+#include <mutex>
 #include <source_location>
 #include <string>
 
@@ -24,13 +26,27 @@
 class LogManager
 {
     private:
+        // The log files are only opened when the first message is written to them,
+        // so short runs that log nothing do not pay for them
+        std::once_flag                  m_loggerOnce;
         std::shared_ptr<spdlog::logger> m_logger;
+        std::once_flag                  m_slowQueryLoggerOnce;
+        std::shared_ptr<spdlog::logger> m_slowQueryLogger;
 
         /**
          * @brief Default constructor
          **/
         LogManager() noexcept;
 
+        /**
+         * @brief Create a logger that writes to a file
+         * @return std::shared_ptr<spdlog::logger> The logger, or nullptr if the
+         *         file could not be opened
+         **/
+        static std::shared_ptr<spdlog::logger> CreateLogger(const std::string& name,
+                                                            const std::string& path,
+                                                            const std::string& pattern);
+
     public:
         /**
          * @brief Default destructor
@@ -53,6 +69,14 @@ class LogManager
                  spdlog::level::level_enum   level = spdlog::level::info,
                  const std::source_location& location =
                      std::source_location::current()) noexcept;
+
+        /**
+         * @brief Write an entry to the slow query log, kept in its own file next to
+         *        the main log
+         *
+         * @param entry The statement, its parameters, time and plan
+         **/
+        void LogSlowQuery(const std::string& entry) noexcept;
 };
 
 #endif // LOG_MANAGER_H_
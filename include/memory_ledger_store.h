@@ -0,0 +1,258 @@
+/*
+ * Filename: memory_ledger_store.h
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ *
+ * This file contains the declaration of the MemoryLedgerStore class. This class
+ * keeps the ledger in memory, for simulations that must not touch the database.
+ */
+
+#ifndef MEMORY_LEDGER_STORE_H_
+#define MEMORY_LEDGER_STORE_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ledger_store.h"
+
+/**
+ * @brief Ledger stored in memory
+ *
+ * Every table is a contiguous vector in insertion order, and names are indexed
+ * by hash maps that point into the vectors. Category and debt ids are the
+ * position in their vector plus one, as the database would assign them.
+ *
+ * While a transaction is open, every write pushes the action that undoes it
+ * onto an undo log. Rolling back a transaction runs the actions pushed since it
+ * began, newest first. The log is cleared when the outermost transaction
+ * commits, and the actions added with AfterCommit run then. An open transaction
+ * holds the store lock, as the database holds the writer, so other threads wait
+ * for it to finish.
+ *
+ * Enqueue runs the operation right away in its own transaction.
+ *
+ * The whole ledger can be copied to another store, such as the database, with
+ * PersistTo.
+ **/
+class MemoryLedgerStore : public LedgerStore
+{
+    private:
+        /**
+         * @brief Transaction on the undo log
+         **/
+        class MemoryScope : public Scope
+        {
+            private:
+                MemoryLedgerStore&                     m_store;
+                std::unique_lock<std::recursive_mutex> m_lock;
+                std::size_t                            m_mark;
+                bool                                   m_active;
+
+            public:
+                explicit MemoryScope(MemoryLedgerStore& store) noexcept;
+
+                /**
+                 * @brief Roll back the writes if the scope was not committed
+                 **/
+                ~MemoryScope() noexcept override;
+
+                bool Commit() noexcept override;
+                void Rollback() noexcept override;
+                bool IsActive() const noexcept override;
+        };
+
+        struct Wallet
+        {
+                std::string name;
+                Money       balance;
+                Money       openingBalance;
+        };
+
+        struct Debt
+        {
+                CreditCardDebtRecord record;
+                uint16_t             installments;
+        };
+
+        struct DailyBalance
+        {
+                Money delta;
+                Money balance;
+        };
+
+        using Index = std::unordered_map<std::string, std::size_t>;
+
+        // Days of a wallet, ordered by date
+        using DailyBalances = std::map<std::string, DailyBalance>;
+
+        // Cells of the spending summary by month, category, kind and source
+        using SpendingKey = std::tuple<std::string, int64_t, std::string, std::string>;
+        using SpendingSummary = std::map<SpendingKey, SpendingCell>;
+
+        std::recursive_mutex m_mutex;
+
+        std::vector<Wallet>                  m_wallets;
+        Index                                m_walletIndex;
+        std::vector<WalletTransactionRecord> m_walletTransactions;
+        std::vector<TransferRecord>          m_transfers;
+        std::vector<std::string>             m_categories;
+        Index                                m_categoryIndex;
+        std::vector<CreditCardRecord>        m_creditCards;
+        Index                                m_creditCardIndex;
+        std::vector<Debt>                    m_debts;
+        std::vector<CreditCardPaymentRecord> m_payments;
+
+        // Debts of each credit card, oldest first, and the sum of the installments
+        // not paid yet
+        std::unordered_map<std::string, std::vector<std::size_t>> m_cardDebts;
+        std::unordered_map<std::string, Money>                    m_pendingDebt;
+
+        std::unordered_map<std::string, DailyBalances> m_dailyBalances;
+        SpendingSummary                                m_spending;
+
+        std::vector<std::function<void()>> m_undoLog;
+        uint32_t                           m_depth;
+
+        // Actions waiting for the outermost commit, with the depth they belong to
+        std::vector<std::pair<uint32_t, std::function<void()>>> m_commitActions;
+
+    public:
+        MemoryLedgerStore() noexcept;
+
+        /**
+         * @brief Copy the whole ledger to another store in a single transaction
+         *
+         * Category and debt ids are assigned again by the target. Categories the
+         * target already has are reused. Nothing is copied if any write fails,
+         * including when a wallet or credit card already exists in the target.
+         *
+         * @param target The store to copy to
+         * @return bool True if everything was copied
+         **/
+        bool PersistTo(LedgerStore& target) noexcept;
+
+        std::unique_ptr<Scope> BeginTransaction() noexcept override;
+
+        std::future<bool> Enqueue(std::function<bool()> operation) noexcept override;
+
+        void AfterCommit(std::function<void()> action) noexcept override;
+
+        /**
+         * @brief The contents are never replaced as a whole, so the generation is
+         *        always zero
+         **/
+        uint64_t GetGeneration() noexcept override;
+
+        std::vector<std::string> GetWalletNames() noexcept override;
+
+        std::vector<std::pair<std::string, Money>>
+        GetWalletBalances() noexcept override;
+
+        bool WalletExists(const std::string& name) noexcept override;
+
+        std::optional<Money>
+        GetWalletBalance(const std::string& name) noexcept override;
+
+        bool InsertWallet(const std::string& name, Money balance) noexcept override;
+
+        bool DeleteWallet(const std::string& name) noexcept override;
+
+        bool SetWalletBalance(const std::string& name,
+                              Money              balance) noexcept override;
+
+        std::optional<Money>
+        CreditWallet(const std::string& name, Money amount) noexcept override;
+
+        std::optional<Money>
+        DebitWallet(const std::string& name, Money amount) noexcept override;
+
+        bool AddToDailyBalance(const std::string& name,
+                               const std::string& date,
+                               Money              delta,
+                               Money              openingBalance) noexcept override;
+
+        std::optional<Money>
+        GetBalanceAsOf(const std::string& name,
+                       const std::string& date) noexcept override;
+
+        std::vector<std::pair<std::string, Money>>
+        GetBalanceSeries(const std::string& name,
+                         const std::string& from,
+                         const std::string& to) noexcept override;
+
+        bool InsertWalletTransaction(
+            const WalletTransactionRecord& record) noexcept override;
+
+        bool InsertTransfer(const TransferRecord& record) noexcept override;
+
+        std::vector<std::string> GetCategoryNames() noexcept override;
+
+        std::vector<std::pair<std::string, int64_t>> GetCategories() noexcept override;
+
+        std::optional<int64_t> FindCategory(const std::string& name) noexcept override;
+
+        std::optional<int64_t>
+        InsertCategory(const std::string& name) noexcept override;
+
+        bool AddToSpendingSummary(const SpendingCell& cell) noexcept override;
+
+        std::vector<SpendingCell>
+        GetSpendingSummary(const std::string& fromMonth,
+                           const std::string& toMonth) noexcept override;
+
+        bool RebuildSpendingSummary() noexcept override;
+
+        std::vector<std::string> GetCreditCardNumbers() noexcept override;
+
+        std::optional<CreditCardRecord>
+        FindCreditCard(const std::string& number) noexcept override;
+
+        bool InsertCreditCard(const CreditCardRecord& record) noexcept override;
+
+        std::optional<int64_t>
+        InsertCreditCardDebt(const CreditCardDebtRecord& record) noexcept override;
+
+        bool InsertCreditCardPayment(
+            const CreditCardPaymentRecord& record) noexcept override;
+
+        Money GetPendingDebt(const std::string& number) noexcept override;
+
+        std::optional<CreditCardExpense>
+        GetLastCreditCardExpense(const std::string& number) noexcept override;
+
+    private:
+        /**
+         * @brief Record how to undo a write, if a transaction is open
+         **/
+        void PushUndo(std::function<void()> undo) noexcept;
+
+        /**
+         * @brief Undo the writes recorded after a mark of the undo log
+         **/
+        void UndoTo(std::size_t mark) noexcept;
+
+        /**
+         * @brief Point the index of the wallets at or after a position to it
+         **/
+        void ReindexWallets(std::size_t from) noexcept;
+
+        /**
+         * @brief Merge a cell into the spending summary, without recording how to
+         *        undo it
+         **/
+        void MergeSpending(const SpendingCell& cell) noexcept;
+};
+
+#endif // MEMORY_LEDGER_STORE_H_
@@ -0,0 +1,159 @@
+/*
+ * Filename: money.h
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ *
+ * This file contains the declaration of the Money class and of the kernels that
+ * aggregate contiguous arrays of amounts in cents.
+ */
+
+#ifndef MONEY_H_
+#define MONEY_H_
+
+#include <cmath>
+#include <compare>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Amount of money as a whole number of cents
+ *
+ * Amounts given as double_t are rounded to the nearest cent once, when they are
+ * converted, so sums and splits of Money are exact.
+ **/
+class Money
+{
+    private:
+        int64_t m_cents;
+
+    public:
+        static constexpr int64_t CENTS_PER_UNIT = 100;
+
+        /**
+         * @brief Zero
+         **/
+        constexpr Money() noexcept
+            : m_cents(0)
+        { }
+
+        /**
+         * @brief Convert an amount, rounded to the nearest cent
+         **/
+        explicit Money(double_t amount) noexcept
+            : m_cents(std::llround(amount * CENTS_PER_UNIT))
+        { }
+
+        /**
+         * @brief Get the amount of a number of cents
+         **/
+        static constexpr Money FromCents(int64_t cents) noexcept
+        {
+            Money money;
+            money.m_cents = cents;
+            return money;
+        }
+
+        /**
+         * @brief Get the number of cents
+         **/
+        constexpr int64_t Cents() const noexcept
+        {
+            return this->m_cents;
+        }
+
+        /**
+         * @brief Get the amount as a double_t, the closest one to the cents
+         **/
+        double_t ToDouble() const noexcept
+        {
+            return static_cast<double_t>(this->m_cents) / CENTS_PER_UNIT;
+        }
+
+        /**
+         * @brief Format the amount with two decimals, e.g. -12.05
+         **/
+        std::string ToString() const;
+
+        /**
+         * @brief Split the amount in parts that differ by at most one cent and add
+         *        up to the amount. The first parts get the cents left over
+         * @param parts The number of parts, at least one
+         **/
+        std::vector<Money> Split(uint16_t parts) const;
+
+        constexpr bool IsPositive() const noexcept
+        {
+            return this->m_cents > 0;
+        }
+
+        constexpr Money operator-() const noexcept
+        {
+            return FromCents(-this->m_cents);
+        }
+
+        constexpr Money& operator+=(Money other) noexcept
+        {
+            this->m_cents += other.m_cents;
+            return *this;
+        }
+
+        constexpr Money& operator-=(Money other) noexcept
+        {
+            this->m_cents -= other.m_cents;
+            return *this;
+        }
+
+        friend constexpr Money operator+(Money a, Money b) noexcept
+        {
+            return a += b;
+        }
+
+        friend constexpr Money operator-(Money a, Money b) noexcept
+        {
+            return a -= b;
+        }
+
+        friend constexpr bool operator==(Money a, Money b) noexcept = default;
+
+        friend constexpr std::strong_ordering operator<=>(Money a,
+                                                          Money b) noexcept = default;
+};
+
+/**
+ * @brief Kernels over contiguous arrays of cents, for the report paths
+ *
+ * The loops keep several independent accumulators and no data dependent
+ * branches. Sum and MinMax are turned into vector instructions by the compiler,
+ * while GroupedSum scatters into one copy of the sums per accumulator.
+ **/
+namespace money
+{
+    /**
+     * @brief Sum an array of cents
+     **/
+    int64_t Sum(std::span<const int64_t> cents) noexcept;
+
+    /**
+     * @brief Sum an array of cents by group
+     * @param cents The amounts
+     * @param groups The group of each amount, which must be lower than
+     *               sums.size()
+     * @param sums Incremented by the amounts of each group
+     **/
+    void GroupedSum(std::span<const int64_t>  cents,
+                    std::span<const uint32_t> groups,
+                    std::span<int64_t>        sums) noexcept;
+
+    /**
+     * @brief Get the lowest and highest of an array of cents
+     * @return The lowest and highest, or nothing if the array is empty
+     **/
+    std::optional<std::pair<int64_t, int64_t>>
+    MinMax(std::span<const int64_t> cents) noexcept;
+} // namespace money
+
+#endif // MONEY_H_
@@ -0,0 +1,206 @@
+/*
+ * Filename: query_profiler.h
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ *
+ * This file contains the declaration of the QueryProfiler class. This class keeps
+ * latency and row counters for every statement run on the database connections.
+ */
+
+#ifndef QUERY_PROFILER_H_
+#define QUERY_PROFILER_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <sqlite3.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "slow_query_log.h"
+
+/**
+ * @brief Latency histogram with buckets of bounded relative width
+ *
+ * Values below 16 have a bucket each. Every power of two above that is split in
+ * 16 buckets, so a percentile is reported with an error below 1/16 of its value
+ * while the whole 64-bit range fits in under a thousand counters. Recording is
+ * lock-free.
+ **/
+class LatencyHistogram
+{
+    private:
+        static constexpr uint32_t    SUB_BUCKET_BITS  = 4;
+        static constexpr uint64_t    SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+        static constexpr std::size_t BUCKET_COUNT =
+            SUB_BUCKET_COUNT * (64 - SUB_BUCKET_BITS + 1);
+
+        std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets;
+        std::atomic<uint64_t>                           m_count;
+        std::atomic<uint64_t>                           m_max;
+
+    public:
+        LatencyHistogram() noexcept;
+
+        LatencyHistogram(const LatencyHistogram&)            = delete;
+        LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+        /**
+         * @brief Record a value
+         **/
+        void Record(uint64_t value) noexcept;
+
+        /**
+         * @brief Get the number of values recorded
+         **/
+        uint64_t GetCount() const noexcept;
+
+        /**
+         * @brief Get the largest value recorded
+         **/
+        uint64_t GetMax() const noexcept;
+
+        /**
+         * @brief Get the value below which the given fraction of the values fall
+         * @param percentile Fraction between 0 and 1, e.g. 0.99
+         * @return uint64_t Upper bound of the bucket holding the percentile, or 0 if
+         *         no value was recorded
+         **/
+        uint64_t GetPercentile(double percentile) const noexcept;
+
+    private:
+        /**
+         * @brief Get the index of the bucket that holds a value
+         **/
+        static std::size_t BucketIndex(uint64_t value) noexcept;
+
+        /**
+         * @brief Get the largest value that falls in a bucket
+         **/
+        static uint64_t BucketUpperBound(std::size_t index) noexcept;
+};
+
+/**
+ * @brief Per-statement profiler fed by sqlite3_trace_v2
+ *
+ * Statements are grouped by their SQL text before parameter expansion, so every
+ * run of the same query template adds to the same counters, keyed by the text
+ * SQLite reports, which has no terminating semicolon. The latency of a run is
+ * measured from its first step to its last one, or to its reset.
+ **/
+class QueryProfiler
+{
+    public:
+        /**
+         * @brief Counters of a statement template
+         **/
+        struct Stats
+        {
+                std::string              sql;
+                uint64_t                 calls = 0;
+                uint64_t                 rows  = 0;
+                std::chrono::nanoseconds total{ 0 };
+                std::chrono::nanoseconds p50{ 0 };
+                std::chrono::nanoseconds p95{ 0 };
+                std::chrono::nanoseconds p99{ 0 };
+                std::chrono::nanoseconds max{ 0 };
+        };
+
+    private:
+        struct Entry
+        {
+                std::atomic<uint64_t> calls{ 0 };
+                std::atomic<uint64_t> rows{ 0 };
+                std::atomic<uint64_t> totalNs{ 0 };
+                LatencyHistogram      latency;
+        };
+
+        // A statement run in progress on the current thread
+        struct Run
+        {
+                sqlite3_stmt*                         stmt;
+                std::chrono::steady_clock::time_point start;
+                uint64_t                              rows;
+        };
+
+        // Allows looking up entries by the SQL text without building a string
+        struct SqlHash
+        {
+                using is_transparent = void;
+
+                std::size_t operator()(std::string_view sql) const noexcept
+                {
+                    return std::hash<std::string_view>()(sql);
+                }
+        };
+
+        using EntryMap = std::unordered_map<std::string,
+                                            std::unique_ptr<Entry>,
+                                            SqlHash,
+                                            std::equal_to<>>;
+
+        mutable std::shared_mutex m_mutex;
+        EntryMap                  m_entries;
+        SlowQueryLog*             m_slowQueryLog = nullptr;
+
+    public:
+        QueryProfiler() noexcept = default;
+
+        QueryProfiler(const QueryProfiler&)            = delete;
+        QueryProfiler& operator=(const QueryProfiler&) = delete;
+
+        /**
+         * @brief Send the statement runs slower than its threshold to a slow query
+         *        log
+         * @param slowQueryLog The log, or nullptr to stop sending runs
+         * NOTE: Must be set before any connection is attached
+         **/
+        void SetSlowQueryLog(SlowQueryLog* slowQueryLog) noexcept;
+
+        /**
+         * @brief Start profiling the statements run on a connection
+         * NOTE: The profiler must outlive the connection
+         **/
+        void Attach(sqlite3* db) noexcept;
+
+        /**
+         * @brief Record a finished run of a statement
+         * @param sql SQL text of the statement template
+         * @param elapsed Time taken by the run
+         * @param rows Number of rows returned by the run
+         **/
+        void Record(std::string_view         sql,
+                    std::chrono::nanoseconds elapsed,
+                    uint64_t                 rows) noexcept;
+
+        /**
+         * @brief Get the counters of every statement template
+         * @return std::vector<Stats> Counters sorted by total time, largest first
+         **/
+        std::vector<Stats> GetStats() const;
+
+        /**
+         * @brief Discard all counters
+         **/
+        void Reset() noexcept;
+
+        /**
+         * @brief Format the counters as a table, one statement template per line
+         **/
+        std::string Report() const;
+
+    private:
+        /**
+         * @brief Callback registered with sqlite3_trace_v2
+         **/
+        static int Trace(unsigned type, void* context, void* p, void* x) noexcept;
+};
+
+#endif // QUERY_PROFILER_H_
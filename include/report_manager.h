@@ -0,0 +1,96 @@
+/*
+ * Filename: report_manager.h
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ *
+ * This file contains the declaration of the ReportManager class. This class is
+ * responsible for the reports of where the money came from and went to.
+ */
+
+#ifndef REPORT_MANAGER_H_
+#define REPORT_MANAGER_H_
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db_manager.h"
+#include "ledger_store.h"
+#include "log_manager.h"
+
+/**
+ * @brief The ReportManager class is responsible for the reports of spending by
+ * month, category and wallet or credit card.
+ *
+ * The reports read the spending summary of the store, which WalletManager,
+ * CreditCardManager and BulkImporter keep up to date as they write, so a report
+ * reads one cell per month, category and source instead of every transaction.
+ * NOTE: Call RebuildSpendingSummary after changing expenses, incomes or credit
+ *       card debts without the managers
+ **/
+class ReportManager
+{
+    private:
+        LogManager&                  m_logManager;
+        std::unique_ptr<LedgerStore> m_ownedStore;
+        LedgerStore&                 m_store;
+
+    public:
+        /**
+         * @brief Default constructor
+         **/
+        ReportManager() noexcept;
+
+        /**
+         * @brief Constructor
+         * @param dbManager The database the ledger is stored in
+         **/
+        explicit ReportManager(DBManager& dbManager) noexcept;
+
+        /**
+         * @brief Constructor
+         * @param store The store the ledger is kept in
+         **/
+        explicit ReportManager(LedgerStore& store) noexcept;
+
+        /**
+         * @brief Default destructor
+         **/
+        ~ReportManager() noexcept;
+
+        /**
+         * @brief Get the spending summary of a period
+         * @param fromMonth The first month, as YYYY-MM
+         * @param toMonth The last month, as YYYY-MM
+         * @param cells The vector to store the cells, ordered by month, category,
+         *        kind and source
+         * NOTE: All data stored in the vector will be lost
+         **/
+        void GetSpendingSummary(const std::string&         fromMonth,
+                                const std::string&         toMonth,
+                                std::vector<SpendingCell>& cells) noexcept;
+
+        /**
+         * @brief Get how much was spent on each category in a period, with
+         *        expenses and credit card debts, highest first
+         * @param fromMonth The first month, as YYYY-MM
+         * @param toMonth The last month, as YYYY-MM
+         * @param categories The vector to store the category names
+         * @param totals The vector to store the amounts spent
+         * NOTE: All data stored in the vectors will be lost
+         **/
+        void GetSpendingByCategory(const std::string&        fromMonth,
+                                   const std::string&        toMonth,
+                                   std::vector<std::string>& categories,
+                                   std::vector<Money>&       totals) noexcept;
+
+        /**
+         * @brief Compute the spending summary again from the expenses, incomes and
+         *        credit card debts
+         * @return True if the summary was rebuilt, false otherwise
+         **/
+        bool RebuildSpendingSummary() noexcept;
+};
+
+#endif // REPORT_MANAGER_H_
@@ -0,0 +1,209 @@
+/*
+ * Filename: row_decoder.h
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ *
+ * This file contains the templates that decode the columns of a result row into
+ * typed values. The decoding is resolved at compile time, so no type-erased call
+ * is made per row or per column.
+ */
+
+#ifndef ROW_DECODER_H_
+#define ROW_DECODER_H_
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <sqlite3.h>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "money.h"
+
+/**
+ * @brief Decoder of a single column value
+ *
+ * Supported types are integers, bool, floating point numbers, Money, std::string,
+ * std::string_view and std::optional of any of those, which is empty when the
+ * column is NULL. Money is read from a column of cents.
+ *
+ * A std::string_view borrows the text owned by the statement. It is only valid
+ * until the statement is stepped again.
+ **/
+template<typename T>
+struct ColumnDecoder;
+
+template<std::integral T>
+struct ColumnDecoder<T>
+{
+        static constexpr bool borrows = false;
+
+        static T Decode(sqlite3_stmt* stmt, int column) noexcept
+        {
+            return static_cast<T>(sqlite3_column_int64(stmt, column));
+        }
+};
+
+template<std::floating_point T>
+struct ColumnDecoder<T>
+{
+        static constexpr bool borrows = false;
+
+        static T Decode(sqlite3_stmt* stmt, int column) noexcept
+        {
+            return static_cast<T>(sqlite3_column_double(stmt, column));
+        }
+};
+
+template<>
+struct ColumnDecoder<Money>
+{
+        static constexpr bool borrows = false;
+
+        static Money Decode(sqlite3_stmt* stmt, int column) noexcept
+        {
+            return Money::FromCents(sqlite3_column_int64(stmt, column));
+        }
+};
+
+template<>
+struct ColumnDecoder<std::string_view>
+{
+        static constexpr bool borrows = true;
+
+        static std::string_view Decode(sqlite3_stmt* stmt, int column) noexcept
+        {
+            // The text must be fetched before its size, since fetching it may
+            // convert the value
+            const unsigned char* text  = sqlite3_column_text(stmt, column);
+            int                  bytes = sqlite3_column_bytes(stmt, column);
+
+            if (not text)
+            {
+                return std::string_view();
+            }
+
+            return std::string_view(reinterpret_cast<const char*>(text),
+                                    static_cast<std::size_t>(bytes));
+        }
+};
+
+template<>
+struct ColumnDecoder<std::string>
+{
+        static constexpr bool borrows = false;
+
+        static std::string Decode(sqlite3_stmt* stmt, int column)
+        {
+            return std::string(ColumnDecoder<std::string_view>::Decode(stmt, column));
+        }
+};
+
+template<typename T>
+struct ColumnDecoder<std::optional<T>>
+{
+        static constexpr bool borrows = ColumnDecoder<T>::borrows;
+
+        static std::optional<T> Decode(sqlite3_stmt* stmt, int column)
+        {
+            if (sqlite3_column_type(stmt, column) == SQLITE_NULL)
+            {
+                return std::nullopt;
+            }
+
+            return ColumnDecoder<T>::Decode(stmt, column);
+        }
+};
+
+/**
+ * @brief Structs mapped from a row declare the type of each column, in the order
+ *        of the struct members, e.g.
+ *
+ *        struct WalletRow
+ *        {
+ *            std::string name;
+ *            double_t    balance;
+ *
+ *            using Columns = std::tuple<std::string, double_t>;
+ *        };
+ **/
+template<typename Row>
+concept MappedRow = requires { typename Row::Columns; };
+
+/**
+ * @brief Decoder of a whole row
+ *
+ * A row is either a std::tuple with one element per column, a struct that
+ * satisfies MappedRow, or a single column type for queries that return one
+ * column.
+ **/
+template<typename Row>
+struct RowDecoder
+{
+        static constexpr bool borrows = ColumnDecoder<Row>::borrows;
+
+        static Row Decode(sqlite3_stmt* stmt)
+        {
+            return ColumnDecoder<Row>::Decode(stmt, 0);
+        }
+};
+
+template<typename... Ts>
+struct RowDecoder<std::tuple<Ts...>>
+{
+        static constexpr bool borrows = (ColumnDecoder<Ts>::borrows or ...);
+
+        static std::tuple<Ts...> Decode(sqlite3_stmt* stmt)
+        {
+            return DecodeColumns(stmt, std::index_sequence_for<Ts...>());
+        }
+
+    private:
+        template<std::size_t... I>
+        static std::tuple<Ts...> DecodeColumns(sqlite3_stmt* stmt,
+                                               std::index_sequence<I...>)
+        {
+            // Braced initialization keeps the columns decoded in order
+            return std::tuple<Ts...>{
+                ColumnDecoder<Ts>::Decode(stmt, static_cast<int>(I))...
+            };
+        }
+};
+
+template<MappedRow Row>
+struct RowDecoder<Row>
+{
+        static constexpr bool borrows = RowDecoder<typename Row::Columns>::borrows;
+
+        static Row Decode(sqlite3_stmt* stmt)
+        {
+            using Columns = typename Row::Columns;
+
+            return DecodeColumns(
+                stmt,
+                std::make_index_sequence<std::tuple_size_v<Columns>>());
+        }
+
+    private:
+        template<std::size_t... I>
+        static Row DecodeColumns(sqlite3_stmt* stmt, std::index_sequence<I...>)
+        {
+            using Columns = typename Row::Columns;
+
+            return Row{ ColumnDecoder<std::tuple_element_t<I, Columns>>::Decode(
+                stmt,
+                static_cast<int>(I))... };
+        }
+};
+
+/**
+ * @brief Check if a row holds values borrowed from the statement
+ **/
+template<typename Row>
+concept BorrowedRow = RowDecoder<Row>::borrows;
+
+#endif // ROW_DECODER_H_
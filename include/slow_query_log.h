@@ -0,0 +1,107 @@
+/*
+ * Filename: slow_query_log.h
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ *
+ * This file contains the declaration of the SlowQueryLog class. This class writes
+ * the statements that exceed a time threshold, with their query plans, to a
+ * dedicated log.
+ */
+
+#ifndef SLOW_QUERY_LOG_H_
+#define SLOW_QUERY_LOG_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <sqlite3.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "log_manager.h"
+
+/**
+ * @brief Journal of the statements slower than a threshold
+ *
+ * Each entry has the statement with its bound parameters, the time it took and
+ * the output of EXPLAIN QUERY PLAN. The plan is captured once per statement
+ * template, on a read-only connection of its own, since the connection that ran
+ * the statement is still inside a call to SQLite when the entry is written.
+ **/
+class SlowQueryLog
+{
+    private:
+        LogManager&           m_logger;
+        std::atomic<int64_t>  m_thresholdNs;
+        std::atomic<uint64_t> m_count;
+
+        // Guards the connection used to explain the statements and the plans
+        std::mutex                                   m_mutex;
+        sqlite3*                                     m_explainDb;
+        std::unordered_map<std::string, std::string> m_plans;
+
+    public:
+        /**
+         * @brief Constructor
+         * @param logger The logger whose slow query sink receives the entries
+         * @param threshold Statements that take longer than this are logged
+         **/
+        SlowQueryLog(LogManager& logger, std::chrono::nanoseconds threshold) noexcept;
+
+        /**
+         * @brief Destructor. Closes the connection used to explain statements
+         **/
+        ~SlowQueryLog() noexcept;
+
+        SlowQueryLog(const SlowQueryLog&)            = delete;
+        SlowQueryLog& operator=(const SlowQueryLog&) = delete;
+
+        /**
+         * @brief Set the time above which a statement is logged
+         **/
+        void SetThreshold(std::chrono::nanoseconds threshold) noexcept;
+
+        /**
+         * @brief Get the time above which a statement is logged
+         **/
+        std::chrono::nanoseconds GetThreshold() const noexcept;
+
+        /**
+         * @brief Check if a run that took the given time must be logged
+         **/
+        bool IsSlow(std::chrono::nanoseconds elapsed) const noexcept;
+
+        /**
+         * @brief Write an entry for a statement run
+         * @param stmt The statement, with its parameters still bound
+         * @param elapsed Time taken by the run
+         **/
+        void Record(sqlite3_stmt* stmt, std::chrono::nanoseconds elapsed) noexcept;
+
+        /**
+         * @brief Get the number of entries written
+         **/
+        uint64_t GetCount() const noexcept;
+
+        /**
+         * @brief Get the plan captured for a statement template
+         * @param sql SQL text of the template, without the terminating semicolon
+         * @return std::string The plan, or an empty string if none was captured
+         **/
+        std::string GetPlan(std::string_view sql) noexcept;
+
+    private:
+        /**
+         * @brief Run EXPLAIN QUERY PLAN for a statement template
+         * @param path Path of the database the statement runs on
+         * @param sql SQL text of the template
+         * @return std::string The plan, one line per step, each starting with a
+         *         line break and indented by its depth
+         * NOTE: m_mutex must be held by the caller
+         **/
+        std::string Explain(const char* path, const std::string& sql);
+};
+
+#endif // SLOW_QUERY_LOG_H_
@@ -0,0 +1,184 @@
+/*
+ * Filename: sqlite_ledger_store.h
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ *
+ * This file contains the declaration of the SqliteLedgerStore class. This class
+ * keeps the ledger in the database.
+ */
+
+#ifndef SQLITE_LEDGER_STORE_H_
+#define SQLITE_LEDGER_STORE_H_
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "config.h"
+#include "db_manager.h"
+#include "ledger_store.h"
+#include "money.h"
+
+/**
+ * @brief Ledger stored in the database
+ *
+ * Transactions map to DBManager transactions and Enqueue to the background
+ * writer of the database.
+ *
+ * The balance of a wallet is kept in its row, unless an AppendOnlyLedgerStore
+ * moved the wallet to the ledger. Balances of those wallets are read from the
+ * ledger and changed by appending entries to it, so both stores can share the
+ * same database.
+ **/
+class SqliteLedgerStore : public LedgerStore
+{
+    private:
+        /**
+         * @brief Scope of a DBManager transaction
+         **/
+        class SqliteScope : public Scope
+        {
+            private:
+                DBManager::Transaction m_transaction;
+
+            public:
+                explicit SqliteScope(DBManager& db) noexcept;
+
+                bool Commit() noexcept override;
+                void Rollback() noexcept override;
+                bool IsActive() const noexcept override;
+        };
+
+    protected:
+        DBManager& m_dbManager;
+        uint32_t   m_checkpointInterval;
+
+    public:
+        /**
+         * @brief Constructor
+         * @param dbManager The database the ledger is stored in
+         * @param checkpointInterval The number of ledger entries between
+         *        checkpoints of the wallets kept in the ledger
+         **/
+        explicit SqliteLedgerStore(DBManager& dbManager,
+                                   uint32_t   checkpointInterval =
+                                       config::LEDGER_CHECKPOINT_INTERVAL) noexcept;
+
+        std::unique_ptr<Scope> BeginTransaction() noexcept override;
+
+        std::future<bool> Enqueue(std::function<bool()> operation) noexcept override;
+
+        void AfterCommit(std::function<void()> action) noexcept override;
+
+        uint64_t GetGeneration() noexcept override;
+
+        std::vector<std::string> GetWalletNames() noexcept override;
+
+        std::vector<std::pair<std::string, Money>>
+        GetWalletBalances() noexcept override;
+
+        bool WalletExists(const std::string& name) noexcept override;
+
+        std::optional<Money>
+        GetWalletBalance(const std::string& name) noexcept override;
+
+        bool InsertWallet(const std::string& name, Money balance) noexcept override;
+
+        bool DeleteWallet(const std::string& name) noexcept override;
+
+        bool SetWalletBalance(const std::string& name,
+                              Money              balance) noexcept override;
+
+        std::optional<Money>
+        CreditWallet(const std::string& name, Money amount) noexcept override;
+
+        std::optional<Money>
+        DebitWallet(const std::string& name, Money amount) noexcept override;
+
+        bool AddToDailyBalance(const std::string& name,
+                               const std::string& date,
+                               Money              delta,
+                               Money              openingBalance) noexcept override;
+
+        std::optional<Money>
+        GetBalanceAsOf(const std::string& name,
+                       const std::string& date) noexcept override;
+
+        std::vector<std::pair<std::string, Money>>
+        GetBalanceSeries(const std::string& name,
+                         const std::string& from,
+                         const std::string& to) noexcept override;
+
+        bool InsertWalletTransaction(
+            const WalletTransactionRecord& record) noexcept override;
+
+        bool InsertWalletTransactions(
+            std::span<const WalletTransactionRecord> records) noexcept override;
+
+        bool InsertTransfer(const TransferRecord& record) noexcept override;
+
+        bool InsertTransfers(std::span<const TransferRecord> records) noexcept override;
+
+        std::vector<std::string> GetCategoryNames() noexcept override;
+
+        std::vector<std::pair<std::string, int64_t>> GetCategories() noexcept override;
+
+        std::optional<int64_t> FindCategory(const std::string& name) noexcept override;
+
+        std::optional<int64_t>
+        InsertCategory(const std::string& name) noexcept override;
+
+        bool AddToSpendingSummary(const SpendingCell& cell) noexcept override;
+
+        std::vector<SpendingCell>
+        GetSpendingSummary(const std::string& fromMonth,
+                           const std::string& toMonth) noexcept override;
+
+        bool RebuildSpendingSummary() noexcept override;
+
+        std::vector<std::string> GetCreditCardNumbers() noexcept override;
+
+        std::optional<CreditCardRecord>
+        FindCreditCard(const std::string& number) noexcept override;
+
+        bool InsertCreditCard(const CreditCardRecord& record) noexcept override;
+
+        std::optional<int64_t>
+        InsertCreditCardDebt(const CreditCardDebtRecord& record) noexcept override;
+
+        bool InsertCreditCardPayment(
+            const CreditCardPaymentRecord& record) noexcept override;
+
+        Money GetPendingDebt(const std::string& number) noexcept override;
+
+        std::optional<CreditCardExpense>
+        GetLastCreditCardExpense(const std::string& number) noexcept override;
+
+    protected:
+        /**
+         * @brief Check if a wallet is kept in the ledger
+         **/
+        bool IsInLedger(const std::string& name) noexcept;
+
+        /**
+         * @brief Append a change to the ledger of a wallet, and checkpoint the
+         *        balance when due
+         * @param allowNegative False to refuse a change that leaves the balance
+         *        negative
+         * @return The new balance, or nothing if the wallet is not kept in the
+         *         ledger or the change was refused
+         **/
+        std::optional<Money>
+        AppendToLedger(const std::string& name,
+                       Money              change,
+                       bool               allowNegative = true) noexcept;
+};
+
+#endif // SQLITE_LEDGER_STORE_H_
@@ -0,0 +1,178 @@
+/*
+ * Filename: statement_cache.h
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ *
+ * This file contains the declaration of the StatementCache class. This class keeps
+ * a bounded LRU cache of prepared statements for a single database connection.
+ */
+
+#ifndef STATEMENT_CACHE_H_
+#define STATEMENT_CACHE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <sqlite3.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief Bounded LRU cache of prepared statements keyed by normalized SQL text
+ *
+ * A cache belongs to a single connection and, like the connection, must only be
+ * used by one thread at a time.
+ *
+ * Statements are checked out through a Lease. While leased, a statement is removed
+ * from the cache, so a query issued from inside a row callback never steps a
+ * statement that is already running. When the lease is released the statement is
+ * reset, its bindings are cleared and it becomes the most recently used entry.
+ **/
+class StatementCache
+{
+    public:
+        /**
+         * @brief Counters describing the cache usage
+         **/
+        struct Stats
+        {
+                uint64_t    hits      = 0;
+                uint64_t    misses    = 0;
+                uint64_t    evictions = 0;
+                std::size_t size      = 0;
+                std::size_t capacity  = 0;
+        };
+
+        /**
+         * @brief RAII handle to a statement checked out from the cache
+         **/
+        class Lease
+        {
+            private:
+                StatementCache* m_cache;
+                std::string     m_key;
+                sqlite3_stmt*   m_stmt;
+                bool            m_hasTail;
+
+                friend class StatementCache;
+
+                Lease(StatementCache* cache,
+                      std::string     key,
+                      sqlite3_stmt*   stmt,
+                      bool            hasTail) noexcept;
+
+            public:
+                /**
+                 * @brief Construct an empty lease
+                 **/
+                Lease() noexcept;
+
+                Lease(Lease&& other) noexcept;
+                Lease& operator=(Lease&& other) noexcept;
+
+                Lease(const Lease&)            = delete;
+                Lease& operator=(const Lease&) = delete;
+
+                /**
+                 * @brief Return the statement to the cache
+                 **/
+                ~Lease() noexcept;
+
+                /**
+                 * @brief Get the leased statement
+                 * @return The statement, or nullptr if it could not be prepared
+                 **/
+                sqlite3_stmt* Get() const noexcept;
+
+                /**
+                 * @brief Check if the SQL text had more than one statement
+                 * NOTE: The lease is empty in that case
+                 **/
+                bool HasTail() const noexcept;
+
+                explicit operator bool() const noexcept;
+        };
+
+    private:
+        struct Entry
+        {
+                std::string   key;
+                sqlite3_stmt* stmt;
+        };
+
+        sqlite3*                                                    m_db;
+        std::size_t                                                 m_capacity;
+        std::list<Entry>                                            m_lru;
+        std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+
+        // Counters are atomic so they can be read while another thread uses the
+        // connection
+        std::atomic<uint64_t>    m_hits;
+        std::atomic<uint64_t>    m_misses;
+        std::atomic<uint64_t>    m_evictions;
+        std::atomic<std::size_t> m_size;
+
+    public:
+        /**
+         * @brief Constructor
+         * @param db The connection the statements are prepared on
+         * @param capacity Maximum number of idle statements kept in the cache
+         **/
+        StatementCache(sqlite3* db, std::size_t capacity) noexcept;
+
+        /**
+         * @brief Destructor. Finalizes all cached statements
+         * NOTE: Must run before the connection is closed
+         **/
+        ~StatementCache() noexcept;
+
+        StatementCache(const StatementCache&)            = delete;
+        StatementCache& operator=(const StatementCache&) = delete;
+
+        /**
+         * @brief Check out a prepared statement for the given SQL text
+         * @param sql SQL text of a single statement
+         * @return A lease on the statement. The lease is empty if preparing failed
+         **/
+        Lease Acquire(std::string_view sql) noexcept;
+
+        /**
+         * @brief Finalize all idle statements
+         **/
+        void Clear() noexcept;
+
+        /**
+         * @brief Get the cache counters
+         **/
+        Stats GetStats() const noexcept;
+
+        /**
+         * @brief Normalize SQL text so equivalent statements share a cache entry
+         *
+         * Runs of whitespace and comments outside of quoted literals are collapsed
+         * into a single space, and leading/trailing whitespace and semicolons are
+         * removed.
+         *
+         * @param sql The SQL text
+         * @return The normalized SQL text
+         **/
+        static std::string Normalize(std::string_view sql);
+
+    private:
+        /**
+         * @brief Reset a statement and put it back in the cache
+         * @param key The normalized SQL text of the statement
+         * @param stmt The statement
+         **/
+        void Release(std::string&& key, sqlite3_stmt* stmt) noexcept;
+
+        /**
+         * @brief Finalize the least recently used statements until the cache fits
+         *        its capacity
+         **/
+        void EvictOverflow() noexcept;
+};
+
+#endif // STATEMENT_CACHE_H_
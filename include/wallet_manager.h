@@ -15,24 +15,85 @@
 #define WALLET_MANAGER_H_
 
 #include <cmath>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "category_manager.h"
 #include "db_manager.h"
+#include "ledger_store.h"
 #include "log_manager.h"
+#include "money.h"
+
+/**
+ * @brief Expense, income or transfer recorded by WalletManager::RecordBatch
+ **/
+struct WalletOp
+{
+        enum class Type
+        {
+            Expense,
+            Income,
+            Transfer
+        };
+
+        Type        type;
+        std::string wallet;
+        std::string toWallet; // Destination of a transfer
+        std::string category; // Not used by transfers
+        std::string date;
+        std::string description; // Not used by transfers
+        Money       amount;
+};
 
 /**
  * @brief The WalletManager class is responsible for managing the wallet operations
  * such as creating a new wallet, deleting a wallet, registering a new expense,
  * and registering a new income.
+ *
+ * Amounts are taken as Money, so they are rounded to whole cents once and the
+ * balances are computed in cents.
+ *
+ * The balances of the wallets are cached in memory. The cache is loaded from the
+ * store on first use, and every change made by the manager is written through
+ * once the outermost transaction commits it, so balance and existence checks do
+ * not query the store. The cache is loaded again when the generation of the
+ * store changes, e.g. after a restore.
+ * NOTE: Call InvalidateCache after changing wallets without the manager, e.g.
+ *       with BulkImporter or another WalletManager
  **/
 class WalletManager
 {
+    public:
+        /**
+         * @brief Outcome of an operation of a batch
+         **/
+        enum class OpStatus
+        {
+            Recorded,
+            WalletNotFound,
+            SameWallet,
+            InvalidAmount,
+            InsufficientBalance,
+            Failed
+        };
+
     private:
-        LogManager&     m_logManager;
-        DBManager&      m_dbManager;
-        CategoryManager m_categoryManager;
+        LogManager&                  m_logManager;
+        std::unique_ptr<LedgerStore> m_ownedStore;
+        LedgerStore&                 m_store;
+        CategoryManager              m_categoryManager;
+
+        // The cache is stale once the generation of the store changes
+        std::mutex                             m_cacheMutex;
+        std::unordered_map<std::string, Money> m_balances;
+        bool                                   m_cacheLoaded;
+        uint64_t                               m_cacheGeneration;
 
     public:
         /**
@@ -40,6 +101,18 @@ class WalletManager
          **/
         WalletManager() noexcept;
 
+        /**
+         * @brief Constructor
+         * @param dbManager The database the wallets are stored in
+         **/
+        explicit WalletManager(DBManager& dbManager) noexcept;
+
+        /**
+         * @brief Constructor
+         * @param store The store the wallets are kept in
+         **/
+        explicit WalletManager(LedgerStore& store) noexcept;
+
         /**
          * @brief Default destructor
          **/
@@ -59,14 +132,14 @@ class WalletManager
          * NOTE: All data stored in the vectors will be lost
          **/
         void GetWallets(std::vector<std::string>& wallets,
-                        std::vector<double_t>&    balances) noexcept;
+                        std::vector<Money>&       balances) noexcept;
 
         /**
          * @brief Create a new wallet
          * @param walletName The wallet name
          **/
         void CreateWallet(const std::string& walletName,
-                          const double_t     initialBalance = 0) noexcept;
+                          const Money        initialBalance = Money()) noexcept;
 
         /**
          * @brief Delete a wallet
@@ -81,12 +154,29 @@ class WalletManager
          * @param date The expense date
          * @param description The expense description
          * @param amount The expense amount
+         * @return True if the expense was registered, false otherwise
          **/
-        void Expense(const std::string& walletName,
+        bool Expense(const std::string& walletName,
                      const std::string& category,
                      const std::string& date,
                      const std::string& description,
-                     const double_t     amount) noexcept;
+                     const Money        amount) noexcept;
+
+        /**
+         * @brief Register a new expense in the background of the store
+         *
+         * Takes the same parameters as Expense. The expense is committed together
+         * with the other writes queued around the same time.
+         *
+         * @return A future that holds true once the expense is committed
+         * NOTE: The manager must outlive the operation. Wait for the future, or
+         *       call DBManager::Flush on a database store, before destroying it
+         **/
+        std::future<bool> ExpenseAsync(const std::string& walletName,
+                                       const std::string& category,
+                                       const std::string& date,
+                                       const std::string& description,
+                                       const Money        amount) noexcept;
 
         /**
          * @brief Register a new income
@@ -95,12 +185,29 @@ class WalletManager
          * @param date The income date
          * @param description The income description
          * @param amount The income amount
+         * @return True if the income was registered, false otherwise
          **/
-        void Income(const std::string& walletName,
+        bool Income(const std::string& walletName,
                     const std::string& category,
                     const std::string& date,
                     const std::string& description,
-                    const double_t     amount) noexcept;
+                    const Money        amount) noexcept;
+
+        /**
+         * @brief Register a new income in the background of the store
+         *
+         * Takes the same parameters as Income. The income is committed together
+         * with the other writes queued around the same time.
+         *
+         * @return A future that holds true once the income is committed
+         * NOTE: The manager must outlive the operation. Wait for the future, or
+         *       call DBManager::Flush on a database store, before destroying it
+         **/
+        std::future<bool> IncomeAsync(const std::string& walletName,
+                                      const std::string& category,
+                                      const std::string& date,
+                                      const std::string& description,
+                                      const Money        amount) noexcept;
 
         /**
          * @brief Transfer money between wallets
@@ -112,30 +219,99 @@ class WalletManager
         void Transfer(const std::string& srcWalletId,
                       const std::string& dstWalletId,
                       const std::string& date,
-                      const double_t     amount) noexcept;
+                      const Money        amount) noexcept;
 
-    private:
         /**
-         * @brief Check if a wallet exists
+         * @brief Record many expenses, incomes and transfers at once
+         *
+         * The whole batch is checked in memory, in order, against the cached
+         * balances, so an operation sees the effect of the ones before it.
+         * Operations that fail a check are rejected and the others are recorded
+         * in a single transaction. Categories are resolved with a single lookup,
+         * rows are inserted with multi-row inserts and the balance of each wallet
+         * is updated once with its net change.
+         *
+         * @param ops The operations
+         * @param results Filled with the outcome of each operation
+         * @return bool True if the accepted operations were committed. If not,
+         *         every operation not rejected is marked as Failed
+         **/
+        bool RecordBatch(std::span<const WalletOp> ops,
+                         std::vector<OpStatus>&    results) noexcept;
+
+        /**
+         * @brief Get the balance of a wallet at the end of a day
+         *
+         * Read from the daily balances, which every expense, income and transfer
+         * keeps up to date, so the history is not scanned.
+         *
          * @param walletName The wallet name
+         * @param date The day
+         * @param balance The balance
          * @return True if the wallet exists, false otherwise
          **/
-        bool WalletExists(const std::string& walletName) noexcept;
+        bool GetBalanceAsOf(const std::string& walletName,
+                            const std::string& date,
+                            Money&             balance) noexcept;
 
         /**
-         * @brief Update the wallet balance
+         * @brief Get the closing balance of a wallet on each day it moved, between
+         *        two days inclusive
          * @param walletName The wallet name
-         * @param amount The amount to be updated
+         * @param from The first day
+         * @param to The last day
+         * @param dates The vector to store the days, oldest first
+         * @param balances The vector to store the balances
+         * @return True if the wallet exists, false otherwise
+         * NOTE: All data stored in the vectors will be lost
          **/
-        void UpdateBalance(const std::string& walletName,
-                           const double_t     amount) noexcept;
+        bool GetBalanceSeries(const std::string&        walletName,
+                              const std::string&        from,
+                              const std::string&        to,
+                              std::vector<std::string>& dates,
+                              std::vector<Money>&       balances) noexcept;
 
         /**
-         * @brief Get the wallet balance
+         * @brief Drop the cached balances. They are loaded again from the store on
+         *        next use
+         **/
+        void InvalidateCache() noexcept;
+
+        /**
+         * @brief Load the cached balances from the store right away
+         **/
+        void ReloadCache() noexcept;
+
+    private:
+        /**
+         * @brief Get the cached balance of a wallet, loading the cache if needed
          * @param walletName The wallet name
-         * @return The wallet balance
+         * @return The balance, or nothing if the wallet does not exist
+         **/
+        std::optional<Money> GetCachedBalance(const std::string& walletName) noexcept;
+
+        /**
+         * @brief Set the cached balance of a wallet once the store commits the
+         *        write, if the cache is loaded
+         * @param balance The balance. Nothing removes the wallet from the cache
+         **/
+        void SetCachedBalance(const std::string&   walletName,
+                              std::optional<Money> balance) noexcept;
+
+        /**
+         * @brief Check if a wallet exists
+         * @param walletName The wallet name
+         * @return True if the wallet exists, false otherwise
+         **/
+        bool WalletExists(const std::string& walletName) noexcept;
+
+        /**
+         * @brief Get the id of a category, creating the category if it does not
+         *        exist
+         * @param category The category name
+         * @return The category id, or nothing if it could not be created
          **/
-        double_t GetBalance(const std::string& walletName) noexcept;
+        std::optional<int64_t> ResolveCategory(const std::string& category) noexcept;
 };
 
 #endif // WALLET_MANAGER_H_
@@ -0,0 +1,63 @@
+/*
+ * Filename: append_only_ledger_store.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include "append_only_ledger_store.h"
+#include "sql_queries.h"
+
+AppendOnlyLedgerStore::AppendOnlyLedgerStore(DBManager& dbManager,
+                                             uint32_t   checkpointInterval) noexcept
+    : SqliteLedgerStore(dbManager, checkpointInterval)
+{ }
+
+bool AppendOnlyLedgerStore::InsertWallet(const std::string& name,
+                                         Money              balance) noexcept
+{
+    return SqliteLedgerStore::InsertWallet(name, balance) and this->EnterLedger(name);
+}
+
+bool AppendOnlyLedgerStore::SetWalletBalance(const std::string& name,
+                                             Money              balance) noexcept
+{
+    return this->EnterLedger(name) and
+           SqliteLedgerStore::SetWalletBalance(name, balance);
+}
+
+std::optional<Money>
+AppendOnlyLedgerStore::CreditWallet(const std::string& name, Money amount) noexcept
+{
+    if (not this->EnterLedger(name))
+    {
+        return std::nullopt;
+    }
+
+    return this->AppendToLedger(name, amount);
+}
+
+std::optional<Money>
+AppendOnlyLedgerStore::DebitWallet(const std::string& name, Money amount) noexcept
+{
+    if (not this->EnterLedger(name))
+    {
+        return std::nullopt;
+    }
+
+    return this->AppendToLedger(name, -amount, false);
+}
+
+std::optional<Money>
+AppendOnlyLedgerStore::GetBalanceAfterEntry(const std::string& name,
+                                            int64_t            seq) noexcept
+{
+    return this->m_dbManager.QueryOne<Money>(query::SELECT_WALLET_BALANCE_AFTER_ENTRY,
+                                             name,
+                                             seq);
+}
+
+bool AppendOnlyLedgerStore::EnterLedger(const std::string& name) noexcept
+{
+    // Does nothing for wallets already in the ledger
+    return this->m_dbManager.Execute(query::INSERT_WALLET_LEDGER_START, name);
+}
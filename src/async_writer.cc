@@ -0,0 +1,306 @@
+/*
+ * Filename: async_writer.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include "async_writer.h"
+#include "db_manager.h"
+#include <exception>
+#include <fmt/format.h>
+
+AsyncWriter::AsyncWriter(DBManager&                dbManager,
+                         std::chrono::microseconds window,
+                         std::size_t               maxBatchSize) noexcept
+    : m_dbManager(dbManager),
+      m_logger(LogManager::GetInstance()),
+      m_window(window),
+      m_maxBatchSize(maxBatchSize > 0 ? maxBatchSize : 1),
+      m_head(&m_stub),
+      m_tail(&m_stub),
+      m_sleeping(false),
+      m_stopping(false),
+      m_operations(0),
+      m_failed(0),
+      m_batches(0)
+{
+    this->m_thread = std::thread(&AsyncWriter::Run, this);
+}
+
+AsyncWriter::~AsyncWriter() noexcept
+{
+    this->m_stopping = true;
+
+    {
+        std::lock_guard<std::mutex> lock(this->m_wakeMutex);
+        this->m_wakeCondition.notify_one();
+    }
+
+    if (this->m_thread.joinable())
+    {
+        this->m_thread.join();
+    }
+}
+
+std::future<bool> AsyncWriter::Enqueue(std::function<bool()> operation) noexcept
+{
+    auto node       = std::make_unique<Node>();
+    node->operation = std::move(operation);
+
+    std::future<bool> result = node->promise.get_future();
+
+    if (this->m_stopping)
+    {
+        this->m_logger.Log("Async writer is stopped", spdlog::level::err);
+        node->promise.set_value(false);
+        return result;
+    }
+
+    this->Push(node.release());
+    return result;
+}
+
+bool AsyncWriter::Flush() noexcept
+{
+    if (std::this_thread::get_id() == this->m_thread.get_id())
+    {
+        this->m_logger.Log("Flush cannot be called from an async operation",
+                           spdlog::level::err);
+        return false;
+    }
+
+    if (this->m_stopping)
+    {
+        return false;
+    }
+
+    auto node     = std::make_unique<Node>();
+    node->barrier = true;
+
+    std::future<bool> done = node->promise.get_future();
+
+    this->Push(node.release());
+    return done.get();
+}
+
+AsyncWriter::Stats AsyncWriter::GetStats() const noexcept
+{
+    Stats stats;
+    stats.operations = this->m_operations;
+    stats.failed     = this->m_failed;
+    stats.batches    = this->m_batches;
+    return stats;
+}
+
+void AsyncWriter::Push(Node* node) noexcept
+{
+    this->Link(node);
+
+    // The writer sets the flag before its last look at the queue, so either it
+    // sees the node or the node sees the flag
+    if (this->m_sleeping)
+    {
+        std::lock_guard<std::mutex> lock(this->m_wakeMutex);
+        this->m_wakeCondition.notify_one();
+    }
+}
+
+void AsyncWriter::Link(Node* node) noexcept
+{
+    node->next = nullptr;
+
+    Node* previous = this->m_head.exchange(node);
+    previous->next = node;
+}
+
+AsyncWriter::Node* AsyncWriter::Pop() noexcept
+{
+    Node* tail = this->m_tail;
+    Node* next = tail->next;
+
+    if (tail == &this->m_stub)
+    {
+        if (not next)
+        {
+            return nullptr;
+        }
+
+        this->m_tail = next;
+        tail         = next;
+        next         = next->next;
+    }
+
+    if (next)
+    {
+        this->m_tail = next;
+        return tail;
+    }
+
+    // A producer swapped the head but has not linked its node yet
+    if (tail != this->m_head)
+    {
+        return nullptr;
+    }
+
+    // The tail is the last node. Put the stub behind it so it can be popped. Pop
+    // runs with the wake mutex held, so the writer must not be woken here
+    this->Link(&this->m_stub);
+
+    next = tail->next;
+
+    if (next)
+    {
+        this->m_tail = next;
+        return tail;
+    }
+
+    return nullptr;
+}
+
+AsyncWriter::Node*
+AsyncWriter::WaitForNode(std::chrono::steady_clock::time_point deadline)
+{
+    Node* node = this->Pop();
+
+    if (node)
+    {
+        return node;
+    }
+
+    this->m_sleeping = true;
+
+    {
+        std::unique_lock<std::mutex> lock(this->m_wakeMutex);
+
+        auto ready = [this, &node]() {
+            node = this->Pop();
+            return node != nullptr or this->m_stopping;
+        };
+
+        this->m_wakeCondition.wait_until(lock, deadline, ready);
+    }
+
+    this->m_sleeping = false;
+
+    return node;
+}
+
+void AsyncWriter::Run() noexcept
+{
+    while (true)
+    {
+        Node* node = this->WaitForNode(std::chrono::steady_clock::time_point::max());
+
+        if (node)
+        {
+            this->ProcessBatch(node);
+        }
+        else if (this->m_stopping)
+        {
+            // The queue is drained before the thread stops
+            break;
+        }
+    }
+}
+
+void AsyncWriter::ProcessBatch(Node* first) noexcept
+{
+    std::vector<std::unique_ptr<Node>> batch;
+    std::vector<bool>                  succeeded;
+
+    if (first->barrier)
+    {
+        first->promise.set_value(true);
+        delete first;
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::now() + this->m_window;
+
+    bool committed = false;
+
+    {
+        DBManager::Transaction transaction(this->m_dbManager);
+
+        Node* node = first;
+
+        while (node)
+        {
+            batch.emplace_back(node);
+
+            // Barriers end the batch, so they complete after everything before them
+            if (node->barrier)
+            {
+                succeeded.push_back(true);
+                break;
+            }
+
+            succeeded.push_back(transaction.IsActive() and this->RunOperation(*node));
+
+            if (batch.size() >= this->m_maxBatchSize)
+            {
+                break;
+            }
+
+            node = this->WaitForNode(deadline);
+        }
+
+        committed = transaction.Commit();
+    }
+
+    this->m_batches++;
+
+    for (std::size_t i = 0; i < batch.size(); i++)
+    {
+        if (batch[i]->barrier)
+        {
+            batch[i]->promise.set_value(true);
+            continue;
+        }
+
+        bool result = committed and succeeded[i];
+
+        this->m_operations++;
+
+        if (not result)
+        {
+            this->m_failed++;
+        }
+
+        batch[i]->promise.set_value(result);
+    }
+
+    if (not committed)
+    {
+        this->m_logger.Log(fmt::format("Failed to commit a batch of {} operations",
+                                       batch.size()),
+                           spdlog::level::err);
+    }
+}
+
+bool AsyncWriter::RunOperation(Node& node) noexcept
+{
+    DBManager::Transaction savepoint(this->m_dbManager);
+
+    if (not savepoint.IsActive())
+    {
+        return false;
+    }
+
+    try
+    {
+        return node.operation() and savepoint.Commit();
+    }
+    catch (const std::exception& e)
+    {
+        this->m_logger.Log(std::string("Async operation failed: ") + e.what(),
+                           spdlog::level::err);
+    }
+    catch (...)
+    {
+        this->m_logger.Log("Async operation failed", spdlog::level::err);
+    }
+
+    return false;
+}
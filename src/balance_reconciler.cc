@@ -0,0 +1,263 @@
+/*
+ * Filename: balance_reconciler.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include "balance_reconciler.h"
+#include "money.h"
+#include "sql_queries.h"
+#include <algorithm>
+#include <fmt/format.h>
+#include <system_error>
+#include <thread>
+#include <tuple>
+
+BalanceReconciler::BalanceReconciler() noexcept
+    : BalanceReconciler(DBManager::GetInstance())
+{ }
+
+BalanceReconciler::BalanceReconciler(DBManager& dbManager, std::size_t threads) noexcept
+    : m_dbManager(dbManager),
+      m_logManager(LogManager::GetInstance()),
+      m_threads(std::max<std::size_t>(threads, 1))
+{ }
+
+bool BalanceReconciler::Check(std::vector<Mismatch>& mismatches, Stats& stats) noexcept
+{
+    auto start = std::chrono::steady_clock::now();
+
+    mismatches.clear();
+    stats = Stats();
+
+    std::vector<std::string> names;
+
+    auto wallets =
+        this->m_dbManager.Stream<std::string>(query::SELECT_WALLET_NAMES_ORDERED);
+
+    for (std::string name : wallets)
+    {
+        names.push_back(std::move(name));
+    }
+
+    if (wallets.HasFailed())
+    {
+        this->m_logManager.Log("Failed to list the wallets to reconcile.",
+                               spdlog::level::err);
+        return false;
+    }
+
+    // Contiguous ranges of about the same number of wallets
+    std::size_t            count = std::min(this->m_threads, names.size());
+    std::vector<Partition> partitions(count);
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        partitions[i].first = names[i * names.size() / count];
+        partitions[i].last  = names[(i + 1) * names.size() / count - 1];
+    }
+
+    // The calling thread checks the first partition. A partition whose thread
+    // cannot be started is checked by the calling thread too
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 1; i < count; i++)
+    {
+        try
+        {
+            threads.emplace_back(&BalanceReconciler::CheckPartition,
+                                 this,
+                                 std::ref(partitions[i]));
+        }
+        catch (const std::system_error&)
+        {
+            this->CheckPartition(partitions[i]);
+        }
+    }
+
+    if (count > 0)
+    {
+        this->CheckPartition(partitions[0]);
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    bool checked = true;
+
+    for (Partition& partition : partitions)
+    {
+        checked = checked and partition.checked;
+        stats.wallets += partition.wallets;
+
+        std::move(partition.mismatches.begin(),
+                  partition.mismatches.end(),
+                  std::back_inserter(mismatches));
+    }
+
+    stats.mismatches = mismatches.size();
+    stats.partitions = count;
+    stats.elapsed    = std::chrono::steady_clock::now() - start;
+
+    if (not checked)
+    {
+        this->m_logManager.Log("Failed to reconcile the wallet balances.",
+                               spdlog::level::err);
+        return false;
+    }
+
+    this->m_logManager.Log(fmt::format("Reconciled {} wallets in {} partitions: {} "
+                                       "mismatches",
+                                       stats.wallets,
+                                       stats.partitions,
+                                       stats.mismatches));
+
+    for (const Mismatch& mismatch : mismatches)
+    {
+        this->m_logManager.Log(fmt::format("Wallet '{}' has balance {} but its "
+                                           "history adds up to {}",
+                                           mismatch.wallet,
+                                           mismatch.stored.ToString(),
+                                           mismatch.computed.ToString()),
+                               spdlog::level::warn);
+    }
+
+    return true;
+}
+
+bool BalanceReconciler::Repair(std::vector<Mismatch>& mismatches, Stats& stats) noexcept
+{
+    if (not this->Check(mismatches, stats))
+    {
+        return false;
+    }
+
+    if (mismatches.empty())
+    {
+        return true;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    DBManager::Transaction transaction(this->m_dbManager);
+
+    if (not transaction.IsActive())
+    {
+        return false;
+    }
+
+    uint64_t repaired = 0;
+
+    for (Mismatch& mismatch : mismatches)
+    {
+        // Inside the transaction the check runs on the writer, and sees the
+        // writes made since the first one
+        auto row =
+            this->m_dbManager.QueryOne<std::tuple<std::string, Money, int64_t>>(
+                query::SELECT_WALLET_LEDGER_BALANCES,
+                mismatch.wallet,
+                mismatch.wallet);
+
+        if (not row)
+        {
+            continue;
+        }
+
+        mismatch.stored   = std::get<1>(*row);
+        mismatch.computed = Money::FromCents(std::get<2>(*row));
+
+        if (mismatch.stored == mismatch.computed)
+        {
+            continue;
+        }
+
+        bool inLedger =
+            this->m_dbManager.QueryOne<int64_t>(query::COUNT_WALLET_BALANCE_CHECKPOINTS,
+                                                mismatch.wallet)
+                .value_or(0) > 0;
+
+        // A wallet kept in the append-only ledger is corrected with an entry
+        bool corrected = false;
+
+        if (inLedger)
+        {
+            Money correction = mismatch.computed - mismatch.stored;
+
+            corrected =
+                this->m_dbManager.Execute(query::APPEND_WALLET_LEDGER_ENTRY,
+                                          mismatch.wallet,
+                                          correction.Cents()) and
+                this->m_dbManager.Execute(
+                    query::INSERT_WALLET_BALANCE_CHECKPOINT,
+                    mismatch.wallet,
+                    static_cast<int64_t>(config::LEDGER_CHECKPOINT_INTERVAL));
+        }
+        else
+        {
+            corrected = this->m_dbManager.Execute(query::UPDATE_WALLET_BALANCE,
+                                                  mismatch.computed,
+                                                  mismatch.wallet);
+        }
+
+        if (not corrected or
+            not this->m_dbManager.Execute(query::DELETE_WALLET_DAILY_BALANCES,
+                                          mismatch.wallet) or
+            not this->m_dbManager.Execute(query::REBUILD_WALLET_DAILY_BALANCES,
+                                          mismatch.wallet))
+        {
+            this->m_logManager.Log("Failed to repair the balance of wallet '" +
+                                       mismatch.wallet + "'.",
+                                   spdlog::level::err);
+            return false;
+        }
+
+        repaired++;
+    }
+
+    if (not transaction.Commit())
+    {
+        this->m_logManager.Log("Failed to commit the repaired wallet balances.",
+                               spdlog::level::err);
+        return false;
+    }
+
+    stats.repaired = repaired;
+    stats.elapsed += std::chrono::steady_clock::now() - start;
+
+    this->m_logManager.Log(fmt::format("Repaired the balance of {} wallets",
+                                       stats.repaired));
+    return true;
+}
+
+void BalanceReconciler::CheckPartition(Partition& partition) noexcept
+{
+    try
+    {
+        // The cursor keeps a reader checked out until the last row is read
+        auto rows = this->m_dbManager
+                        .Stream<std::tuple<std::string_view, Money, int64_t>>(
+                            query::SELECT_WALLET_LEDGER_BALANCES,
+                            partition.first,
+                            partition.last);
+
+        for (auto [wallet, stored, cents] : rows)
+        {
+            partition.wallets++;
+
+            if (stored.Cents() != cents)
+            {
+                partition.mismatches.push_back({ std::string(wallet),
+                                                 stored,
+                                                 Money::FromCents(cents) });
+            }
+        }
+
+        partition.checked = not rows.HasFailed();
+    }
+    catch (const std::exception&)
+    {
+        partition.checked = false;
+    }
+}
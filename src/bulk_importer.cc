@@ -0,0 +1,926 @@
+/*
+ * Filename: bulk_importer.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include "bulk_importer.h"
+#include "money.h"
+#include "sql_queries.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // Rejected rows logged one by one. The others are only counted
+    constexpr std::size_t LOGGED_REJECTS = 10;
+
+    /**
+     * @brief Build a multi-row insert of wallet transactions
+     **/
+    std::string MultiRowInsert(std::size_t rows)
+    {
+        return query::MultiRowInsert(query::INSERT_WALLET_TRANSACTIONS,
+                                     query::WALLET_TRANSACTION_ROW,
+                                     rows);
+    }
+
+    /**
+     * @brief Parse an unsigned integer that spans the whole field
+     **/
+    bool ParseNumber(std::string_view field, int& value) noexcept
+    {
+        auto [end, error] =
+            std::from_chars(field.data(), field.data() + field.size(), value);
+
+        return error == std::errc() and end == field.data() + field.size() and
+               value >= 0;
+    }
+
+    /**
+     * @brief Get the text between an OFX tag and the next tag or line break
+     * @return std::string_view The value without surrounding blanks, or an empty
+     *         view if the block has no such tag
+     **/
+    std::string_view OfxValue(std::string_view block, std::string_view tag) noexcept
+    {
+        std::size_t begin = block.find(tag);
+
+        if (begin == std::string_view::npos)
+        {
+            return { };
+        }
+
+        begin += tag.size();
+
+        std::size_t end = block.find_first_of("<\r\n", begin);
+
+        std::string_view value =
+            block.substr(begin, end == std::string_view::npos ? end : end - begin);
+
+        while (not value.empty() and (value.front() == ' ' or value.front() == '\t'))
+        {
+            value.remove_prefix(1);
+        }
+
+        while (not value.empty() and (value.back() == ' ' or value.back() == '\t'))
+        {
+            value.remove_suffix(1);
+        }
+
+        return value;
+    }
+} // namespace
+
+MappedFile::MappedFile(const std::string& path) noexcept
+    : m_data(nullptr),
+      m_size(0)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+    {
+        return;
+    }
+
+    struct stat info;
+
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        return;
+    }
+
+    if (info.st_size == 0)
+    {
+        // An empty file cannot be mapped, but it is a valid empty statement
+        this->m_data = "";
+    }
+    else
+    {
+        void* data = mmap(nullptr,
+                          static_cast<std::size_t>(info.st_size),
+                          PROT_READ,
+                          MAP_PRIVATE,
+                          fd,
+                          0);
+
+        if (data != MAP_FAILED)
+        {
+            // The file is read once, from start to end
+            madvise(data, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+
+            this->m_data = static_cast<const char*>(data);
+            this->m_size = static_cast<std::size_t>(info.st_size);
+        }
+    }
+
+    close(fd);
+}
+
+MappedFile::~MappedFile() noexcept
+{
+    if (this->m_size > 0)
+    {
+        munmap(const_cast<char*>(this->m_data), this->m_size);
+    }
+}
+
+bool MappedFile::IsOpen() const noexcept
+{
+    return this->m_data != nullptr;
+}
+
+std::string_view MappedFile::Data() const noexcept
+{
+    return this->m_data ? std::string_view(this->m_data, this->m_size)
+                        : std::string_view();
+}
+
+double BulkImporter::Stats::RowsPerSecond() const noexcept
+{
+    double seconds = std::chrono::duration<double>(this->elapsed).count();
+
+    return seconds > 0 ? static_cast<double>(this->rows) / seconds : 0;
+}
+
+BulkImporter::ChunkQueue::ChunkQueue(std::size_t capacity) noexcept
+    : m_capacity(capacity),
+      m_closed(false)
+{ }
+
+bool BulkImporter::ChunkQueue::Push(Chunk&& chunk)
+{
+    std::unique_lock<std::mutex> lock(this->m_mutex);
+
+    while (not this->m_closed and this->m_chunks.size() >= this->m_capacity)
+    {
+        this->m_changed.wait_for(lock, std::chrono::milliseconds(100));
+    }
+
+    if (this->m_closed)
+    {
+        return false;
+    }
+
+    this->m_chunks.push_back(std::move(chunk));
+    this->m_changed.notify_all();
+
+    return true;
+}
+
+std::optional<BulkImporter::Chunk> BulkImporter::ChunkQueue::Pop()
+{
+    std::unique_lock<std::mutex> lock(this->m_mutex);
+
+    while (not this->m_closed and this->m_chunks.empty())
+    {
+        this->m_changed.wait_for(lock, std::chrono::milliseconds(100));
+    }
+
+    if (this->m_chunks.empty())
+    {
+        return std::nullopt;
+    }
+
+    std::optional<Chunk> chunk(std::move(this->m_chunks.front()));
+
+    this->m_chunks.pop_front();
+    this->m_changed.notify_all();
+
+    return chunk;
+}
+
+void BulkImporter::ChunkQueue::Close() noexcept
+{
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+
+    this->m_closed = true;
+    this->m_changed.notify_all();
+}
+
+BulkImporter::BulkImporter() noexcept
+    : BulkImporter(DBManager::GetInstance())
+{ }
+
+BulkImporter::BulkImporter(DBManager& dbManager) noexcept
+    : m_dbManager(dbManager),
+      m_logManager(LogManager::GetInstance())
+{ }
+
+bool BulkImporter::ImportFile(const std::string& path,
+                              const std::string& walletName,
+                              Format             format,
+                              Stats&             stats) noexcept
+{
+    MappedFile file(path);
+
+    if (not file.IsOpen())
+    {
+        stats = Stats();
+
+        this->m_logManager.Log("Could not open statement '" + path + "': " +
+                                   std::strerror(errno),
+                               spdlog::level::err);
+        return false;
+    }
+
+    return this->ImportText(file.Data(), walletName, format, stats);
+}
+
+bool BulkImporter::ImportText(std::string_view   data,
+                              const std::string& walletName,
+                              Format             format,
+                              Stats&             stats) noexcept
+{
+    auto start = std::chrono::steady_clock::now();
+
+    stats = Stats();
+
+    // Every row is inserted in the same transaction, so a failed import leaves
+    // neither rows nor balance changes behind
+    DBManager::Transaction transaction(this->m_dbManager);
+
+    if (not transaction.IsActive())
+    {
+        return false;
+    }
+
+    if (this->m_dbManager.QueryOne<int64_t>(query::COUNT_WALLET, walletName)
+            .value_or(0) == 0)
+    {
+        this->m_logManager.Log("Wallet '" + walletName + "' does not exist.");
+        return false;
+    }
+
+    bool   imported = true;
+    Totals totals;
+
+    try
+    {
+        this->m_categories.clear();
+
+        this->m_dbManager.ForEach<std::tuple<std::string_view, int64_t>>(
+            query::SELECT_CATEGORY_NAMES_AND_IDS,
+            [this](std::tuple<std::string_view, int64_t> row) {
+                this->m_categories.emplace(std::get<0>(row), std::get<1>(row));
+            });
+
+        ChunkQueue  queue(config::IMPORT_QUEUED_CHUNKS);
+        bool        parsed = false;
+        std::thread parser([this, data, format, &queue, &parsed] {
+            parsed = this->Parse(data, format, queue);
+        });
+
+        // Chunks keep arriving after a failed insert, and are only counted, until
+        // the parser sees the queue closed
+        try
+        {
+            while (std::optional<Chunk> chunk = queue.Pop())
+            {
+                for (const auto& [line, reason] : chunk->rejected)
+                {
+                    if (stats.rejected++ < LOGGED_REJECTS)
+                    {
+                        this->m_logManager.Log("Rejected line " + std::to_string(line) +
+                                                   " of the statement: " + reason,
+                                               spdlog::level::warn);
+                    }
+                }
+
+                stats.rows += chunk->rows.size() + chunk->rejected.size();
+
+                if (imported and
+                    this->InsertChunk(*chunk, walletName, totals))
+                {
+                    stats.imported += chunk->rows.size();
+                }
+                else if (imported)
+                {
+                    imported = false;
+                    queue.Close();
+                }
+            }
+        }
+        catch (const std::exception& e)
+        {
+            this->m_logManager.Log(e.what(), spdlog::level::err);
+            imported = false;
+            queue.Close();
+        }
+
+        parser.join();
+
+        imported = imported and parsed;
+    }
+    catch (const std::exception& e)
+    {
+        this->m_logManager.Log(e.what(), spdlog::level::err);
+        imported = false;
+    }
+
+    if (stats.rejected > LOGGED_REJECTS)
+    {
+        this->m_logManager.Log(std::to_string(stats.rejected - LOGGED_REJECTS) +
+                                   " more lines of the statement rejected",
+                               spdlog::level::warn);
+    }
+
+    stats.elapsed = std::chrono::steady_clock::now() - start;
+
+    // The balance is updated once, with the sum of the imported amounts, the
+    // daily balances once per day of the statement and the spending summary once
+    // per cell
+    if (imported and stats.imported > 0)
+    {
+        std::optional<Money> balance =
+            this->m_dbManager.QueryOne<Money>(query::SELECT_WALLET_CURRENT_BALANCE,
+                                              walletName);
+
+        bool inLedger =
+            this->m_dbManager.QueryOne<int64_t>(query::COUNT_WALLET_BALANCE_CHECKPOINTS,
+                                                walletName)
+                .value_or(0) > 0;
+
+        // A wallet kept in the append-only ledger gets a single entry instead
+        if (not balance)
+        {
+            imported = false;
+        }
+        else if (inLedger)
+        {
+            imported =
+                this->m_dbManager.Execute(query::APPEND_WALLET_LEDGER_ENTRY,
+                                          walletName,
+                                          totals.balanceDelta.Cents()) and
+                this->m_dbManager.Execute(
+                    query::INSERT_WALLET_BALANCE_CHECKPOINT,
+                    walletName,
+                    static_cast<int64_t>(config::LEDGER_CHECKPOINT_INTERVAL));
+        }
+        else
+        {
+            imported =
+                this->m_dbManager.QueryOne<Money>(query::CREDIT_WALLET_BALANCE,
+                                                  totals.balanceDelta,
+                                                  walletName)
+                    .has_value();
+        }
+
+        for (auto day = totals.days.begin(); imported and day != totals.days.end();
+             ++day)
+        {
+            imported = this->m_dbManager.Execute(query::INSERT_WALLET_DAILY_BALANCE,
+                                                 walletName,
+                                                 day->first,
+                                                 *balance) and
+                       this->m_dbManager.Execute(query::ADD_TO_WALLET_DAILY_BALANCES,
+                                                 walletName,
+                                                 day->first,
+                                                 day->second);
+        }
+
+        for (auto cell = totals.spending.begin();
+             imported and cell != totals.spending.end();
+             ++cell)
+        {
+            const SpendingCell& spending = cell->second;
+
+            imported = this->m_dbManager.Execute(query::ADD_TO_SPENDING_SUMMARY,
+                                                 spending.month,
+                                                 spending.categoryId,
+                                                 spending.kind,
+                                                 spending.source,
+                                                 spending.total,
+                                                 spending.count,
+                                                 spending.minAmount,
+                                                 spending.maxAmount);
+        }
+    }
+
+    if (not imported or not transaction.Commit())
+    {
+        this->m_logManager.Log("Failed to import statement into wallet '" +
+                                   walletName + "'.",
+                               spdlog::level::err);
+        return false;
+    }
+
+    this->m_logManager.Log(fmt::format("Imported {} of {} rows into wallet '{}' in "
+                                       "{:.3f} s ({:.0f} rows/s).",
+                                       stats.imported,
+                                       stats.rows,
+                                       walletName,
+                                       std::chrono::duration<double>(stats.elapsed)
+                                           .count(),
+                                       stats.RowsPerSecond()));
+
+    return true;
+}
+
+bool BulkImporter::Parse(std::string_view data,
+                         Format           format,
+                         ChunkQueue&      queue) noexcept
+{
+    bool parsed = true;
+
+    try
+    {
+        if (format == Format::Csv)
+        {
+            this->ParseCsv(data, queue);
+        }
+        else
+        {
+            this->ParseOfx(data, queue);
+        }
+    }
+    catch (const std::bad_alloc&)
+    {
+        this->m_logManager.Log("Out of memory while parsing the statement",
+                               spdlog::level::err);
+        parsed = false;
+    }
+
+    queue.Close();
+
+    return parsed;
+}
+
+void BulkImporter::ParseCsv(std::string_view data, ChunkQueue& queue)
+{
+    const char* p   = data.data();
+    const char* end = data.data() + data.size();
+
+    Chunk    chunk;
+    uint64_t line = 0;
+
+    while (p < end)
+    {
+        line++;
+
+        std::array<std::string_view, 4> fields;
+        std::size_t                     count     = 0;
+        bool                            malformed = false;
+
+        for (;;)
+        {
+            std::string_view field;
+
+            if (p < end and *p == '"')
+            {
+                // Quoted field. It is copied only if it has escaped quotes
+                const char*  begin     = ++p;
+                std::string* unescaped = nullptr;
+
+                for (;;)
+                {
+                    const char* quote =
+                        static_cast<const char*>(std::memchr(p, '"', end - p));
+
+                    if (not quote)
+                    {
+                        malformed = true;
+                        p         = end;
+                        break;
+                    }
+
+                    if (quote + 1 < end and quote[1] == '"')
+                    {
+                        if (unescaped)
+                        {
+                            unescaped->append(p, quote + 1);
+                        }
+                        else
+                        {
+                            unescaped = &chunk.storage.emplace_back(begin, quote + 1);
+                        }
+
+                        p = quote + 2;
+                        continue;
+                    }
+
+                    if (unescaped)
+                    {
+                        unescaped->append(p, quote);
+                        field = *unescaped;
+                    }
+                    else
+                    {
+                        field = std::string_view(begin, quote - begin);
+                    }
+
+                    p = quote + 1;
+                    break;
+                }
+
+                if (p < end and *p == '\r')
+                {
+                    p++;
+                }
+            }
+            else
+            {
+                const char* special = FindCsvSpecial(p, end);
+
+                field = std::string_view(p, special - p);
+                p     = special;
+
+                if (not field.empty() and field.back() == '\r')
+                {
+                    field.remove_suffix(1);
+                }
+            }
+
+            if (count < fields.size())
+            {
+                fields[count] = field;
+            }
+
+            count++;
+
+            if (p < end and *p == ',')
+            {
+                p++;
+                continue;
+            }
+
+            break;
+        }
+
+        // A quote inside an unquoted field, or text after a closing quote
+        if (p < end and *p != '\n')
+        {
+            malformed = true;
+
+            const char* newline =
+                static_cast<const char*>(std::memchr(p, '\n', end - p));
+
+            p = newline ? newline : end;
+        }
+
+        if (p < end)
+        {
+            p++;
+        }
+
+        if (count == 1 and fields[0].empty())
+        {
+            continue;
+        }
+
+        if (line == 1 and fields[0] == "date")
+        {
+            continue;
+        }
+
+        if (malformed or count != fields.size())
+        {
+            chunk.rejected.emplace_back(line, "expected 4 fields");
+        }
+        else
+        {
+            AddRow(chunk, line, fields[0], fields[1], fields[2], fields[3]);
+        }
+
+        if (chunk.rows.size() + chunk.rejected.size() >= config::IMPORT_CHUNK_ROWS)
+        {
+            if (not queue.Push(std::move(chunk)))
+            {
+                return;
+            }
+
+            chunk = Chunk();
+        }
+    }
+
+    if (not chunk.rows.empty() or not chunk.rejected.empty())
+    {
+        queue.Push(std::move(chunk));
+    }
+}
+
+void BulkImporter::ParseOfx(std::string_view data, ChunkQueue& queue)
+{
+    constexpr std::string_view open  = "<STMTTRN>";
+    constexpr std::string_view close = "</STMTTRN>";
+
+    Chunk       chunk;
+    uint64_t    line     = 1;
+    std::size_t position = 0;
+
+    for (;;)
+    {
+        std::size_t begin = data.find(open, position);
+
+        if (begin == std::string_view::npos)
+        {
+            break;
+        }
+
+        line += std::count(data.begin() + position, data.begin() + begin, '\n');
+
+        std::size_t end = data.find(close, begin);
+
+        if (end == std::string_view::npos)
+        {
+            end = data.size();
+        }
+
+        std::string_view block = data.substr(begin, end - begin);
+        std::string_view date  = OfxValue(block, "<DTPOSTED>").substr(0, 8);
+        std::string_view memo  = OfxValue(block, "<MEMO>");
+
+        AddRow(chunk,
+               line,
+               date,
+               memo.empty() ? OfxValue(block, "<NAME>") : memo,
+               { },
+               OfxValue(block, "<TRNAMT>"));
+
+        if (chunk.rows.size() + chunk.rejected.size() >= config::IMPORT_CHUNK_ROWS)
+        {
+            if (not queue.Push(std::move(chunk)))
+            {
+                return;
+            }
+
+            chunk = Chunk();
+        }
+
+        if (end == data.size())
+        {
+            break;
+        }
+
+        position = end;
+        line += std::count(block.begin(), block.end(), '\n');
+    }
+
+    if (not chunk.rows.empty() or not chunk.rejected.empty())
+    {
+        queue.Push(std::move(chunk));
+    }
+}
+
+void BulkImporter::AddRow(Chunk&           chunk,
+                          uint64_t         line,
+                          std::string_view date,
+                          std::string_view description,
+                          std::string_view category,
+                          std::string_view amount)
+{
+    // Dates are YYYY-MM-DD in CSV and YYYYMMDD in OFX
+    int year, month, day;
+
+    bool dashed = date.size() == 10 and date[4] == '-' and date[7] == '-';
+
+    if ((not dashed and date.size() != 8) or
+        not ParseNumber(date.substr(0, 4), year) or
+        not ParseNumber(date.substr(dashed ? 5 : 4, 2), month) or
+        not ParseNumber(date.substr(dashed ? 8 : 6, 2), day) or
+        not std::chrono::year_month_day(std::chrono::year(year),
+                                        std::chrono::month(month),
+                                        std::chrono::day(day))
+                .ok())
+    {
+        chunk.rejected.emplace_back(line, "invalid date");
+        return;
+    }
+
+    if (not amount.empty() and amount.front() == '+')
+    {
+        amount.remove_prefix(1);
+    }
+
+    double value = 0;
+
+    auto [amountEnd, error] =
+        std::from_chars(amount.data(), amount.data() + amount.size(), value);
+
+    // Amounts that round to zero cents are rejected like zero itself
+    if (amount.empty() or error != std::errc() or
+        amountEnd != amount.data() + amount.size() or not std::isfinite(value) or
+        Money(value) == Money())
+    {
+        chunk.rejected.emplace_back(line, "invalid amount");
+        return;
+    }
+
+    Row& row = chunk.rows.emplace_back();
+
+    row.line        = line;
+    row.description = description;
+    row.category    = category.empty() ? config::IMPORT_DEFAULT_CATEGORY : category;
+    row.amount      = Money(value);
+
+    fmt::format_to_n(row.date.data(),
+                     row.date.size(),
+                     "{:04}-{:02}-{:02}",
+                     year,
+                     month,
+                     day);
+}
+
+bool BulkImporter::InsertChunk(const Chunk&       chunk,
+                               const std::string& walletName,
+                               Totals&            totals) noexcept
+{
+    try
+    {
+        std::vector<int64_t> categoryIds;
+        categoryIds.reserve(chunk.rows.size());
+
+        for (const Row& row : chunk.rows)
+        {
+            std::optional<int64_t> id = this->ResolveCategory(row.category);
+
+            if (not id)
+            {
+                return false;
+            }
+
+            categoryIds.push_back(*id);
+        }
+
+        static const std::string fullInsert =
+            MultiRowInsert(config::IMPORT_ROWS_PER_INSERT);
+
+        for (std::size_t first = 0; first < chunk.rows.size();
+             first += config::IMPORT_ROWS_PER_INSERT)
+        {
+            std::size_t rows =
+                std::min(config::IMPORT_ROWS_PER_INSERT, chunk.rows.size() - first);
+
+            // The text of the row fields outlives the statement, so it is bound
+            // without copies
+            std::string      tailInsert;
+            std::string_view sql = rows == config::IMPORT_ROWS_PER_INSERT
+                                       ? fullInsert
+                                       : (tailInsert = MultiRowInsert(rows));
+
+            bool inserted = this->m_dbManager.ExecuteBound(
+                sql,
+                [&](sqlite3_stmt* stmt) {
+                    for (std::size_t i = 0; i < rows; i++)
+                    {
+                        const Row& row   = chunk.rows[first + i];
+                        int        index = static_cast<int>(i * 6);
+
+                        if (sqlite3_bind_text(stmt,
+                                              index + 1,
+                                              walletName.data(),
+                                              static_cast<int>(walletName.size()),
+                                              SQLITE_STATIC) != SQLITE_OK or
+                            sqlite3_bind_int64(stmt,
+                                               index + 2,
+                                               categoryIds[first + i]) != SQLITE_OK or
+                            sqlite3_bind_text(stmt,
+                                              index + 3,
+                                              row.amount < Money() ? "EXPENSE"
+                                                                   : "INCOME",
+                                              -1,
+                                              SQLITE_STATIC) != SQLITE_OK or
+                            sqlite3_bind_text(stmt,
+                                              index + 4,
+                                              row.date.data(),
+                                              static_cast<int>(row.date.size()),
+                                              SQLITE_STATIC) != SQLITE_OK or
+                            sqlite3_bind_int64(stmt,
+                                               index + 5,
+                                               std::abs(row.amount.Cents())) !=
+                                SQLITE_OK or
+                            sqlite3_bind_text(stmt,
+                                              index + 6,
+                                              row.description.data(),
+                                              static_cast<int>(row.description.size()),
+                                              SQLITE_STATIC) != SQLITE_OK)
+                        {
+                            return false;
+                        }
+                    }
+
+                    return true;
+                });
+
+            if (not inserted)
+            {
+                return false;
+            }
+
+            for (std::size_t i = 0; i < rows; i++)
+            {
+                const Row&       row = chunk.rows[first + i];
+                std::string_view date(row.date.data(), row.date.size());
+
+                auto day = totals.days.find(date);
+
+                if (day == totals.days.end())
+                {
+                    day = totals.days.emplace(date, Money()).first;
+                }
+
+                day->second += row.amount;
+                totals.balanceDelta += row.amount;
+
+                // Amounts are kept positive in the summary, as in the rows
+                std::string month(date.substr(0, 7));
+                std::string kind = row.amount < Money() ? "EXPENSE" : "INCOME";
+                int64_t     id   = categoryIds[first + i];
+
+                auto [cell, added] = totals.spending.try_emplace(
+                    { month, id, kind },
+                    SpendingCell{
+                        month, id, kind, walletName, Money(), 0, Money(), Money() });
+
+                cell->second.Add(row.amount < Money() ? -row.amount : row.amount);
+            }
+        }
+    }
+    catch (const std::bad_alloc&)
+    {
+        this->m_logManager.Log("Out of memory while importing the statement",
+                               spdlog::level::err);
+        return false;
+    }
+
+    return true;
+}
+
+std::optional<int64_t> BulkImporter::ResolveCategory(std::string_view name)
+{
+    auto it = this->m_categories.find(name);
+
+    if (it != this->m_categories.end())
+    {
+        return it->second;
+    }
+
+    if (not this->m_dbManager.Execute(query::INSERT_CATEGORY, name))
+    {
+        this->m_logManager.Log("Failed to create category '" + std::string(name) +
+                                   "'.",
+                               spdlog::level::err);
+        return std::nullopt;
+    }
+
+    int64_t id = this->m_dbManager.LastInsertRowId();
+
+    this->m_categories.emplace(name, id);
+    this->m_logManager.Log("Category '" + std::string(name) + "' created.");
+
+    return id;
+}
+
+const char* BulkImporter::FindCsvSpecial(const char* begin, const char* end) noexcept
+{
+    const char* p = begin;
+
+#if defined(__SSE2__)
+    // Compare 16 bytes at a time against the three characters that end a field
+    const __m128i comma   = _mm_set1_epi8(',');
+    const __m128i quote   = _mm_set1_epi8('"');
+    const __m128i newline = _mm_set1_epi8('\n');
+
+    for (; end - p >= 16; p += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i found =
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, comma),
+                                      _mm_cmpeq_epi8(block, quote)),
+                         _mm_cmpeq_epi8(block, newline));
+
+        int mask = _mm_movemask_epi8(found);
+
+        if (mask != 0)
+        {
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+    }
+#endif
+
+    for (; p < end; p++)
+    {
+        if (*p == ',' or *p == '"' or *p == '\n')
+        {
+            return p;
+        }
+    }
+
+    return end;
+}
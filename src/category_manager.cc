@@ -5,10 +5,21 @@
  */
 
 #include "category_manager.h"
+#include "sqlite_ledger_store.h"
 #include <vector>
 
 CategoryManager::CategoryManager()
-    : m_dbManager(DBManager::GetInstance()),
+    : CategoryManager(DBManager::GetInstance())
+{ }
+
+CategoryManager::CategoryManager(DBManager& dbManager)
+    : m_ownedStore(std::make_unique<SqliteLedgerStore>(dbManager)),
+      m_store(*m_ownedStore),
+      m_logManager(LogManager::GetInstance())
+{ }
+
+CategoryManager::CategoryManager(LedgerStore& store)
+    : m_store(store),
       m_logManager(LogManager::GetInstance())
 { }
 
@@ -17,14 +28,7 @@ CategoryManager::~CategoryManager() { }
 void CategoryManager::GetCategoriesNames(
     std::vector<std::string>& categories) const noexcept
 {
-    categories.clear();
-
-    std::string query = "SELECT name FROM Category;";
-
-    this->m_dbManager.ExecuteQueryWithResult(query, [&categories](sqlite3_stmt* stmt) {
-        categories.push_back(
-            std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0))));
-    });
+    categories = this->m_store.GetCategoryNames();
 }
 
 std::size_t CategoryManager::GetCategoryID(const std::string& category) const
@@ -35,45 +39,37 @@ std::size_t CategoryManager::GetCategoryID(const std::string& category) const
         throw std::runtime_error("Category does not exist.");
     }
 
-    std::string query =
-        fmt::format("SELECT category_id FROM Category WHERE name = '{}';", category);
-
-    std::size_t id = 0;
-
-    this->m_dbManager.ExecuteQueryWithResult(query, [&id](sqlite3_stmt* stmt) {
-        id = sqlite3_column_int64(stmt, 0);
-    });
-
-    return id;
+    return this->m_store.FindCategory(category).value_or(0);
 }
 
 bool CategoryManager::CreateCategory(const std::string& name) noexcept
 {
-    std::string query = fmt::format("INSERT INTO Category (name) VALUES ('{}');", name);
+    LedgerStore::Transaction transaction(this->m_store);
+
+    if (not transaction.IsActive())
+    {
+        return false;
+    }
 
     if (this->CategoryExists(name))
     {
         this->m_logManager.Log("Category '" + name + "' already exists.");
         return false;
     }
-    else
+
+    if (not this->m_store.InsertCategory(name) or
+        not transaction.Commit())
     {
-        this->m_dbManager.ExecuteQuery(query);
-        this->m_logManager.Log("Category '" + name + "' created.");
-        return true;
+        this->m_logManager.Log("Failed to create category '" + name + "'.",
+                               spdlog::level::err);
+        return false;
     }
+
+    this->m_logManager.Log("Category '" + name + "' created.");
+    return true;
 }
 
 bool CategoryManager::CategoryExists(const std::string& name) const noexcept
 {
-    std::string query =
-        fmt::format("SELECT COUNT(*) FROM Category WHERE name = '{}';", name);
-
-    int count = 0;
-
-    this->m_dbManager.ExecuteQueryWithResult(query, [&count](sqlite3_stmt* stmt) {
-        count = sqlite3_column_int(stmt, 0);
-    });
-
-    return count > 0;
+    return this->m_store.FindCategory(name).has_value();
 }
@@ -0,0 +1,342 @@
+/*
+ * Filename: connection_pool.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include "connection_pool.h"
+#include "config.h"
+#include <utility>
+
+ConnectionPool::ReaderLease::ReaderLease(ConnectionPool* pool,
+                                         Connection*     connection) noexcept
+    : m_pool(pool),
+      m_connection(connection)
+{ }
+
+ConnectionPool::ReaderLease::ReaderLease() noexcept
+    : m_pool(nullptr),
+      m_connection(nullptr)
+{ }
+
+ConnectionPool::ReaderLease::ReaderLease(ReaderLease&& other) noexcept
+    : m_pool(std::exchange(other.m_pool, nullptr)),
+      m_connection(std::exchange(other.m_connection, nullptr))
+{ }
+
+ConnectionPool::ReaderLease&
+ConnectionPool::ReaderLease::operator=(ReaderLease&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (this->m_pool and this->m_connection)
+        {
+            this->m_pool->ReleaseReader(this->m_connection);
+        }
+
+        this->m_pool       = std::exchange(other.m_pool, nullptr);
+        this->m_connection = std::exchange(other.m_connection, nullptr);
+    }
+
+    return *this;
+}
+
+ConnectionPool::ReaderLease::~ReaderLease() noexcept
+{
+    if (this->m_pool and this->m_connection)
+    {
+        this->m_pool->ReleaseReader(this->m_connection);
+    }
+}
+
+Connection* ConnectionPool::ReaderLease::Get() const noexcept
+{
+    return this->m_connection;
+}
+
+ConnectionPool::ReaderLease::operator bool() const noexcept
+{
+    return this->m_connection != nullptr;
+}
+
+ConnectionPool::ConnectionPool(LogManager& logger) noexcept
+    : m_logger(logger),
+      m_maxReaders(0),
+      m_readerSettingsVersion(0)
+{ }
+
+ConnectionPool::~ConnectionPool() noexcept
+{
+    this->Close();
+}
+
+bool ConnectionPool::Open(const std::string& path) noexcept
+{
+    this->Close();
+
+    int rc = sqlite3_open_v2(path.c_str(),
+                             &this->m_writer.handle,
+                             SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE |
+                                 SQLITE_OPEN_URI,
+                             nullptr);
+
+    if (rc != SQLITE_OK)
+    {
+        this->m_logger.Log("Can't open database: " +
+                               std::string(sqlite3_errmsg(this->m_writer.handle)),
+                           spdlog::level::err);
+
+        sqlite3_close(this->m_writer.handle);
+        this->m_writer.handle = nullptr;
+        return false;
+    }
+
+    this->m_path = path;
+    this->m_writer.statementCache =
+        std::make_unique<StatementCache>(this->m_writer.handle,
+                                         config::STATEMENT_CACHE_CAPACITY);
+
+    if (this->m_connectionSetup)
+    {
+        this->m_connectionSetup(this->m_writer.handle);
+    }
+
+    return true;
+}
+
+void ConnectionPool::Close() noexcept
+{
+    std::lock_guard<std::mutex> lock(this->m_readerMutex);
+
+    for (std::unique_ptr<Connection>& reader : this->m_readers)
+    {
+        CloseConnection(*reader);
+    }
+
+    this->m_readers.clear();
+    this->m_idleReaders.clear();
+
+    CloseConnection(this->m_writer);
+}
+
+bool ConnectionPool::IsOpen() const noexcept
+{
+    return this->m_writer.handle != nullptr;
+}
+
+void ConnectionPool::SetConnectionSetup(std::function<void(sqlite3*)> setup) noexcept
+{
+    this->m_connectionSetup = std::move(setup);
+}
+
+void ConnectionPool::SetMaxReaders(std::size_t maxReaders) noexcept
+{
+    std::lock_guard<std::mutex> lock(this->m_readerMutex);
+
+    this->m_maxReaders = maxReaders;
+
+    // Close idle readers above the new limit. Readers in use are closed when they
+    // are returned
+    while (this->m_readers.size() > this->m_maxReaders and
+           not this->m_idleReaders.empty())
+    {
+        Connection* idle = this->m_idleReaders.back();
+        this->m_idleReaders.pop_back();
+
+        std::erase_if(this->m_readers, [idle](const std::unique_ptr<Connection>& c) {
+            if (c.get() == idle)
+            {
+                CloseConnection(*c);
+                return true;
+            }
+
+            return false;
+        });
+    }
+}
+
+void ConnectionPool::SetReaderSettings(std::function<void(sqlite3*)> settings) noexcept
+{
+    std::lock_guard<std::mutex> lock(this->m_readerMutex);
+
+    this->m_readerSettings = std::move(settings);
+    this->m_readerSettingsVersion++;
+}
+
+Connection& ConnectionPool::Writer() noexcept
+{
+    return this->m_writer;
+}
+
+std::recursive_mutex& ConnectionPool::WriterMutex() noexcept
+{
+    return this->m_writerMutex;
+}
+
+ConnectionPool::ReaderLease ConnectionPool::AcquireReader() noexcept
+{
+    std::unique_lock<std::mutex> lock(this->m_readerMutex);
+
+    if (not this->IsOpen() or this->m_maxReaders == 0)
+    {
+        return ReaderLease();
+    }
+
+    Connection* reader = nullptr;
+
+    if (not this->m_idleReaders.empty())
+    {
+        reader = this->m_idleReaders.back();
+        this->m_idleReaders.pop_back();
+    }
+    else if (this->m_readers.size() < this->m_maxReaders)
+    {
+        std::unique_ptr<Connection> opened = this->OpenReader();
+
+        if (not opened)
+        {
+            return ReaderLease();
+        }
+
+        reader = opened.get();
+        this->m_readers.push_back(std::move(opened));
+    }
+    else
+    {
+        // All readers are busy. Waiting here could deadlock a thread that already
+        // holds a reader, so the caller falls back to the writer
+        return ReaderLease();
+    }
+
+    if (reader->settingsVersion != this->m_readerSettingsVersion)
+    {
+        if (this->m_readerSettings)
+        {
+            this->m_readerSettings(reader->handle);
+        }
+
+        reader->settingsVersion = this->m_readerSettingsVersion;
+    }
+
+    return ReaderLease(this, reader);
+}
+
+std::size_t ConnectionPool::GetReaderCount() noexcept
+{
+    std::lock_guard<std::mutex> lock(this->m_readerMutex);
+    return this->m_readers.size();
+}
+
+StatementCache::Stats ConnectionPool::GetStatementCacheStats() noexcept
+{
+    StatementCache::Stats total;
+
+    auto add = [&total](const Connection& connection) {
+        if (not connection.statementCache)
+        {
+            return;
+        }
+
+        StatementCache::Stats stats = connection.statementCache->GetStats();
+
+        total.hits += stats.hits;
+        total.misses += stats.misses;
+        total.evictions += stats.evictions;
+        total.size += stats.size;
+        total.capacity += stats.capacity;
+    };
+
+    add(this->m_writer);
+
+    std::lock_guard<std::mutex> lock(this->m_readerMutex);
+
+    // The counters are atomic, so readers in use can also be inspected
+    for (const std::unique_ptr<Connection>& reader : this->m_readers)
+    {
+        add(*reader);
+    }
+
+    return total;
+}
+
+void ConnectionPool::ClearStatementCaches() noexcept
+{
+    if (this->m_writer.statementCache)
+    {
+        this->m_writer.statementCache->Clear();
+    }
+
+    std::lock_guard<std::mutex> lock(this->m_readerMutex);
+
+    for (Connection* reader : this->m_idleReaders)
+    {
+        reader->statementCache->Clear();
+    }
+}
+
+void ConnectionPool::ReleaseReader(Connection* connection) noexcept
+{
+    std::lock_guard<std::mutex> lock(this->m_readerMutex);
+
+    if (this->m_readers.size() > this->m_maxReaders)
+    {
+        std::erase_if(this->m_readers,
+                      [connection](const std::unique_ptr<Connection>& c) {
+                          if (c.get() == connection)
+                          {
+                              CloseConnection(*c);
+                              return true;
+                          }
+
+                          return false;
+                      });
+        return;
+    }
+
+    this->m_idleReaders.push_back(connection);
+}
+
+std::unique_ptr<Connection> ConnectionPool::OpenReader() noexcept
+{
+    auto reader = std::make_unique<Connection>();
+
+    int rc = sqlite3_open_v2(this->m_path.c_str(),
+                             &reader->handle,
+                             SQLITE_OPEN_READONLY | SQLITE_OPEN_URI,
+                             nullptr);
+
+    if (rc != SQLITE_OK)
+    {
+        this->m_logger.Log("Can't open reader connection: " +
+                               std::string(sqlite3_errmsg(reader->handle)),
+                           spdlog::level::err);
+
+        sqlite3_close(reader->handle);
+        return nullptr;
+    }
+
+    reader->statementCache =
+        std::make_unique<StatementCache>(reader->handle,
+                                         config::STATEMENT_CACHE_CAPACITY);
+
+    if (this->m_connectionSetup)
+    {
+        this->m_connectionSetup(reader->handle);
+    }
+
+    this->m_logger.Log("Reader connection opened", spdlog::level::debug);
+
+    return reader;
+}
+
+void ConnectionPool::CloseConnection(Connection& connection) noexcept
+{
+    // Cached statements must be finalized before the connection is closed
+    connection.statementCache.reset();
+
+    if (connection.handle)
+    {
+        sqlite3_close(connection.handle);
+        connection.handle = nullptr;
+    }
+}
@@ -7,15 +7,29 @@
 #include "credit_card_manager.h"
 #include "config.h"
 #include "db_manager.h"
+#include "sqlite_ledger_store.h"
 #include <cmath>
 #include <cstdint>
 #include <fmt/format.h>
+#include <optional>
 #include <stdexcept>
 #include <string>
 
 CreditCardManager::CreditCardManager() noexcept
-    : m_dbManager(DBManager::GetInstance()),
-      m_logManager(LogManager::GetInstance())
+    : CreditCardManager(DBManager::GetInstance())
+{ }
+
+CreditCardManager::CreditCardManager(DBManager& dbManager) noexcept
+    : m_ownedStore(std::make_unique<SqliteLedgerStore>(dbManager)),
+      m_store(*m_ownedStore),
+      m_logManager(LogManager::GetInstance()),
+      m_categoryManager(m_store)
+{ }
+
+CreditCardManager::CreditCardManager(LedgerStore& store) noexcept
+    : m_store(store),
+      m_logManager(LogManager::GetInstance()),
+      m_categoryManager(store)
 { }
 
 CreditCardManager::~CreditCardManager() noexcept { }
@@ -23,20 +37,13 @@ CreditCardManager::~CreditCardManager() noexcept { }
 void CreditCardManager::GetCreditCards(
     std::vector<std::string>& creditCards) const noexcept
 {
-    creditCards.clear();
-
-    std::string query = "SELECT number FROM CreditCard;";
-
-    this->m_dbManager.ExecuteQueryWithResult(query, [&creditCards](sqlite3_stmt* stmt) {
-        creditCards.push_back(
-            std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0))));
-    });
+    creditCards = this->m_store.GetCreditCardNumbers();
 }
 
 bool CreditCardManager::GetCreditCardInfo(const std::string& cardNumber,
                                           std::string&       cardName,
-                                          double_t&          maxDebt,
-                                          double_t&          totalPendingDebt,
+                                          Money&             maxDebt,
+                                          Money&             totalPendingDebt,
                                           uint16_t& billingDueDay) const noexcept
 {
     if (not this->CreditCardExists(cardNumber))
@@ -47,11 +54,6 @@ bool CreditCardManager::GetCreditCardInfo(const std::string& cardNumber,
         return false;
     }
 
-    std::string query =
-        fmt::format("SELECT name, max_debt, billing_due_day FROM CreditCard "
-                    "WHERE number = '{}';",
-                    cardNumber);
-
     try
     {
         totalPendingDebt = this->GetTotalPendingDebt(cardNumber);
@@ -62,21 +64,31 @@ bool CreditCardManager::GetCreditCardInfo(const std::string& cardNumber,
         return false;
     }
 
-    return this->m_dbManager.ExecuteQueryWithResult(
-        query,
-        [&cardName, &maxDebt, &billingDueDay](sqlite3_stmt* stmt) {
-            cardName = std::string(
-                reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
-            maxDebt       = sqlite3_column_double(stmt, 1);
-            billingDueDay = sqlite3_column_int(stmt, 2);
-        });
+    std::optional<CreditCardRecord> info = this->m_store.FindCreditCard(cardNumber);
+
+    if (not info)
+    {
+        return false;
+    }
+
+    cardName      = std::move(info->name);
+    maxDebt       = info->maxDebt;
+    billingDueDay = info->billingDueDay;
+    return true;
 }
 
 bool CreditCardManager::AddCreditCard(const std::string& cardNumber,
                                       const uint16_t     billingDueDay,
                                       const std::string& cardName,
-                                      const double_t     maxDebt) noexcept
+                                      const Money        maxDebt) noexcept
 {
+    LedgerStore::Transaction transaction(this->m_store);
+
+    if (not transaction.IsActive())
+    {
+        return false;
+    }
+
     if (this->CreditCardExists(cardNumber))
     {
         this->m_logManager.Log(
@@ -84,9 +96,9 @@ bool CreditCardManager::AddCreditCard(const std::string& cardNumber,
         return false;
     }
 
-    if (maxDebt <= 0)
+    if (not maxDebt.IsPositive())
     {
-        this->m_logManager.Log(fmt::format("Invalid max debt: {}", maxDebt));
+        this->m_logManager.Log(fmt::format("Invalid max debt: {}", maxDebt.ToString()));
         return false;
     }
 
@@ -101,15 +113,9 @@ bool CreditCardManager::AddCreditCard(const std::string& cardNumber,
         return false;
     }
 
-    std::string query =
-        fmt::format("INSERT INTO CreditCard (number, name, "
-                    "max_debt, billing_due_day) VALUES ('{}', '{}', '{}', {});",
-                    cardNumber,
-                    cardName,
-                    maxDebt,
-                    billingDueDay);
-
-    if (this->m_dbManager.ExecuteQuery(query))
+    if (this->m_store.InsertCreditCard(
+            { cardNumber, cardName, maxDebt, billingDueDay }) and
+        transaction.Commit())
     {
         this->m_logManager.Log(fmt::format("Credit card '{}' added.", cardName));
     }
@@ -126,10 +132,18 @@ bool CreditCardManager::AddCreditCard(const std::string& cardNumber,
 bool CreditCardManager::AddDebt(const std::string& cardNumber,
                                 const std::string& category,
                                 const std::string& date,
-                                const double_t     totalAmount,
+                                const Money        totalAmount,
                                 const std::string& description,
                                 const uint16_t     installments) noexcept
 {
+    // The debt and all its installments are committed together
+    LedgerStore::Transaction transaction(this->m_store);
+
+    if (not transaction.IsActive())
+    {
+        return false;
+    }
+
     if (not this->CreditCardExists(cardNumber))
     {
         this->m_logManager.Log(
@@ -137,9 +151,10 @@ bool CreditCardManager::AddDebt(const std::string& cardNumber,
         return false;
     }
 
-    if (totalAmount <= 0)
+    if (not totalAmount.IsPositive())
     {
-        this->m_logManager.Log(fmt::format("Invalid total amount: {}", totalAmount));
+        this->m_logManager.Log(
+            fmt::format("Invalid total amount: {}", totalAmount.ToString()));
         return false;
     }
 
@@ -156,7 +171,7 @@ bool CreditCardManager::AddDebt(const std::string& cardNumber,
         this->m_logManager.Log(
             fmt::format("Credit card '{}' has not enough credit for debt of {}.",
                         cardNumber,
-                        totalAmount));
+                        totalAmount.ToString()));
         return false;
     }
 
@@ -169,63 +184,47 @@ bool CreditCardManager::AddDebt(const std::string& cardNumber,
     }
 
     // Get category id
-    std::string getCategoryId =
-        fmt::format("SELECT category_id FROM Category WHERE name = '{}';", category);
-
-    uint32_t category_id = 0;
-
-    this->m_dbManager.ExecuteQueryWithResult(getCategoryId,
-                                             [&category_id](sqlite3_stmt* stmt) {
-                                                 category_id =
-                                                     sqlite3_column_int(stmt, 0);
-                                             });
+    int64_t category_id = this->m_store.FindCategory(category).value_or(0);
 
     // Insert debt
-    std::string insertDebt =
-        fmt::format("INSERT INTO CreditCardDebt (crc_number, category_id, "
-                    "date, total_amount, description) VALUES "
-                    "('{}', {}, '{}', '{}', '{}');",
-                    cardNumber,
-                    category_id,
-                    date,
-                    totalAmount,
-                    description);
-
-    if (this->m_dbManager.ExecuteQuery(insertDebt))
+    std::optional<int64_t> debt_id = this->m_store.InsertCreditCardDebt(
+        { cardNumber, category_id, date, totalAmount, description });
+
+    if (not debt_id or
+        not this->m_store.AddToSpendingSummary(SpendingOf(date,
+                                                          category_id,
+                                                          "CREDIT_CARD",
+                                                          cardNumber,
+                                                          totalAmount)))
     {
+        this->m_logManager.Log(
+            fmt::format("Failed to add debt for credit card '{}'.", cardNumber));
+        return false;
+    }
 
-        // Get debt id most recently added
-        std::string getDebtId =
-            "SELECT debt_id FROM CreditCardDebt ORDER BY debt_id DESC LIMIT 1;";
-
-        uint32_t debt_id = 0;
-
-        this->m_dbManager.ExecuteQueryWithResult(
-            getDebtId,
-            [&debt_id](sqlite3_stmt* stmt) { debt_id = sqlite3_column_int(stmt, 0); });
+    // Insert installments into CreditCardPayment
+    // The installments add up to the total, to the cent
+    uint16_t           billingDueDay      = this->GetBillingDueDay(cardNumber);
+    std::vector<Money> installmentAmounts = totalAmount.Split(installments);
 
-        // Insert installments into CreditCardPayment
-        double_t installmentAmount = totalAmount / installments;
+    for (uint16_t i = 1; i <= installments; i++)
+    {
+        // Get due date of the installment
+        std::string dueDate = this->GetInstallmentDueDate(billingDueDay, date, i);
 
-        for (uint32_t i = 1; i <= installments; i++)
+        // Insert installment
+        if (not this->m_store.InsertCreditCardPayment(
+                { *debt_id, std::nullopt, dueDate, installmentAmounts[i - 1], i }))
         {
-            // Get due date of the installment
-            std::string dueDate = this->GetInstallmentDueDate(cardNumber, date, i);
-
-            std::string insertInstallment =
-                fmt::format("INSERT INTO CreditCardPayment (debt_id, date, amount, "
-                            "installment) VALUES "
-                            "({}, '{}', {}, {});",
-                            debt_id,
-                            dueDate,
-                            installmentAmount,
-                            i);
-
-            // Insert installment
-            this->m_dbManager.ExecuteQuery(insertInstallment);
+            this->m_logManager.Log(
+                fmt::format("Failed to add installment {} for credit card '{}'.",
+                            i,
+                            cardNumber));
+            return false;
         }
     }
-    else
+
+    if (not transaction.Commit())
     {
         this->m_logManager.Log(
             fmt::format("Failed to add debt for credit card '{}'.", cardNumber));
@@ -238,7 +237,7 @@ bool CreditCardManager::AddDebt(const std::string& cardNumber,
 bool CreditCardManager::GetLastExpense(const std::string& cardNumber,
                                        std::string&       category,
                                        std::string&       date,
-                                       double_t&          totalAmount,
+                                       Money&             totalAmount,
                                        std::string&       description,
                                        uint16_t&          installments,
                                        uint32_t&          debtId) const noexcept
@@ -250,57 +249,30 @@ bool CreditCardManager::GetLastExpense(const std::string& cardNumber,
         return false;
     }
 
-    std::string query = fmt::format(
-        "SELECT CreditCardDebt.debt_id, Category.name, CreditCardDebt.date, "
-        "CreditCardDebt.total_amount, CreditCardDebt.description, "
-        "COUNT(CreditCardPayment.installment) AS installments "
-        "FROM CreditCardDebt "
-        "INNER JOIN Category "
-        "ON CreditCardDebt.category_id = Category.category_id "
-        "INNER JOIN CreditCardPayment "
-        "ON CreditCardDebt.debt_id = CreditCardPayment.debt_id "
-        "WHERE CreditCardDebt.crc_number = '{}' "
-        "GROUP BY CreditCardDebt.debt_id "
-        "ORDER BY CreditCardDebt.debt_id DESC LIMIT 1;",
-        cardNumber);
-
-    return this->m_dbManager.ExecuteQueryWithResult(
-        query,
-        [&debtId, &category, &date, &totalAmount, &description, &installments](
-            sqlite3_stmt* stmt) {
-            debtId = sqlite3_column_int(stmt, 0);
-
-            category = std::string(
-                reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
-
-            date = std::string(
-                reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)));
-
-            totalAmount = sqlite3_column_double(stmt, 3);
-
-            description = std::string(
-                reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4)));
-
-            installments = sqlite3_column_int(stmt, 5);
-        });
+    std::optional<CreditCardExpense> expense =
+        this->m_store.GetLastCreditCardExpense(cardNumber);
+
+    if (not expense)
+    {
+        return false;
+    }
+
+    debtId       = expense->debtId;
+    category     = std::move(expense->category);
+    date         = std::move(expense->date);
+    totalAmount  = expense->totalAmount;
+    description  = std::move(expense->description);
+    installments = expense->installments;
+    return true;
 }
 
 bool CreditCardManager::CreditCardExists(const std::string& cardNumber) const noexcept
 {
     // Query to get the number of credit cards with the given number
-    std::string query =
-        fmt::format("SELECT COUNT(*) FROM CreditCard WHERE number = '{}';", cardNumber);
-
-    int count = 0;
-
-    this->m_dbManager.ExecuteQueryWithResult(query, [&count](sqlite3_stmt* stmt) {
-        count = sqlite3_column_int(stmt, 0);
-    });
-
-    return count > 0;
+    return this->m_store.FindCreditCard(cardNumber).has_value();
 }
 
-double_t CreditCardManager::GetMaxDebt(const std::string& cardNumber) const
+Money CreditCardManager::GetMaxDebt(const std::string& cardNumber) const
 {
     if (not this->CreditCardExists(cardNumber))
     {
@@ -311,20 +283,13 @@ double_t CreditCardManager::GetMaxDebt(const std::string& cardNumber) const
             fmt::format("Credit card '{}' does not exist.", cardNumber));
     }
 
-    // Query to get the max debt of the credit card
-    std::string query =
-        fmt::format("SELECT max_debt FROM CreditCard WHERE number = '{}';", cardNumber);
-
-    double_t maxDebt = 0;
-
-    this->m_dbManager.ExecuteQueryWithResult(query, [&maxDebt](sqlite3_stmt* stmt) {
-        maxDebt = sqlite3_column_double(stmt, 0);
-    });
+    std::optional<CreditCardRecord> creditCard =
+        this->m_store.FindCreditCard(cardNumber);
 
-    return maxDebt;
+    return creditCard ? creditCard->maxDebt : Money();
 }
 
-double_t CreditCardManager::GetTotalPendingDebt(const std::string& cardNumber) const
+Money CreditCardManager::GetTotalPendingDebt(const std::string& cardNumber) const
 {
     if (not this->CreditCardExists(cardNumber))
     {
@@ -335,41 +300,24 @@ double_t CreditCardManager::GetTotalPendingDebt(const std::string& cardNumber) c
             fmt::format("Credit card '{}' does not exist.", cardNumber));
     }
 
-    // CreditCardPayment.wallet NULL means that the installment has not been paid yet
-    std::string query =
-        fmt::format("SELECT SUM(CreditCardPayment.amount) AS total_amount "
-                    "FROM CreditCardDebt "
-                    "INNER JOIN CreditCardPayment "
-                    "ON CreditCardDebt.debt_id = CreditCardPayment.debt_id "
-                    "WHERE CreditCardDebt.crc_number = '{}' "
-                    "AND CreditCardPayment.wallet IS NULL;",
-                    cardNumber);
-
-    double_t totalPendingDebt = 0;
-
-    this->m_dbManager.ExecuteQueryWithResult(query,
-                                             [&totalPendingDebt](sqlite3_stmt* stmt) {
-                                                 totalPendingDebt =
-                                                     sqlite3_column_double(stmt, 0);
-                                             });
-
-    return totalPendingDebt;
+    return this->m_store.GetPendingDebt(cardNumber);
 }
 
 bool CreditCardManager::HasEnoughCredit(const std::string& cardNumber,
-                                        const double_t     expense) const
+                                        const Money        expense) const
 {
-    double_t maxDebt          = this->GetMaxDebt(cardNumber);
-    double_t totalPendingDebt = this->GetTotalPendingDebt(cardNumber);
+    Money maxDebt          = this->GetMaxDebt(cardNumber);
+    Money totalPendingDebt = this->GetTotalPendingDebt(cardNumber);
 
     return maxDebt - totalPendingDebt >= expense;
 }
 
-std::string CreditCardManager::GetInstallmentDueDate(const std::string& cardNumber,
-                                                     const std::string& purchaseDate,
-                                                     uint16_t installmentNumber) const
+uint16_t CreditCardManager::GetBillingDueDay(const std::string& cardNumber) const
 {
-    if (not this->CreditCardExists(cardNumber))
+    std::optional<CreditCardRecord> creditCard =
+        this->m_store.FindCreditCard(cardNumber);
+
+    if (not creditCard)
     {
         this->m_logManager.Log(
             fmt::format("Credit card '{}' does not exist.", cardNumber));
@@ -378,19 +326,14 @@ std::string CreditCardManager::GetInstallmentDueDate(const std::string& cardNumb
             fmt::format("Credit card '{}' does not exist.", cardNumber));
     }
 
-    // Query to get the due date of the installment
-    std::string query =
-        fmt::format("SELECT billing_due_day FROM CreditCard WHERE number = '{}';",
-                    cardNumber);
-
-    uint16_t billingDueDay = 0;
-
-    this->m_dbManager.ExecuteQueryWithResult(query,
-                                             [&billingDueDay](sqlite3_stmt* stmt) {
-                                                 billingDueDay =
-                                                     sqlite3_column_int(stmt, 0);
-                                             });
+    return creditCard->billingDueDay;
+}
 
+std::string
+CreditCardManager::GetInstallmentDueDate(const uint16_t     billingDueDay,
+                                         const std::string& purchaseDate,
+                                         uint16_t           installmentNumber) const
+{
     std::tm purchaseDateTm = utils::String2Date(purchaseDate);
 
     // Getting the due date of the installment
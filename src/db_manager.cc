@@ -8,20 +8,182 @@
 #include "config.h"
 #include "log_manager.h"
 #include "sql_queries.h"
+#include <algorithm>
 #include <cstdlib>
 #include <filesystem>
+#include <fmt/format.h>
+#include <strings.h>
 #include <spdlog/common.h>
+#include <memory>
 #include <sqlite3.h>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
 
-DBManager::DBManager()
-    : m_logger(LogManager::GetInstance())
+DBManager::Transaction::Transaction(DBManager& db) noexcept
+    : m_dbManager(db),
+      m_writerLock(db.m_pool.WriterMutex()),
+      m_active(false)
 {
-    // Check if path to database exists and try to create it if it doesn't
+    if (this->m_dbManager.m_transactionDepth == 0)
+    {
+        this->m_active = this->m_dbManager.ExecuteQuery("BEGIN IMMEDIATE;");
+    }
+    else
+    {
+        this->m_savepoint =
+            "sp_" + std::to_string(this->m_dbManager.m_transactionDepth);
+        this->m_active =
+            this->m_dbManager.ExecuteQuery("SAVEPOINT " + this->m_savepoint + ";");
+    }
+
+    if (this->m_active)
+    {
+        if (this->m_dbManager.m_transactionDepth == 0)
+        {
+            this->m_dbManager.m_transactionOwner = std::this_thread::get_id();
+        }
+
+        this->m_dbManager.m_transactionDepth++;
+    }
+    else
+    {
+        this->m_dbManager.m_logger.Log("Failed to begin transaction",
+                                       spdlog::level::err);
+        this->m_writerLock.unlock();
+    }
+}
+
+DBManager::Transaction::~Transaction() noexcept
+{
+    this->Rollback();
+}
+
+bool DBManager::Transaction::Commit() noexcept
+{
+    if (not this->m_active)
+    {
+        return false;
+    }
+
+    bool committed =
+        this->m_savepoint.empty()
+            ? this->m_dbManager.ExecuteQuery("COMMIT;")
+            : this->m_dbManager.ExecuteQuery("RELEASE " + this->m_savepoint + ";");
+
+    if (not committed)
+    {
+        this->m_dbManager.m_logger.Log("Failed to commit transaction",
+                                       spdlog::level::err);
+        this->Rollback();
+        return false;
+    }
+
+    uint32_t depth   = this->m_dbManager.m_transactionDepth;
+    auto&    actions = this->m_dbManager.m_commitActions;
+
+    if (depth == 1)
+    {
+        // Run while the writer is still held, so the next commit waits for them
+        for (auto& entry : std::exchange(actions, {}))
+        {
+            entry.second();
+        }
+    }
+    else
+    {
+        // The actions of a released savepoint now wait for the enclosing scope
+        for (auto& [level, action] : actions)
+        {
+            level = std::min(level, depth - 1);
+        }
+    }
+
+    this->End();
+    return true;
+}
+
+void DBManager::Transaction::Rollback() noexcept
+{
+    if (not this->m_active)
+    {
+        return;
+    }
+
+    if (this->m_savepoint.empty())
+    {
+        // SQLite may have rolled back the transaction by itself after an error
+        if (not sqlite3_get_autocommit(this->m_dbManager.m_pool.Writer().handle))
+        {
+            this->m_dbManager.ExecuteQuery("ROLLBACK;");
+        }
+    }
+    else
+    {
+        // Rolling back to a savepoint keeps it open, so it must also be released
+        this->m_dbManager.ExecuteQuery("ROLLBACK TO " + this->m_savepoint + ";");
+        this->m_dbManager.ExecuteQuery("RELEASE " + this->m_savepoint + ";");
+    }
+
+    // The actions added in this scope are dropped with its writes
+    std::erase_if(this->m_dbManager.m_commitActions,
+                  [depth = this->m_dbManager.m_transactionDepth](const auto& action) {
+                      return action.first >= depth;
+                  });
+
+    this->End();
+}
+
+bool DBManager::Transaction::IsActive() const noexcept
+{
+    return this->m_active;
+}
+
+void DBManager::Transaction::End() noexcept
+{
+    this->m_active = false;
+    this->m_dbManager.m_transactionDepth--;
+
+    if (this->m_dbManager.m_transactionDepth == 0)
+    {
+        this->m_dbManager.m_transactionOwner = std::thread::id();
+    }
+
+    this->m_writerLock.unlock();
+}
+
+DBManager::DBManager(const std::string& openSpec)
+    : m_logger(LogManager::GetInstance()),
+      m_slowQueryLog(m_logger, config::SLOW_QUERY_THRESHOLD),
+      m_pool(m_logger),
+      m_transactionDepth(0),
+      m_restoreCount(0),
+      m_storageProfile(&config::STORAGE_PROFILE_BALANCED),
+      m_activeBackups(0),
+      m_closing(false)
+{
+    // Each phase of the startup is timed from the end of the previous one
+    auto phaseStart = std::chrono::steady_clock::now();
+    auto endPhase   = [&phaseStart](std::chrono::nanoseconds& phase) {
+        auto now   = std::chrono::steady_clock::now();
+        phase      = now - phaseStart;
+        phaseStart = now;
+    };
+
+    // Create the directory of a database file if it doesn't exist. In-memory
+    // databases and URIs have no directory to create
+    bool isFile = openSpec != config::IN_MEMORY_DATABASE and
+                  not openSpec.starts_with("file:");
+
     try
     {
-        if (not std::filesystem::exists(config::DATABASE_PATH))
+        std::filesystem::path directory = std::filesystem::path(openSpec).parent_path();
+
+        if (isFile and not directory.empty() and
+            not std::filesystem::exists(directory))
         {
-            std::filesystem::create_directories(config::DATABASE_PATH);
+            std::filesystem::create_directories(directory);
             this->m_logger.Log("Database directory created", spdlog::level::debug);
         }
     }
@@ -32,118 +194,733 @@ DBManager::DBManager()
                            spdlog::level::err);
     }
 
+    endPhase(this->m_startupReport.directory);
+
+    // Every connection reports the statements it runs to the profiler, which
+    // sends the slow ones to the slow query log
+    this->m_profiler.SetSlowQueryLog(&this->m_slowQueryLog);
+    this->m_pool.SetConnectionSetup(
+        [this](sqlite3* db) { this->m_profiler.Attach(db); });
+
     // Open database
-    bool rc = sqlite3_open(config::DATABASE_FULL_PATH.c_str(), &this->m_db);
-    if (rc)
+    bool opened = this->m_pool.Open(openSpec);
+
+    endPhase(this->m_startupReport.open);
+
+    if (opened)
     {
-        this->m_logger.Log("Can't open database: " +
-                               std::string(sqlite3_errmsg(this->m_db)),
-                           spdlog::level::debug);
+        // Apply the storage profile chosen through the environment, if any
+        const char* profileName = std::getenv(config::STORAGE_PROFILE_ENV);
+        const config::StorageProfile* profile =
+            config::FindStorageProfile(profileName ? profileName
+                                                   : config::DEFAULT_STORAGE_PROFILE);
+
+        if (not profile)
+        {
+            this->m_logger.Log(fmt::format("Unknown storage profile '{}'. Using '{}'",
+                                           profileName,
+                                           config::DEFAULT_STORAGE_PROFILE),
+                               spdlog::level::warn);
 
-        sqlite3_close(this->m_db);
-        this->m_db = nullptr;
+            profile = config::FindStorageProfile(config::DEFAULT_STORAGE_PROFILE);
+        }
+
+        this->SetStorageProfile(*profile);
     }
-    else
+
+    endPhase(this->m_startupReport.profile);
+
+    // A database set up with this same schema needs no DDL. Otherwise the tables
+    // are created, the migrations applied and the new fingerprint stored
+    uint64_t fingerprint = GetSchemaFingerprint();
+
+    this->m_startupReport.schemaUpToDate = this->ReadSchemaFingerprint() == fingerprint;
+
+    if (not this->m_startupReport.schemaUpToDate)
     {
-        std::cout << "Database opened successfully" << std::endl;
-        this->m_logger.Log("Opened database successfully", spdlog::level::debug);
+        this->CreateTables();
+
+        if (not this->Migrate(query::MIGRATIONS))
+        {
+            throw std::runtime_error("Error migrating the database schema");
+        }
+
+        if (not this->Execute(query::UPDATE_SCHEMA_FINGERPRINT,
+                              static_cast<int64_t>(fingerprint)))
+        {
+            this->m_logger.Log("Failed to store the schema fingerprint",
+                               spdlog::level::warn);
+        }
     }
 
-    this->CreateTables();
+    endPhase(this->m_startupReport.schema);
+
+    const StartupReport& report = this->m_startupReport;
+
+    auto ms = [](std::chrono::nanoseconds phase) {
+        return std::chrono::duration<double, std::milli>(phase).count();
+    };
+
+    this->m_logger.Log(fmt::format("Opened database {} in {:.3f} ms (directory "
+                                   "{:.3f} ms, open {:.3f} ms, profile {:.3f} ms, "
+                                   "schema {:.3f} ms, {})",
+                                   openSpec,
+                                   ms(report.Total()),
+                                   ms(report.directory),
+                                   ms(report.open),
+                                   ms(report.profile),
+                                   ms(report.schema),
+                                   report.schemaUpToDate ? "up to date"
+                                                         : "DDL applied"),
+                       spdlog::level::debug);
+}
+
+std::chrono::nanoseconds DBManager::StartupReport::Total() const noexcept
+{
+    return this->directory + this->open + this->profile + this->schema;
 }
 
 DBManager::~DBManager() noexcept
 {
-    if (this->m_db)
+    // Running backups stop at their next step
+    this->m_closing = true;
+
     {
-        sqlite3_close(this->m_db);
+        std::unique_lock<std::mutex> lock(this->m_backupMutex);
+
+        while (this->m_activeBackups > 0)
+        {
+            this->m_backupFinished.wait_for(lock, std::chrono::milliseconds(100));
+        }
+    }
+
+    // Pending asynchronous writes are committed before the connections are closed
+    this->m_asyncWriter.reset();
+
+    if (this->m_pool.IsOpen())
+    {
+        this->m_pool.Close();
         this->m_logger.Log("Database closed", spdlog::level::debug);
     }
+
+    // Regressions show up in the log of every run
+    this->m_logger.Log("Query statistics:\n" + this->m_profiler.Report());
 }
 
 DBManager& DBManager::GetInstance() noexcept
 {
-    static DBManager instance;
+    static DBManager instance(std::getenv(config::DATABASE_ENV)
+                                  ? std::getenv(config::DATABASE_ENV)
+                                  : config::DATABASE_FULL_PATH);
     return instance;
 }
 
 bool DBManager::ExecuteQuery(const std::string& query) noexcept
 {
-    if (not this->m_db)
+    std::lock_guard<std::recursive_mutex> lock(this->m_pool.WriterMutex());
+
+    Connection& writer = this->m_pool.Writer();
+
+    if (not writer.handle)
     {
         this->m_logger.Log("Database is not open", spdlog::level::err);
         return false;
     }
 
-    char* errMsg = nullptr;
-
     this->m_logger.Log("Executing query: " + query, spdlog::level::debug);
 
-    int rc = sqlite3_exec(this->m_db, query.c_str(), nullptr, nullptr, &errMsg);
+    StatementCache::Lease stmt = writer.statementCache->Acquire(query);
+
+    if (stmt.HasTail())
+    {
+        // Scripts with several statements are not cached
+        char* errMsg = nullptr;
+
+        int rc = sqlite3_exec(writer.handle, query.c_str(), nullptr, nullptr, &errMsg);
+
+        if (rc != SQLITE_OK)
+        {
+            this->m_logger.Log("SQL error: " + std::string(errMsg),
+                               spdlog::level::err);
+            sqlite3_free(errMsg);
+            return false;
+        }
+
+        return true;
+    }
+
+    if (not stmt)
+    {
+        this->LogError(writer.handle, "SQL error");
+        return false;
+    }
 
-    if (rc != SQLITE_OK)
+    // Rows produced by the command are discarded
+    int rc;
+    do
+    {
+        rc = sqlite3_step(stmt.Get());
+    } while (rc == SQLITE_ROW);
+
+    if (rc != SQLITE_DONE)
     {
-        this->m_logger.Log("SQL error: " + std::string(errMsg), spdlog::level::err);
-        sqlite3_free(errMsg);
+        this->LogError(writer.handle, "SQL error");
         return false;
     }
 
     return true;
 }
 
-bool DBManager::ExecuteQueryWithResult(
-    const std::string&                 query,
-    std::function<void(sqlite3_stmt*)> callback) const
+std::future<bool> DBManager::Enqueue(std::function<bool()> operation) noexcept
+{
+    return this->GetAsyncWriter().Enqueue(std::move(operation));
+}
+
+void DBManager::AfterCommit(std::function<void()> action) noexcept
+{
+    if (this->m_transactionOwner.load() != std::this_thread::get_id())
+    {
+        action();
+        return;
+    }
+
+    this->m_commitActions.emplace_back(this->m_transactionDepth, std::move(action));
+}
+
+bool DBManager::Flush() noexcept
+{
+    if (this->m_transactionOwner.load() == std::this_thread::get_id())
+    {
+        this->m_logger.Log("Flush cannot be called inside a transaction",
+                           spdlog::level::err);
+        return false;
+    }
+
+    return this->GetAsyncWriter().Flush();
+}
+
+AsyncWriter::Stats DBManager::GetAsyncWriterStats() const noexcept
+{
+    return this->m_asyncWriter ? this->m_asyncWriter->GetStats() : AsyncWriter::Stats();
+}
+
+bool DBManager::SetStorageProfile(const config::StorageProfile& profile) noexcept
 {
-    if (not m_db)
+    std::lock_guard<std::recursive_mutex> lock(this->m_pool.WriterMutex());
+
+    Connection& writer = this->m_pool.Writer();
+
+    if (not writer.handle)
     {
         this->m_logger.Log("Database is not open", spdlog::level::err);
         return false;
     }
 
-    sqlite3_stmt* stmt;
+    if (this->m_transactionDepth > 0)
+    {
+        this->m_logger.Log("Storage profile cannot be changed inside a transaction",
+                           spdlog::level::err);
+        return false;
+    }
 
-    this->m_logger.Log("Executing query: " + query, spdlog::level::debug);
+    sqlite3_busy_timeout(writer.handle, static_cast<int>(profile.busyTimeoutMs));
+
+    bool ok = true;
+
+    // The page size must be set before the journal mode, since it cannot be
+    // changed once the database is in WAL mode
+    if (not this->ExecuteQuery(fmt::format("PRAGMA page_size = {};", profile.pageSize)))
+    {
+        ok = false;
+    }
+
+    std::string journalMode;
 
-    int rc = sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, nullptr);
+    auto readJournalMode = [&journalMode](sqlite3_stmt* stmt) {
+        journalMode = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    };
 
-    if (rc != SQLITE_OK)
+    if (StatementHandle stmt =
+            this->PrepareStatement(fmt::format("PRAGMA journal_mode = {};",
+                                               profile.journalMode),
+                                   Route::Writer))
     {
-        this->m_logger.Log("SQL error: " + std::string(sqlite3_errmsg(m_db)),
+        this->StepRows(stmt.Get(), readJournalMode);
+    }
+
+    // In-memory databases keep their own journal mode without reporting an error
+    if (strcasecmp(journalMode.c_str(), profile.journalMode) != 0)
+    {
+        this->m_logger.Log(fmt::format("Journal mode '{}' requested, '{}' in use",
+                                       profile.journalMode,
+                                       journalMode),
+                           spdlog::level::warn);
+    }
+
+    const std::string pragmas[] = {
+        fmt::format("PRAGMA synchronous = {};", profile.synchronous),
+        fmt::format("PRAGMA cache_size = {};", profile.cacheSize),
+        fmt::format("PRAGMA mmap_size = {};", profile.mmapSize),
+        fmt::format("PRAGMA temp_store = {};", profile.tempStore)
+    };
+
+    std::string readerPragmas;
+
+    for (const std::string& pragma : pragmas)
+    {
+        if (not this->ExecuteQuery(pragma))
+        {
+            ok = false;
+        }
+
+        readerPragmas += pragma;
+    }
+
+    // Without WAL, readers would block the writer on commit and vice versa
+    bool walMode = strcasecmp(journalMode.c_str(), "wal") == 0;
+
+    this->m_pool.SetMaxReaders(walMode ? config::READER_CONNECTIONS : 0);
+    this->m_pool.SetReaderSettings(
+        [this, readerPragmas, busyTimeoutMs = profile.busyTimeoutMs](sqlite3* db) {
+            sqlite3_busy_timeout(db, static_cast<int>(busyTimeoutMs));
+
+            char* errMsg = nullptr;
+
+            if (sqlite3_exec(db, readerPragmas.c_str(), nullptr, nullptr, &errMsg) !=
+                SQLITE_OK)
+            {
+                this->m_logger.Log("Error configuring reader connection: " +
+                                       std::string(errMsg),
+                                   spdlog::level::warn);
+                sqlite3_free(errMsg);
+            }
+        });
+
+    this->m_storageProfile = &profile;
+
+    this->m_logger.Log(fmt::format("Storage profile '{}' applied", profile.name),
+                       spdlog::level::debug);
+
+    return ok;
+}
+
+bool DBManager::SetStorageProfile(std::string_view name) noexcept
+{
+    const config::StorageProfile* profile = config::FindStorageProfile(name);
+
+    if (not profile)
+    {
+        this->m_logger.Log("Unknown storage profile '" + std::string(name) + "'",
                            spdlog::level::err);
         return false;
     }
 
-    bool rowFetched = false;
-    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    return this->SetStorageProfile(*profile);
+}
+
+const config::StorageProfile& DBManager::GetStorageProfile() const noexcept
+{
+    return *this->m_storageProfile;
+}
+
+std::future<bool> DBManager::Backup(const std::string& destination,
+                                    int                pagesPerStep,
+                                    BackupProgress     progress) noexcept
+{
+    auto              done   = std::make_shared<std::promise<bool>>();
+    std::future<bool> result = done->get_future();
+
     {
-        rowFetched = true;
-        callback(stmt);
+        std::lock_guard<std::mutex> lock(this->m_backupMutex);
+        this->m_activeBackups++;
     }
 
-    if (rc != SQLITE_DONE)
+    auto finish = [this, done](bool ok) {
+        done->set_value(ok);
+
+        std::lock_guard<std::mutex> lock(this->m_backupMutex);
+        this->m_activeBackups--;
+        this->m_backupFinished.notify_all();
+    };
+
+    try
+    {
+        std::thread([this, destination, pagesPerStep, progress, finish]() {
+            finish(this->RunBackup(destination, pagesPerStep, progress));
+        }).detach();
+    }
+    catch (const std::system_error& e)
     {
-        this->m_logger.Log("SQL error on step: " + std::string(sqlite3_errmsg(m_db)),
+        this->m_logger.Log("Failed to start backup: " + std::string(e.what()),
                            spdlog::level::err);
-        sqlite3_finalize(stmt);
+        finish(false);
+    }
+
+    return result;
+}
+
+bool DBManager::Restore(const std::string& source) noexcept
+{
+    std::lock_guard<std::recursive_mutex> lock(this->m_pool.WriterMutex());
+
+    sqlite3* writer = this->m_pool.Writer().handle;
+
+    if (not writer)
+    {
+        this->m_logger.Log("Database is not open", spdlog::level::err);
         return false;
     }
 
-    sqlite3_finalize(stmt);
+    if (this->m_transactionDepth > 0)
+    {
+        this->m_logger.Log("Database cannot be restored inside a transaction",
+                           spdlog::level::err);
+        return false;
+    }
 
-    if (not rowFetched)
+    sqlite3* origin = nullptr;
+
+    if (sqlite3_open_v2(source.c_str(),
+                        &origin,
+                        SQLITE_OPEN_READONLY | SQLITE_OPEN_URI,
+                        nullptr) != SQLITE_OK)
+    {
+        this->LogError(origin, "Can't open backup " + source);
+        sqlite3_close(origin);
+        return false;
+    }
+
+    sqlite3_backup* backup = sqlite3_backup_init(writer, "main", origin, "main");
+
+    if (not backup)
+    {
+        this->LogError(writer, "Restore failed");
+        sqlite3_close(origin);
+        return false;
+    }
+
+    // A single step copies the whole database under one lock
+    int rc       = sqlite3_backup_step(backup, -1);
+    int finishRc = sqlite3_backup_finish(backup);
+
+    sqlite3_close(origin);
+
+    if (rc != SQLITE_DONE or finishRc != SQLITE_OK)
+    {
+        this->LogError(writer, "Restore failed");
+        return false;
+    }
+
+    this->m_logger.Log("Database restored from " + source);
+
+    // The cached statements were prepared against the schema that was replaced
+    this->m_pool.ClearStatementCaches();
+    this->m_restoreCount++;
+
+    // Backups taken before a migration lack the tables added since, and are then
+    // brought up to date as a new database would be
+    try
+    {
+        this->CreateTables();
+    }
+    catch (const std::exception& e)
+    {
+        this->m_logger.Log(e.what(), spdlog::level::err);
+        return false;
+    }
+
+    if (not this->Migrate(query::MIGRATIONS))
     {
-        this->m_logger.Log("No rows fetched by query", spdlog::level::debug);
         return false;
     }
 
+    if (not this->Execute(query::UPDATE_SCHEMA_FINGERPRINT,
+                          static_cast<int64_t>(GetSchemaFingerprint())))
+    {
+        this->m_logger.Log("Failed to store the schema fingerprint",
+                           spdlog::level::warn);
+    }
+
+    return true;
+}
+
+uint64_t DBManager::GetRestoreCount() const noexcept
+{
+    return this->m_restoreCount.load();
+}
+
+std::vector<QueryProfiler::Stats> DBManager::GetQueryStats() const
+{
+    return this->m_profiler.GetStats();
+}
+
+void DBManager::ResetQueryStats() noexcept
+{
+    this->m_profiler.Reset();
+}
+
+void DBManager::SetSlowQueryThreshold(std::chrono::nanoseconds threshold) noexcept
+{
+    this->m_slowQueryLog.SetThreshold(threshold);
+}
+
+uint64_t DBManager::GetSlowQueryCount() const noexcept
+{
+    return this->m_slowQueryLog.GetCount();
+}
+
+std::string DBManager::GetSlowQueryPlan(std::string_view sql) noexcept
+{
+    // SQLite reports statements without the terminating semicolon
+    if (sql.ends_with(';'))
+    {
+        sql.remove_suffix(1);
+    }
+
+    return this->m_slowQueryLog.GetPlan(sql);
+}
+
+uint32_t DBManager::GetSchemaVersion() const noexcept
+{
+    uint32_t version = 0;
+
+    this->ExecuteQueryWithResult("PRAGMA user_version;",
+                                 [&version](sqlite3_stmt* stmt) {
+                                     version = static_cast<uint32_t>(
+                                         sqlite3_column_int64(stmt, 0));
+                                 });
+
+    return version;
+}
+
+bool DBManager::Migrate(std::span<const query::Migration> migrations) noexcept
+{
+    if (migrations.empty() or migrations.back().version <= this->GetSchemaVersion())
+    {
+        return true;
+    }
+
+    uint32_t previous = 0;
+
+    for (const query::Migration& migration : migrations)
+    {
+        if (migration.version <= previous)
+        {
+            this->m_logger.Log(fmt::format("Migration {} is out of order",
+                                           migration.version),
+                               spdlog::level::err);
+            return false;
+        }
+
+        previous = migration.version;
+
+        Transaction transaction(*this);
+
+        if (not transaction.IsActive())
+        {
+            return false;
+        }
+
+        // Read inside the transaction, since another process may have applied the
+        // migration in the meantime
+        if (migration.version <= this->GetSchemaVersion())
+        {
+            continue;
+        }
+
+        if (not this->ExecuteQuery(std::string(migration.script)) or
+            not this->ExecuteQuery(
+                fmt::format("PRAGMA user_version = {};", migration.version)) or
+            not transaction.Commit())
+        {
+            this->m_logger.Log(fmt::format("Failed to apply migration {}: {}",
+                                           migration.version,
+                                           migration.description),
+                               spdlog::level::err);
+            return false;
+        }
+
+        this->m_logger.Log(fmt::format("Schema migrated to version {}: {}",
+                                       migration.version,
+                                       migration.description));
+    }
+
     return true;
 }
 
+uint64_t DBManager::GetSchemaFingerprint() noexcept
+{
+    static const uint64_t fingerprint = [] {
+        uint64_t hash = 14695981039346656037ULL;
+
+        auto add = [&hash](std::string_view text) {
+            for (char c : text)
+            {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 1099511628211ULL;
+            }
+
+            // Separate consecutive texts, so moving text between them changes
+            // the hash
+            hash ^= 0xff;
+            hash *= 1099511628211ULL;
+        };
+
+        for (const query::Table& table : query::TABLES)
+        {
+            add(table.create);
+        }
+
+        for (const query::Migration& migration : query::MIGRATIONS)
+        {
+            add(std::to_string(migration.version));
+            add(migration.script);
+        }
+
+        return hash;
+    }();
+
+    return fingerprint;
+}
+
+const DBManager::StartupReport& DBManager::GetStartupReport() const noexcept
+{
+    return this->m_startupReport;
+}
+
+int64_t DBManager::LastInsertRowId() const noexcept
+{
+    std::lock_guard<std::recursive_mutex> lock(this->m_pool.WriterMutex());
+
+    sqlite3* writer = this->m_pool.Writer().handle;
+
+    return writer ? sqlite3_last_insert_rowid(writer) : 0;
+}
+
+StatementCache::Stats DBManager::GetStatementCacheStats() const noexcept
+{
+    return this->m_pool.GetStatementCacheStats();
+}
+
+void DBManager::ClearStatementCache() noexcept
+{
+    std::lock_guard<std::recursive_mutex> lock(this->m_pool.WriterMutex());
+
+    this->m_pool.ClearStatementCaches();
+}
+
+DBManager::StatementHandle DBManager::PrepareStatement(std::string_view query,
+                                                       Route route) const noexcept
+{
+    StatementHandle handle;
+
+    if (not this->m_pool.IsOpen())
+    {
+        this->m_logger.Log("Database is not open", spdlog::level::err);
+        return handle;
+    }
+
+    this->m_logger.Log("Executing query: " + std::string(query), spdlog::level::debug);
+
+    // The thread that owns the open transaction must see its own changes
+    if (route == Route::Reader and
+        this->m_transactionOwner.load() != std::this_thread::get_id())
+    {
+        handle.reader = this->m_pool.AcquireReader();
+
+        if (handle.reader)
+        {
+            handle.stmt = handle.reader.Get()->statementCache->Acquire(query);
+
+            if (handle.stmt and sqlite3_stmt_readonly(handle.stmt.Get()))
+            {
+                return handle;
+            }
+
+            // Statements that write, or that failed on the reader, go to the writer
+            handle.stmt   = StatementCache::Lease();
+            handle.reader = ConnectionPool::ReaderLease();
+        }
+    }
+
+    handle.writerLock =
+        std::unique_lock<std::recursive_mutex>(this->m_pool.WriterMutex());
+    handle.stmt = this->m_pool.Writer().statementCache->Acquire(query);
+
+    if (handle.stmt.HasTail())
+    {
+        this->m_logger.Log("Query must contain a single statement: " +
+                               std::string(query),
+                           spdlog::level::err);
+    }
+    else if (not handle.stmt)
+    {
+        this->LogError(this->m_pool.Writer().handle, "SQL error");
+    }
+
+    return handle;
+}
+
+int DBManager::BindParameter(sqlite3_stmt* stmt, int index, std::nullptr_t) noexcept
+{
+    return sqlite3_bind_null(stmt, index);
+}
+
+int DBManager::BindParameter(sqlite3_stmt* stmt, int index, std::nullopt_t) noexcept
+{
+    return sqlite3_bind_null(stmt, index);
+}
+
+int DBManager::BindParameter(sqlite3_stmt* stmt, int index, double value) noexcept
+{
+    return sqlite3_bind_double(stmt, index, value);
+}
+
+int DBManager::BindParameter(sqlite3_stmt* stmt, int index, Money value) noexcept
+{
+    // Amounts and balances are stored as cents
+    return sqlite3_bind_int64(stmt, index, value.Cents());
+}
+
+int DBManager::BindParameter(sqlite3_stmt*    stmt,
+                             int              index,
+                             std::string_view value) noexcept
+{
+    // Parameters outlive the statement execution and bindings are cleared when the
+    // statement goes back to the cache, so the text does not need to be copied.
+    // An empty view may have no data, which SQLite would bind as NULL
+    return sqlite3_bind_text64(stmt,
+                               index,
+                               value.data() ? value.data() : "",
+                               value.size(),
+                               SQLITE_STATIC,
+                               SQLITE_UTF8);
+}
+
+int DBManager::BindParameter(sqlite3_stmt* stmt, int index, CopiedText value) noexcept
+{
+    return sqlite3_bind_text64(stmt,
+                               index,
+                               value.value.data() ? value.value.data() : "",
+                               value.value.size(),
+                               SQLITE_TRANSIENT,
+                               SQLITE_UTF8);
+}
+
+void DBManager::LogError(sqlite3* db, const std::string& context) const noexcept
+{
+    this->m_logger.Log(context + ": " + std::string(sqlite3_errmsg(db)),
+                       spdlog::level::err);
+}
+
 void DBManager::ResetDatabase() noexcept
 {
     // Delete all data from tables
 #if TEST_ENVIRONMENT
+    this->ExecuteQuery(query::DELETE_TABLE_WALLET_DAILY_BALANCE);
+    this->ExecuteQuery(query::DELETE_TABLE_WALLET_LEDGER_ENTRY);
+    this->ExecuteQuery(query::DELETE_TABLE_WALLET_BALANCE_CHECKPOINT);
+    this->ExecuteQuery(query::DELETE_TABLE_SPENDING_SUMMARY);
     this->ExecuteQuery(query::DELETE_TABLE_TRANSFER);
     this->ExecuteQuery(query::DELETE_TABLE_WALLET_TRANSACTION);
     this->ExecuteQuery(query::DELETE_TABLE_CREDIT_CARD_PAYMENT);
@@ -159,49 +936,156 @@ void DBManager::ResetDatabase() noexcept
 #endif
 }
 
-void DBManager::CreateTables()
+AsyncWriter& DBManager::GetAsyncWriter() noexcept
 {
-    if (not this->ExecuteQuery(query::CREATE_TABLE_WALLET))
+    std::call_once(this->m_asyncWriterOnce, [this]() {
+        this->m_asyncWriter =
+            std::make_unique<AsyncWriter>(*this,
+                                          config::GROUP_COMMIT_WINDOW,
+                                          config::GROUP_COMMIT_MAX_OPERATIONS);
+    });
+
+    return *this->m_asyncWriter;
+}
+
+bool DBManager::RunBackup(const std::string&    destination,
+                          int                   pagesPerStep,
+                          const BackupProgress& progress) noexcept
+{
+    sqlite3* target = nullptr;
+
+    if (sqlite3_open_v2(destination.c_str(),
+                        &target,
+                        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_URI,
+                        nullptr) != SQLITE_OK)
+    {
+        this->LogError(target, "Can't open backup " + destination);
+        sqlite3_close(target);
+        return false;
+    }
+
+    sqlite3_backup* backup = nullptr;
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(this->m_pool.WriterMutex());
+
+        if (this->m_pool.IsOpen())
+        {
+            backup = sqlite3_backup_init(target,
+                                         "main",
+                                         this->m_pool.Writer().handle,
+                                         "main");
+        }
+    }
+
+    if (not backup)
     {
-        this->m_logger.Log("Error creating table Wallet", spdlog::level::err);
-        throw std::runtime_error("Error creating table Wallet");
+        this->LogError(target, "Backup failed");
+        sqlite3_close(target);
+        return false;
     }
 
-    if (not this->ExecuteQuery(query::CREATE_TABLE_CATEGORY))
+    int rc = SQLITE_OK;
+
+    while (not this->m_closing)
     {
-        this->m_logger.Log("Error creating table Category", spdlog::level::err);
-        throw std::runtime_error("Error creating table Category");
+        // The writer is the source, so writes made between steps are applied to
+        // the copy instead of restarting it. Holding the writer lock keeps the
+        // uncommitted changes of open transactions out of the copy
+        {
+            std::lock_guard<std::recursive_mutex> lock(this->m_pool.WriterMutex());
+            rc = sqlite3_backup_step(backup, pagesPerStep);
+        }
+
+        if (progress)
+        {
+            progress(sqlite3_backup_remaining(backup),
+                     sqlite3_backup_pagecount(backup));
+        }
+
+        if (rc != SQLITE_OK and rc != SQLITE_BUSY and rc != SQLITE_LOCKED)
+        {
+            break;
+        }
+
+        std::this_thread::sleep_for(config::BACKUP_STEP_PAUSE);
     }
 
-    if (not this->ExecuteQuery(query::CREATE_TABLE_WALLET_TRANSACTION))
+    int finishRc = SQLITE_OK;
+
     {
-        this->m_logger.Log("Error creating table WalletTransaction",
+        std::lock_guard<std::recursive_mutex> lock(this->m_pool.WriterMutex());
+        finishRc = sqlite3_backup_finish(backup);
+    }
+
+    bool ok = rc == SQLITE_DONE and finishRc == SQLITE_OK;
+
+    if (ok)
+    {
+        this->m_logger.Log("Database backed up to " + destination);
+    }
+    else
+    {
+        int error = finishRc != SQLITE_OK ? finishRc : rc;
+
+        this->m_logger.Log(fmt::format("Backup to {} failed: {}",
+                                       destination,
+                                       this->m_closing ? "database closed"
+                                                       : sqlite3_errstr(error)),
                            spdlog::level::err);
-        throw std::runtime_error("Error creating table WalletTransaction");
     }
 
-    if (not this->ExecuteQuery(query::CREATE_TABLE_TRANSFER))
+    sqlite3_close(target);
+
+    return ok;
+}
+
+void DBManager::CreateTables()
+{
+    for (const query::Table& table : query::TABLES)
     {
-        this->m_logger.Log("Error creating table Transfer", spdlog::level::err);
-        throw std::runtime_error("Error creating table Transfer");
+        if (not this->ExecuteQuery(table.create))
+        {
+            std::string error = fmt::format("Error creating table {}", table.name);
+
+            this->m_logger.Log(error, spdlog::level::err);
+            throw std::runtime_error(error);
+        }
     }
+}
+
+std::optional<uint64_t> DBManager::ReadSchemaFingerprint() const noexcept
+{
+    std::lock_guard<std::recursive_mutex> lock(this->m_pool.WriterMutex());
+
+    sqlite3* writer = this->m_pool.Writer().handle;
 
-    if (not this->ExecuteQuery(query::CREATE_TABLE_CREDIT_CARD))
+    if (not writer)
     {
-        this->m_logger.Log("Error creating table CreditCard", spdlog::level::err);
-        throw std::runtime_error("Error creating table CreditCard");
+        return std::nullopt;
     }
 
-    if (not this->ExecuteQuery(query::CREATE_TABLE_CREDIT_CARD_DEBT))
+    // Prepared without the cache and its error log, since a new database has no
+    // SchemaInfo table yet
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(writer,
+                           query::SELECT_SCHEMA_FINGERPRINT.c_str(),
+                           -1,
+                           &stmt,
+                           nullptr) != SQLITE_OK)
     {
-        this->m_logger.Log("Error creating table CreditCardDebt", spdlog::level::err);
-        throw std::runtime_error("Error creating table CreditCardDebt");
+        return std::nullopt;
     }
 
-    if (not this->ExecuteQuery(query::CREATE_TABLE_CREDIT_CARD_PAYMENT))
+    std::optional<uint64_t> fingerprint;
+
+    if (sqlite3_step(stmt) == SQLITE_ROW)
     {
-        this->m_logger.Log("Error creating table CreditCardPayment",
-                           spdlog::level::err);
-        throw std::runtime_error("Error creating table CreditCardPayment");
+        fingerprint = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
     }
+
+    sqlite3_finalize(stmt);
+
+    return fingerprint;
 }
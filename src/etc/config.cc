@@ -5,3 +5,19 @@
  */
 
 #include "config.h"
+
+namespace config
+{
+    const StorageProfile* FindStorageProfile(std::string_view name) noexcept
+    {
+        for (const StorageProfile& profile : STORAGE_PROFILES)
+        {
+            if (name == profile.name)
+            {
+                return &profile;
+            }
+        }
+
+        return nullptr;
+    }
+} // namespace config
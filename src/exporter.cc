@@ -0,0 +1,625 @@
+/*
+ * Filename: exporter.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include "exporter.h"
+#include "sql_queries.h"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <iterator>
+#include <new>
+#include <unistd.h>
+
+namespace
+{
+    constexpr char COLUMNAR_MAGIC[8] = { 'M', 'F', 'N', 'C', 'O', 'L', '1', '\0' };
+
+    constexpr Exporter::Column WALLET_TRANSACTION_COLUMNS[] = {
+        { "wallet_transaction_id", Exporter::ColumnType::Integer },
+        { "wallet", Exporter::ColumnType::Dictionary },
+        { "category", Exporter::ColumnType::Dictionary },
+        { "type", Exporter::ColumnType::Dictionary },
+        { "date", Exporter::ColumnType::Text },
+        { "amount", Exporter::ColumnType::Real },
+        { "description", Exporter::ColumnType::Text }
+    };
+
+    constexpr Exporter::Column TRANSFER_COLUMNS[] = {
+        { "transfer_id", Exporter::ColumnType::Integer },
+        { "sender_wallet", Exporter::ColumnType::Dictionary },
+        { "receiver_wallet", Exporter::ColumnType::Dictionary },
+        { "date", Exporter::ColumnType::Text },
+        { "amount", Exporter::ColumnType::Real },
+        { "description", Exporter::ColumnType::Text }
+    };
+
+    constexpr Exporter::Column CREDIT_CARD_DEBT_COLUMNS[] = {
+        { "debt_id", Exporter::ColumnType::Integer },
+        { "crc_number", Exporter::ColumnType::Dictionary },
+        { "category", Exporter::ColumnType::Dictionary },
+        { "date", Exporter::ColumnType::Text },
+        { "total_amount", Exporter::ColumnType::Real },
+        { "description", Exporter::ColumnType::Text }
+    };
+
+    constexpr Exporter::Column CREDIT_CARD_PAYMENT_COLUMNS[] = {
+        { "payment_id", Exporter::ColumnType::Integer },
+        { "wallet", Exporter::ColumnType::Dictionary },
+        { "debt_id", Exporter::ColumnType::Integer },
+        { "date", Exporter::ColumnType::Text },
+        { "amount", Exporter::ColumnType::Real },
+        { "installment", Exporter::ColumnType::Integer }
+    };
+
+    /**
+     * @brief Get a text column of the current row
+     **/
+    std::string_view ColumnText(sqlite3_stmt* stmt, int index) noexcept
+    {
+        const char* text =
+            reinterpret_cast<const char*>(sqlite3_column_text(stmt, index));
+
+        return text ? std::string_view(text, sqlite3_column_bytes(stmt, index))
+                    : std::string_view();
+    }
+
+    /**
+     * @brief Append a number in its shortest form that reads back the same
+     **/
+    void AppendNumber(sqlite3_stmt*    stmt,
+                      int              index,
+                      Exporter::Column column,
+                      std::string&     line)
+    {
+        if (column.type == Exporter::ColumnType::Integer)
+        {
+            fmt::format_to(std::back_inserter(line),
+                           "{}",
+                           sqlite3_column_int64(stmt, index));
+        }
+        else
+        {
+            fmt::format_to(std::back_inserter(line),
+                           "{}",
+                           sqlite3_column_double(stmt, index));
+        }
+    }
+
+    /**
+     * @brief Write a value in little-endian order
+     **/
+    template<typename T>
+    void WriteValue(BufferedWriter& writer, T value) noexcept
+    {
+        static_assert(std::endian::native == std::endian::little,
+                      "The columnar format is written in little-endian order");
+
+        writer.Write(&value, sizeof(value));
+    }
+} // namespace
+
+BufferedWriter::BufferedWriter(const std::string& path) noexcept
+    : m_fd(open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)),
+      m_buffer(static_cast<char*>(std::aligned_alloc(config::EXPORT_BUFFER_ALIGNMENT,
+                                                     config::EXPORT_BUFFER_SIZE))),
+      m_used(0),
+      m_written(0),
+      m_failed(this->m_fd < 0 or not this->m_buffer)
+{ }
+
+BufferedWriter::~BufferedWriter() noexcept
+{
+    if (this->m_fd >= 0)
+    {
+        close(this->m_fd);
+    }
+
+    std::free(this->m_buffer);
+}
+
+bool BufferedWriter::IsGood() const noexcept
+{
+    return not this->m_failed;
+}
+
+void BufferedWriter::Write(const void* data, std::size_t size) noexcept
+{
+    if (this->m_failed)
+    {
+        return;
+    }
+
+    const char* bytes = static_cast<const char*>(data);
+
+    this->m_written += size;
+
+    while (size > 0)
+    {
+        std::size_t count = std::min(size, config::EXPORT_BUFFER_SIZE - this->m_used);
+
+        std::memcpy(this->m_buffer + this->m_used, bytes, count);
+
+        this->m_used += count;
+        bytes        += count;
+        size         -= count;
+
+        if (this->m_used == config::EXPORT_BUFFER_SIZE)
+        {
+            this->Flush();
+        }
+    }
+}
+
+void BufferedWriter::Write(std::string_view text) noexcept
+{
+    this->Write(text.data(), text.size());
+}
+
+bool BufferedWriter::Close() noexcept
+{
+    this->Flush();
+
+    if (this->m_fd >= 0 and close(this->m_fd) != 0)
+    {
+        this->m_failed = true;
+    }
+
+    this->m_fd = -1;
+
+    return not this->m_failed;
+}
+
+uint64_t BufferedWriter::GetSize() const noexcept
+{
+    return this->m_written;
+}
+
+void BufferedWriter::Flush() noexcept
+{
+    std::size_t offset = 0;
+
+    while (not this->m_failed and offset < this->m_used)
+    {
+        ssize_t count =
+            write(this->m_fd, this->m_buffer + offset, this->m_used - offset);
+
+        // A write that makes no progress would be retried forever
+        if ((count < 0 and errno != EINTR) or count == 0)
+        {
+            this->m_failed = true;
+        }
+        else if (count > 0)
+        {
+            offset += static_cast<std::size_t>(count);
+        }
+    }
+
+    this->m_used = 0;
+}
+
+Exporter::ColumnarEncoder::ColumnarEncoder(std::span<const Column> columns)
+    : m_columns(columns),
+      m_data(columns.size()),
+      m_rows(0)
+{
+    for (std::size_t i = 0; i < columns.size(); i++)
+    {
+        this->m_data[i].nulls.reserve(config::EXPORT_ROW_GROUP_ROWS / 8);
+        this->m_data[i].offsets.push_back(0);
+    }
+}
+
+void Exporter::ColumnarEncoder::WriteHeader(BufferedWriter& writer) const noexcept
+{
+    writer.Write(COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC));
+    WriteValue(writer, static_cast<uint32_t>(this->m_columns.size()));
+
+    for (const Column& column : this->m_columns)
+    {
+        WriteValue(writer, static_cast<uint8_t>(column.type));
+        WriteValue(writer, static_cast<uint16_t>(column.name.size()));
+        writer.Write(column.name);
+    }
+}
+
+void Exporter::ColumnarEncoder::Add(sqlite3_stmt* stmt, BufferedWriter& writer)
+{
+    for (std::size_t i = 0; i < this->m_columns.size(); i++)
+    {
+        ColumnData& data  = this->m_data[i];
+        int         index = static_cast<int>(i);
+        bool        null  = sqlite3_column_type(stmt, index) == SQLITE_NULL;
+
+        if (this->m_rows % 8 == 0)
+        {
+            data.nulls.push_back(0);
+        }
+
+        if (null)
+        {
+            data.nulls.back() |= static_cast<uint8_t>(1 << (this->m_rows % 8));
+        }
+
+        switch (this->m_columns[i].type)
+        {
+            case ColumnType::Integer:
+                data.integers.push_back(sqlite3_column_int64(stmt, index));
+                break;
+
+            case ColumnType::Real:
+                data.reals.push_back(sqlite3_column_double(stmt, index));
+                break;
+
+            case ColumnType::Text:
+                data.bytes += ColumnText(stmt, index);
+                data.offsets.push_back(static_cast<uint32_t>(data.bytes.size()));
+                break;
+
+            case ColumnType::Dictionary:
+            {
+                std::string_view text = ColumnText(stmt, index);
+                auto             it   = data.dictionary.find(text);
+
+                if (it == data.dictionary.end())
+                {
+                    auto code = static_cast<uint32_t>(data.dictionary.size());
+
+                    it = data.dictionary.emplace(text, code).first;
+                    data.newEntries.push_back(it->first);
+                }
+
+                data.codes.push_back(it->second);
+                break;
+            }
+        }
+    }
+
+    if (++this->m_rows == config::EXPORT_ROW_GROUP_ROWS)
+    {
+        this->WriteGroup(writer);
+    }
+}
+
+void Exporter::ColumnarEncoder::Finish(BufferedWriter& writer)
+{
+    if (this->m_rows > 0)
+    {
+        this->WriteGroup(writer);
+    }
+
+    WriteValue(writer, uint32_t(0));
+}
+
+void Exporter::ColumnarEncoder::WriteGroup(BufferedWriter& writer)
+{
+    WriteValue(writer, this->m_rows);
+
+    for (std::size_t i = 0; i < this->m_columns.size(); i++)
+    {
+        ColumnData& data = this->m_data[i];
+
+        writer.Write(data.nulls.data(), data.nulls.size());
+
+        switch (this->m_columns[i].type)
+        {
+            case ColumnType::Integer:
+                writer.Write(data.integers.data(),
+                             data.integers.size() * sizeof(int64_t));
+                break;
+
+            case ColumnType::Real:
+                writer.Write(data.reals.data(), data.reals.size() * sizeof(double));
+                break;
+
+            case ColumnType::Text:
+                writer.Write(data.offsets.data(),
+                             data.offsets.size() * sizeof(uint32_t));
+                writer.Write(data.bytes);
+                break;
+
+            case ColumnType::Dictionary:
+                WriteValue(writer, static_cast<uint32_t>(data.newEntries.size()));
+
+                for (std::string_view entry : data.newEntries)
+                {
+                    WriteValue(writer, static_cast<uint32_t>(entry.size()));
+                    writer.Write(entry);
+                }
+
+                writer.Write(data.codes.data(), data.codes.size() * sizeof(uint32_t));
+                break;
+        }
+
+        // The dictionary is kept, since codes index the entries of the whole file
+        data.nulls.clear();
+        data.integers.clear();
+        data.reals.clear();
+        data.offsets.resize(1);
+        data.bytes.clear();
+        data.codes.clear();
+        data.newEntries.clear();
+    }
+
+    this->m_rows = 0;
+}
+
+Exporter::Exporter() noexcept
+    : Exporter(DBManager::GetInstance())
+{ }
+
+Exporter::Exporter(DBManager& dbManager) noexcept
+    : m_dbManager(dbManager),
+      m_logManager(LogManager::GetInstance())
+{ }
+
+bool Exporter::Export(Table              table,
+                      Format             format,
+                      const std::string& path,
+                      Stats&             stats) noexcept
+{
+    auto start = std::chrono::steady_clock::now();
+
+    stats = Stats();
+
+    BufferedWriter writer(path);
+
+    if (not writer.IsGood())
+    {
+        this->m_logManager.Log("Could not create export file '" + path + "'.",
+                               spdlog::level::err);
+        return false;
+    }
+
+    std::span<const Column> columns = GetColumns(table);
+
+    try
+    {
+        std::string line;
+
+        if (format == Format::Csv)
+        {
+            for (std::size_t i = 0; i < columns.size(); i++)
+            {
+                line += i > 0 ? "," : "";
+                line += columns[i].name;
+            }
+
+            line += '\n';
+            writer.Write(line);
+        }
+
+        ColumnarEncoder encoder(columns);
+
+        if (format == Format::Columnar)
+        {
+            encoder.WriteHeader(writer);
+        }
+
+        // The statement stays on the same snapshot until the last row is read
+        auto writeRow = [&](sqlite3_stmt* stmt) {
+            if (format == Format::Columnar)
+            {
+                encoder.Add(stmt, writer);
+            }
+            else
+            {
+                line.clear();
+
+                if (format == Format::Csv)
+                {
+                    WriteCsvRow(stmt, columns, line);
+                }
+                else
+                {
+                    WriteNdjsonRow(stmt, columns, line);
+                }
+
+                writer.Write(line);
+            }
+
+            stats.rows++;
+        };
+
+        if (not this->m_dbManager.QueryAll(GetQuery(table), writeRow))
+        {
+            this->m_logManager.Log("Failed to read the rows to export to '" + path +
+                                       "' after " + std::to_string(stats.rows) +
+                                       " rows.",
+                                   spdlog::level::err);
+            return false;
+        }
+
+        if (format == Format::Columnar)
+        {
+            encoder.Finish(writer);
+        }
+    }
+    catch (const std::bad_alloc&)
+    {
+        this->m_logManager.Log("Out of memory while exporting to '" + path + "'.",
+                               spdlog::level::err);
+        return false;
+    }
+
+    stats.bytes = writer.GetSize();
+
+    if (not writer.Close())
+    {
+        this->m_logManager.Log("Failed to write export file '" + path +
+                                   "': " + std::strerror(errno),
+                               spdlog::level::err);
+        return false;
+    }
+
+    stats.elapsed = std::chrono::steady_clock::now() - start;
+
+    this->m_logManager.Log(
+        fmt::format("Exported {} rows ({} bytes) to '{}' in {:.3f} s.",
+                    stats.rows,
+                    stats.bytes,
+                    path,
+                    std::chrono::duration<double>(stats.elapsed).count()));
+
+    return true;
+}
+
+std::span<const Exporter::Column> Exporter::GetColumns(Table table) noexcept
+{
+    switch (table)
+    {
+        case Table::WalletTransaction:
+            return WALLET_TRANSACTION_COLUMNS;
+        case Table::Transfer:
+            return TRANSFER_COLUMNS;
+        case Table::CreditCardDebt:
+            return CREDIT_CARD_DEBT_COLUMNS;
+        case Table::CreditCardPayment:
+            return CREDIT_CARD_PAYMENT_COLUMNS;
+    }
+
+    return { };
+}
+
+const std::string& Exporter::GetQuery(Table table) noexcept
+{
+    switch (table)
+    {
+        case Table::WalletTransaction:
+            return query::EXPORT_WALLET_TRANSACTIONS;
+        case Table::Transfer:
+            return query::EXPORT_TRANSFERS;
+        case Table::CreditCardDebt:
+            return query::EXPORT_CREDIT_CARD_DEBTS;
+        case Table::CreditCardPayment:
+            break;
+    }
+
+    return query::EXPORT_CREDIT_CARD_PAYMENTS;
+}
+
+void Exporter::WriteCsvRow(sqlite3_stmt*           stmt,
+                           std::span<const Column> columns,
+                           std::string&            line)
+{
+    for (std::size_t i = 0; i < columns.size(); i++)
+    {
+        int index = static_cast<int>(i);
+
+        if (i > 0)
+        {
+            line += ',';
+        }
+
+        // NULL is an empty field
+        if (sqlite3_column_type(stmt, index) == SQLITE_NULL)
+        {
+            continue;
+        }
+
+        if (columns[i].type == ColumnType::Integer or
+            columns[i].type == ColumnType::Real)
+        {
+            AppendNumber(stmt, index, columns[i], line);
+            continue;
+        }
+
+        std::string_view text = ColumnText(stmt, index);
+
+        if (text.find_first_of(",\"\r\n") == std::string_view::npos)
+        {
+            line += text;
+            continue;
+        }
+
+        line += '"';
+
+        for (char c : text)
+        {
+            if (c == '"')
+            {
+                line += '"';
+            }
+
+            line += c;
+        }
+
+        line += '"';
+    }
+
+    line += '\n';
+}
+
+void Exporter::WriteNdjsonRow(sqlite3_stmt*           stmt,
+                              std::span<const Column> columns,
+                              std::string&            line)
+{
+    line += '{';
+
+    for (std::size_t i = 0; i < columns.size(); i++)
+    {
+        int index = static_cast<int>(i);
+
+        line += i > 0 ? ",\"" : "\"";
+        line += columns[i].name;
+        line += "\":";
+
+        if (sqlite3_column_type(stmt, index) == SQLITE_NULL)
+        {
+            line += "null";
+            continue;
+        }
+
+        if (columns[i].type == ColumnType::Integer or
+            columns[i].type == ColumnType::Real)
+        {
+            AppendNumber(stmt, index, columns[i], line);
+            continue;
+        }
+
+        line += '"';
+
+        for (char c : ColumnText(stmt, index))
+        {
+            switch (c)
+            {
+                case '"':
+                    line += "\\\"";
+                    break;
+                case '\\':
+                    line += "\\\\";
+                    break;
+                case '\n':
+                    line += "\\n";
+                    break;
+                case '\r':
+                    line += "\\r";
+                    break;
+                case '\t':
+                    line += "\\t";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        fmt::format_to(std::back_inserter(line),
+                                       "\\u{:04x}",
+                                       static_cast<int>(c));
+                    }
+                    else
+                    {
+                        line += c;
+                    }
+            }
+        }
+
+        line += '"';
+    }
+
+    line += "}\n";
+}
@@ -0,0 +1,91 @@
+/*
+ * Filename: ledger_store.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include "ledger_store.h"
+#include <algorithm>
+
+void SpendingCell::Add(Money amount) noexcept
+{
+    this->minAmount = this->count == 0 ? amount : std::min(this->minAmount, amount);
+    this->maxAmount = this->count == 0 ? amount : std::max(this->maxAmount, amount);
+    this->total += amount;
+    this->count++;
+}
+
+void SpendingCell::Merge(const SpendingCell& other) noexcept
+{
+    if (other.count == 0)
+    {
+        return;
+    }
+
+    this->minAmount =
+        this->count == 0 ? other.minAmount : std::min(this->minAmount, other.minAmount);
+    this->maxAmount =
+        this->count == 0 ? other.maxAmount : std::max(this->maxAmount, other.maxAmount);
+    this->total += other.total;
+    this->count += other.count;
+}
+
+SpendingCell SpendingOf(const std::string& date,
+                        int64_t            categoryId,
+                        const std::string& kind,
+                        const std::string& source,
+                        Money              amount) noexcept
+{
+    return SpendingCell{
+        date.substr(0, 7), categoryId, kind, source, amount, 1, amount, amount
+    };
+}
+
+LedgerStore::Transaction::Transaction(LedgerStore& store) noexcept
+    : m_scope(store.BeginTransaction())
+{ }
+
+bool LedgerStore::Transaction::Commit() noexcept
+{
+    return this->m_scope and this->m_scope->Commit();
+}
+
+void LedgerStore::Transaction::Rollback() noexcept
+{
+    if (this->m_scope)
+    {
+        this->m_scope->Rollback();
+    }
+}
+
+bool LedgerStore::Transaction::IsActive() const noexcept
+{
+    return this->m_scope and this->m_scope->IsActive();
+}
+
+bool LedgerStore::InsertWalletTransactions(
+    std::span<const WalletTransactionRecord> records) noexcept
+{
+    for (const WalletTransactionRecord& record : records)
+    {
+        if (not this->InsertWalletTransaction(record))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool LedgerStore::InsertTransfers(std::span<const TransferRecord> records) noexcept
+{
+    for (const TransferRecord& record : records)
+    {
+        if (not this->InsertTransfer(record))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
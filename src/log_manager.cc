@@ -6,23 +6,18 @@
 
 #include "log_manager.h"
 
-LogManager::LogManager() noexcept
-{
-    try
-    {
-        this->m_logger = spdlog::basic_logger_mt("file_logger", config::LOG_FULL_PATH);
-        this->m_logger->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] %v");
-        this->m_logger->set_level(spdlog::level::trace);
-    }
-    catch (const spdlog::spdlog_ex& ex)
-    {
-        std::cerr << "Log initialization failed: " << ex.what() << std::endl;
-    }
-}
+LogManager::LogManager() noexcept { }
 
 LogManager::~LogManager() noexcept
 {
-    spdlog::drop_all();
+    // The loggers are not in the spdlog registry, which may be destroyed first
+    for (const auto& logger : { this->m_logger, this->m_slowQueryLogger })
+    {
+        if (logger)
+        {
+            logger->flush();
+        }
+    }
 }
 
 LogManager& LogManager::GetInstance() noexcept
@@ -40,6 +35,62 @@ void LogManager::Log(const std::string&          message,
     funcName             = funcName.substr(0, funcName.find('('));
     funcName             = funcName.substr(funcName.rfind(' ') + 1);
 
+    std::call_once(this->m_loggerOnce, [this] {
+        this->m_logger = CreateLogger("file_logger",
+                                      config::LOG_FULL_PATH,
+                                      "[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] %v");
+
+        if (this->m_logger)
+        {
+            this->m_logger->set_level(spdlog::level::trace);
+        }
+    });
+
+    if (not this->m_logger)
+    {
+        return;
+    }
+
     // Log the message
     m_logger->log(level, "[{}] {} ", funcName, message);
 }
+
+void LogManager::LogSlowQuery(const std::string& entry) noexcept
+{
+    std::call_once(this->m_slowQueryLoggerOnce, [this] {
+        this->m_slowQueryLogger = CreateLogger("slow_query_logger",
+                                               config::SLOW_QUERY_LOG_FULL_PATH,
+                                               "[%Y-%m-%d %H:%M:%S.%e] %v");
+
+        if (this->m_slowQueryLogger)
+        {
+            this->m_slowQueryLogger->flush_on(spdlog::level::warn);
+        }
+    });
+
+    if (this->m_slowQueryLogger)
+    {
+        this->m_slowQueryLogger->warn(entry);
+    }
+}
+
+std::shared_ptr<spdlog::logger> LogManager::CreateLogger(const std::string& name,
+                                                         const std::string& path,
+                                                         const std::string& pattern)
+{
+    try
+    {
+        auto sink   = std::make_shared<spdlog::sinks::basic_file_sink_mt>(path);
+        auto logger = std::make_shared<spdlog::logger>(name, std::move(sink));
+
+        logger->set_pattern(pattern);
+
+        return logger;
+    }
+    catch (const spdlog::spdlog_ex& ex)
+    {
+        std::cerr << "Log initialization failed: " << ex.what() << std::endl;
+    }
+
+    return nullptr;
+}
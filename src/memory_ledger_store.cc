@@ -0,0 +1,913 @@
+/*
+ * Filename: memory_ledger_store.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include "memory_ledger_store.h"
+#include "money.h"
+#include <algorithm>
+#include <limits>
+#include <exception>
+#include <iterator>
+#include <utility>
+
+MemoryLedgerStore::MemoryScope::MemoryScope(MemoryLedgerStore& store) noexcept
+    : m_store(store),
+      m_lock(store.m_mutex),
+      m_mark(store.m_undoLog.size()),
+      m_active(true)
+{
+    this->m_store.m_depth++;
+}
+
+MemoryLedgerStore::MemoryScope::~MemoryScope() noexcept
+{
+    this->Rollback();
+}
+
+bool MemoryLedgerStore::MemoryScope::Commit() noexcept
+{
+    if (not this->m_active)
+    {
+        return false;
+    }
+
+    // The writes of a nested transaction stay in the log, so the outer one can
+    // still undo them
+    if (--this->m_store.m_depth == 0)
+    {
+        this->m_store.m_undoLog.clear();
+
+        for (auto& entry : std::exchange(this->m_store.m_commitActions, {}))
+        {
+            entry.second();
+        }
+    }
+    else
+    {
+        for (auto& [level, action] : this->m_store.m_commitActions)
+        {
+            level = std::min(level, this->m_store.m_depth);
+        }
+    }
+
+    this->m_active = false;
+    this->m_lock.unlock();
+    return true;
+}
+
+void MemoryLedgerStore::MemoryScope::Rollback() noexcept
+{
+    if (not this->m_active)
+    {
+        return;
+    }
+
+    this->m_store.UndoTo(this->m_mark);
+    std::erase_if(this->m_store.m_commitActions,
+                  [depth = this->m_store.m_depth](const auto& action) {
+                      return action.first >= depth;
+                  });
+    this->m_store.m_depth--;
+
+    this->m_active = false;
+    this->m_lock.unlock();
+}
+
+bool MemoryLedgerStore::MemoryScope::IsActive() const noexcept
+{
+    return this->m_active;
+}
+
+MemoryLedgerStore::MemoryLedgerStore() noexcept
+    : m_depth(0)
+{ }
+
+bool MemoryLedgerStore::PersistTo(LedgerStore& target) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    Transaction transaction(target);
+
+    if (not transaction.IsActive())
+    {
+        return false;
+    }
+
+    // Ids of the categories and debts in the target, by position in this store
+    std::vector<int64_t> categoryIds;
+    std::vector<int64_t> debtIds;
+
+    categoryIds.reserve(this->m_categories.size());
+    debtIds.reserve(this->m_debts.size());
+
+    for (const std::string& category : this->m_categories)
+    {
+        std::optional<int64_t> id = target.FindCategory(category);
+
+        if (not id)
+        {
+            id = target.InsertCategory(category);
+        }
+
+        if (not id)
+        {
+            return false;
+        }
+
+        categoryIds.push_back(*id);
+    }
+
+    // Maps an id of this store to the id in the target
+    auto categoryId = [&categoryIds](int64_t id) {
+        return id >= 1 and static_cast<std::size_t>(id) <= categoryIds.size()
+                   ? categoryIds[id - 1]
+                   : id;
+    };
+
+    for (const Wallet& wallet : this->m_wallets)
+    {
+        // The history is copied below, so the wallet opens as it did here
+        if (not target.InsertWallet(wallet.name, wallet.openingBalance) or
+            not target.SetWalletBalance(wallet.name, wallet.balance))
+        {
+            return false;
+        }
+    }
+
+    for (const auto& [name, days] : this->m_dailyBalances)
+    {
+        if (days.empty())
+        {
+            continue;
+        }
+
+        const DailyBalance& first   = days.begin()->second;
+        Money               opening = first.balance - first.delta;
+
+        for (const auto& [date, day] : days)
+        {
+            if (not target.AddToDailyBalance(name, date, day.delta, opening))
+            {
+                return false;
+            }
+        }
+    }
+
+    for (WalletTransactionRecord record : this->m_walletTransactions)
+    {
+        record.categoryId = categoryId(record.categoryId);
+
+        if (not target.InsertWalletTransaction(record))
+        {
+            return false;
+        }
+    }
+
+    for (const TransferRecord& record : this->m_transfers)
+    {
+        if (not target.InsertTransfer(record))
+        {
+            return false;
+        }
+    }
+
+    for (const auto& [key, spending] : this->m_spending)
+    {
+        SpendingCell cell = spending;
+        cell.categoryId   = categoryId(cell.categoryId);
+
+        if (not target.AddToSpendingSummary(cell))
+        {
+            return false;
+        }
+    }
+
+    for (const CreditCardRecord& record : this->m_creditCards)
+    {
+        if (not target.InsertCreditCard(record))
+        {
+            return false;
+        }
+    }
+
+    for (const Debt& debt : this->m_debts)
+    {
+        CreditCardDebtRecord record = debt.record;
+        record.categoryId           = categoryId(record.categoryId);
+
+        std::optional<int64_t> id = target.InsertCreditCardDebt(record);
+
+        if (not id)
+        {
+            return false;
+        }
+
+        debtIds.push_back(*id);
+    }
+
+    for (CreditCardPaymentRecord record : this->m_payments)
+    {
+        record.debtId = debtIds[record.debtId - 1];
+
+        if (not target.InsertCreditCardPayment(record))
+        {
+            return false;
+        }
+    }
+
+    return transaction.Commit();
+}
+
+std::unique_ptr<LedgerStore::Scope> MemoryLedgerStore::BeginTransaction() noexcept
+{
+    return std::make_unique<MemoryScope>(*this);
+}
+
+std::future<bool>
+MemoryLedgerStore::Enqueue(std::function<bool()> operation) noexcept
+{
+    std::promise<bool> promise;
+    std::future<bool>  future = promise.get_future();
+
+    Transaction transaction(*this);
+
+    try
+    {
+        bool succeeded = operation();
+
+        // A failed operation is rolled back, as the background writer does
+        promise.set_value(succeeded and transaction.Commit());
+    }
+    catch (...)
+    {
+        promise.set_exception(std::current_exception());
+    }
+
+    return future;
+}
+
+void MemoryLedgerStore::AfterCommit(std::function<void()> action) noexcept
+{
+    {
+        std::lock_guard lock(this->m_mutex);
+
+        if (this->m_depth > 0)
+        {
+            this->m_commitActions.emplace_back(this->m_depth, std::move(action));
+            return;
+        }
+    }
+
+    action();
+}
+
+uint64_t MemoryLedgerStore::GetGeneration() noexcept
+{
+    return 0;
+}
+
+std::vector<std::string> MemoryLedgerStore::GetWalletNames() noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    std::vector<std::string> names;
+    names.reserve(this->m_wallets.size());
+
+    for (const Wallet& wallet : this->m_wallets)
+    {
+        names.push_back(wallet.name);
+    }
+
+    return names;
+}
+
+std::vector<std::pair<std::string, Money>>
+MemoryLedgerStore::GetWalletBalances() noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    std::vector<std::pair<std::string, Money>> wallets;
+    wallets.reserve(this->m_wallets.size());
+
+    for (const Wallet& wallet : this->m_wallets)
+    {
+        wallets.emplace_back(wallet.name, wallet.balance);
+    }
+
+    return wallets;
+}
+
+bool MemoryLedgerStore::WalletExists(const std::string& name) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+    return this->m_walletIndex.contains(name);
+}
+
+std::optional<Money>
+MemoryLedgerStore::GetWalletBalance(const std::string& name) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    auto it = this->m_walletIndex.find(name);
+
+    if (it == this->m_walletIndex.end())
+    {
+        return std::nullopt;
+    }
+
+    return this->m_wallets[it->second].balance;
+}
+
+bool MemoryLedgerStore::InsertWallet(const std::string& name,
+                                     Money              balance) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    if (not this->m_walletIndex.emplace(name, this->m_wallets.size()).second)
+    {
+        return false;
+    }
+
+    this->m_wallets.push_back({ name, balance, balance });
+
+    this->PushUndo([this, name]() {
+        this->m_walletIndex.erase(name);
+        this->m_wallets.pop_back();
+    });
+
+    return true;
+}
+
+bool MemoryLedgerStore::DeleteWallet(const std::string& name) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    auto it = this->m_walletIndex.find(name);
+
+    if (it == this->m_walletIndex.end())
+    {
+        return false;
+    }
+
+    std::size_t   position = it->second;
+    Wallet        wallet   = std::move(this->m_wallets[position]);
+    DailyBalances days;
+
+    if (auto dailyBalances = this->m_dailyBalances.find(name);
+        dailyBalances != this->m_dailyBalances.end())
+    {
+        days = std::move(dailyBalances->second);
+        this->m_dailyBalances.erase(dailyBalances);
+    }
+
+    this->m_walletIndex.erase(it);
+    this->m_wallets.erase(this->m_wallets.begin() + position);
+    this->ReindexWallets(position);
+
+    this->PushUndo([this, position, wallet, days]() {
+        this->m_wallets.insert(this->m_wallets.begin() + position, wallet);
+        this->ReindexWallets(position);
+
+        if (not days.empty())
+        {
+            this->m_dailyBalances[wallet.name] = days;
+        }
+    });
+
+    return true;
+}
+
+bool MemoryLedgerStore::SetWalletBalance(const std::string& name,
+                                         Money              balance) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    auto it = this->m_walletIndex.find(name);
+
+    if (it == this->m_walletIndex.end())
+    {
+        return false;
+    }
+
+    std::size_t position = it->second;
+    Money       previous = this->m_wallets[position].balance;
+
+    this->m_wallets[position].balance = balance;
+
+    this->PushUndo([this, position, previous]() {
+        this->m_wallets[position].balance = previous;
+    });
+
+    return true;
+}
+
+std::optional<Money>
+MemoryLedgerStore::CreditWallet(const std::string& name, Money amount) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    std::optional<Money> balance = this->GetWalletBalance(name);
+
+    if (not balance)
+    {
+        return std::nullopt;
+    }
+
+    Money credited = *balance + amount;
+
+    if (not this->SetWalletBalance(name, credited))
+    {
+        return std::nullopt;
+    }
+
+    return credited;
+}
+
+std::optional<Money>
+MemoryLedgerStore::DebitWallet(const std::string& name, Money amount) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    std::optional<Money> balance = this->GetWalletBalance(name);
+
+    if (not balance or *balance < amount)
+    {
+        return std::nullopt;
+    }
+
+    Money debited = *balance - amount;
+
+    if (not this->SetWalletBalance(name, debited))
+    {
+        return std::nullopt;
+    }
+
+    return debited;
+}
+
+bool MemoryLedgerStore::AddToDailyBalance(const std::string& name,
+                                          const std::string& date,
+                                          Money              delta,
+                                          Money              openingBalance) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    if (not this->m_walletIndex.contains(name))
+    {
+        return false;
+    }
+
+    DailyBalances& days = this->m_dailyBalances[name];
+
+    auto day   = days.lower_bound(date);
+    bool added = day == days.end() or day->first != date;
+
+    if (added)
+    {
+        // Opens with the closing balance of the day before it
+        Money balance = openingBalance;
+
+        if (day != days.begin())
+        {
+            balance = std::prev(day)->second.balance;
+        }
+        else if (day != days.end())
+        {
+            balance = day->second.balance - day->second.delta;
+        }
+
+        day = days.emplace_hint(day, date, DailyBalance{ Money(), balance });
+    }
+
+    day->second.delta += delta;
+
+    for (auto it = day; it != days.end(); ++it)
+    {
+        it->second.balance += delta;
+    }
+
+    this->PushUndo([this, name, date, delta, added]() {
+        DailyBalances& days = this->m_dailyBalances[name];
+        auto           day  = days.find(date);
+
+        for (auto it = day; it != days.end(); ++it)
+        {
+            it->second.balance -= delta;
+        }
+
+        if (added)
+        {
+            days.erase(day);
+        }
+        else
+        {
+            day->second.delta -= delta;
+        }
+    });
+
+    return true;
+}
+
+std::optional<Money>
+MemoryLedgerStore::GetBalanceAsOf(const std::string& name,
+                                  const std::string& date) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    std::optional<Money> balance = this->GetWalletBalance(name);
+    auto                 days    = this->m_dailyBalances.find(name);
+
+    if (not balance or days == this->m_dailyBalances.end())
+    {
+        return balance;
+    }
+
+    auto after = days->second.upper_bound(date);
+
+    if (after != days->second.begin())
+    {
+        return std::prev(after)->second.balance;
+    }
+
+    if (after != days->second.end())
+    {
+        return after->second.balance - after->second.delta;
+    }
+
+    return balance;
+}
+
+std::vector<std::pair<std::string, Money>>
+MemoryLedgerStore::GetBalanceSeries(const std::string& name,
+                                    const std::string& from,
+                                    const std::string& to) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    std::vector<std::pair<std::string, Money>> series;
+
+    auto days = this->m_dailyBalances.find(name);
+
+    if (days == this->m_dailyBalances.end())
+    {
+        return series;
+    }
+
+    for (auto it = days->second.lower_bound(from);
+         it != days->second.end() and it->first <= to;
+         ++it)
+    {
+        series.emplace_back(it->first, it->second.balance);
+    }
+
+    return series;
+}
+
+bool MemoryLedgerStore::InsertWalletTransaction(
+    const WalletTransactionRecord& record) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    this->m_walletTransactions.push_back(record);
+    this->PushUndo([this]() { this->m_walletTransactions.pop_back(); });
+
+    return true;
+}
+
+bool MemoryLedgerStore::InsertTransfer(const TransferRecord& record) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    this->m_transfers.push_back(record);
+    this->PushUndo([this]() { this->m_transfers.pop_back(); });
+
+    return true;
+}
+
+std::vector<std::string> MemoryLedgerStore::GetCategoryNames() noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+    return this->m_categories;
+}
+
+std::vector<std::pair<std::string, int64_t>>
+MemoryLedgerStore::GetCategories() noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    std::vector<std::pair<std::string, int64_t>> categories;
+    categories.reserve(this->m_categories.size());
+
+    for (std::size_t i = 0; i < this->m_categories.size(); i++)
+    {
+        categories.emplace_back(this->m_categories[i], static_cast<int64_t>(i) + 1);
+    }
+
+    return categories;
+}
+
+std::optional<int64_t>
+MemoryLedgerStore::FindCategory(const std::string& name) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    auto it = this->m_categoryIndex.find(name);
+
+    if (it == this->m_categoryIndex.end())
+    {
+        return std::nullopt;
+    }
+
+    return static_cast<int64_t>(it->second) + 1;
+}
+
+std::optional<int64_t>
+MemoryLedgerStore::InsertCategory(const std::string& name) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    std::size_t position = this->m_categories.size();
+
+    if (not this->m_categoryIndex.emplace(name, position).second)
+    {
+        return std::nullopt;
+    }
+
+    this->m_categories.push_back(name);
+
+    this->PushUndo([this, name]() {
+        this->m_categoryIndex.erase(name);
+        this->m_categories.pop_back();
+    });
+
+    return static_cast<int64_t>(position) + 1;
+}
+
+bool MemoryLedgerStore::AddToSpendingSummary(const SpendingCell& cell) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    SpendingKey key{ cell.month, cell.categoryId, cell.kind, cell.source };
+
+    auto                        it       = this->m_spending.find(key);
+    std::optional<SpendingCell> previous = std::nullopt;
+
+    if (it != this->m_spending.end())
+    {
+        previous = it->second;
+    }
+
+    this->MergeSpending(cell);
+
+    this->PushUndo([this, key, previous]() {
+        if (previous)
+        {
+            this->m_spending[key] = *previous;
+        }
+        else
+        {
+            this->m_spending.erase(key);
+        }
+    });
+
+    return true;
+}
+
+std::vector<SpendingCell>
+MemoryLedgerStore::GetSpendingSummary(const std::string& fromMonth,
+                                      const std::string& toMonth) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    std::vector<SpendingCell> cells;
+
+    // The months lead the key, so the cells of the period are contiguous
+    SpendingKey first{ fromMonth, std::numeric_limits<int64_t>::min(), "", "" };
+
+    for (auto it = this->m_spending.lower_bound(first);
+         it != this->m_spending.end() and std::get<0>(it->first) <= toMonth;
+         ++it)
+    {
+        cells.push_back(it->second);
+    }
+
+    return cells;
+}
+
+bool MemoryLedgerStore::RebuildSpendingSummary() noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    SpendingSummary previous = std::move(this->m_spending);
+    this->m_spending.clear();
+
+    for (const WalletTransactionRecord& record : this->m_walletTransactions)
+    {
+        this->MergeSpending(SpendingOf(record.date,
+                                       record.categoryId,
+                                       record.type,
+                                       record.wallet,
+                                       record.amount));
+    }
+
+    for (const Debt& debt : this->m_debts)
+    {
+        this->MergeSpending(SpendingOf(debt.record.date,
+                                       debt.record.categoryId,
+                                       "CREDIT_CARD",
+                                       debt.record.cardNumber,
+                                       debt.record.totalAmount));
+    }
+
+    this->PushUndo([this, previous]() { this->m_spending = previous; });
+
+    return true;
+}
+
+std::vector<std::string> MemoryLedgerStore::GetCreditCardNumbers() noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    std::vector<std::string> numbers;
+    numbers.reserve(this->m_creditCards.size());
+
+    for (const CreditCardRecord& creditCard : this->m_creditCards)
+    {
+        numbers.push_back(creditCard.number);
+    }
+
+    return numbers;
+}
+
+std::optional<CreditCardRecord>
+MemoryLedgerStore::FindCreditCard(const std::string& number) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    auto it = this->m_creditCardIndex.find(number);
+
+    if (it == this->m_creditCardIndex.end())
+    {
+        return std::nullopt;
+    }
+
+    return this->m_creditCards[it->second];
+}
+
+bool MemoryLedgerStore::InsertCreditCard(const CreditCardRecord& record) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    if (not this->m_creditCardIndex.emplace(record.number, this->m_creditCards.size())
+                .second)
+    {
+        return false;
+    }
+
+    this->m_creditCards.push_back(record);
+
+    this->PushUndo([this]() {
+        this->m_creditCardIndex.erase(this->m_creditCards.back().number);
+        this->m_creditCards.pop_back();
+    });
+
+    return true;
+}
+
+std::optional<int64_t>
+MemoryLedgerStore::InsertCreditCardDebt(const CreditCardDebtRecord& record) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    std::size_t position = this->m_debts.size();
+
+    this->m_debts.push_back({ record, 0 });
+    this->m_cardDebts[record.cardNumber].push_back(position);
+
+    this->PushUndo([this]() {
+        this->m_cardDebts[this->m_debts.back().record.cardNumber].pop_back();
+        this->m_debts.pop_back();
+    });
+
+    return static_cast<int64_t>(position) + 1;
+}
+
+bool MemoryLedgerStore::InsertCreditCardPayment(
+    const CreditCardPaymentRecord& record) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    if (record.debtId < 1 or
+        static_cast<std::size_t>(record.debtId) > this->m_debts.size())
+    {
+        return false;
+    }
+
+    Debt& debt = this->m_debts[record.debtId - 1];
+
+    Money& pending = this->m_pendingDebt[debt.record.cardNumber];
+    Money  before  = pending;
+
+    if (not record.wallet)
+    {
+        pending += record.amount;
+    }
+
+    this->m_payments.push_back(record);
+    debt.installments++;
+
+    this->PushUndo([this, before]() {
+        Debt& debt = this->m_debts[this->m_payments.back().debtId - 1];
+
+        this->m_pendingDebt[debt.record.cardNumber] = before;
+        debt.installments--;
+        this->m_payments.pop_back();
+    });
+
+    return true;
+}
+
+Money MemoryLedgerStore::GetPendingDebt(const std::string& number) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    auto it = this->m_pendingDebt.find(number);
+
+    return it == this->m_pendingDebt.end() ? Money() : it->second;
+}
+
+std::optional<CreditCardExpense>
+MemoryLedgerStore::GetLastCreditCardExpense(const std::string& number) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+
+    auto it = this->m_cardDebts.find(number);
+
+    if (it == this->m_cardDebts.end())
+    {
+        return std::nullopt;
+    }
+
+    // Newest first. As in the database, debts without installments or with an
+    // unknown category are skipped
+    for (auto position = it->second.rbegin(); position != it->second.rend();
+         ++position)
+    {
+        const Debt&                 debt   = this->m_debts[*position];
+        const CreditCardDebtRecord& record = debt.record;
+
+        if (debt.installments == 0 or record.categoryId < 1 or
+            static_cast<std::size_t>(record.categoryId) > this->m_categories.size())
+        {
+            continue;
+        }
+
+        return CreditCardExpense{ static_cast<uint32_t>(*position + 1),
+                                  this->m_categories[record.categoryId - 1],
+                                  record.date,
+                                  record.totalAmount,
+                                  record.description,
+                                  debt.installments };
+    }
+
+    return std::nullopt;
+}
+
+void MemoryLedgerStore::PushUndo(std::function<void()> undo) noexcept
+{
+    if (this->m_depth > 0)
+    {
+        this->m_undoLog.push_back(std::move(undo));
+    }
+}
+
+void MemoryLedgerStore::UndoTo(std::size_t mark) noexcept
+{
+    while (this->m_undoLog.size() > mark)
+    {
+        this->m_undoLog.back()();
+        this->m_undoLog.pop_back();
+    }
+}
+
+void MemoryLedgerStore::ReindexWallets(std::size_t from) noexcept
+{
+    for (std::size_t i = from; i < this->m_wallets.size(); i++)
+    {
+        this->m_walletIndex[this->m_wallets[i].name] = i;
+    }
+}
+
+void MemoryLedgerStore::MergeSpending(const SpendingCell& cell) noexcept
+{
+    SpendingKey key{ cell.month, cell.categoryId, cell.kind, cell.source };
+
+    auto [it, added] = this->m_spending.try_emplace(key, cell);
+
+    if (not added)
+    {
+        it->second.Merge(cell);
+    }
+}
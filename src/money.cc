@@ -0,0 +1,169 @@
+/*
+ * Filename: money.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include "money.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <new>
+
+namespace
+{
+    // Independent accumulators of the kernels. Enough to fill a vector register
+    // and hide the latency of the additions
+    constexpr std::size_t LANES = 8;
+} // namespace
+
+std::string Money::ToString() const
+{
+    int64_t cents = std::abs(this->m_cents);
+
+    return fmt::format("{}{}.{:02}",
+                       this->m_cents < 0 ? "-" : "",
+                       cents / CENTS_PER_UNIT,
+                       cents % CENTS_PER_UNIT);
+}
+
+std::vector<Money> Money::Split(uint16_t parts) const
+{
+    std::vector<Money> split;
+
+    if (parts == 0)
+    {
+        return split;
+    }
+
+    std::lldiv_t share = std::lldiv(this->m_cents, parts);
+
+    split.reserve(parts);
+
+    for (uint16_t i = 0; i < parts; i++)
+    {
+        int64_t extra = i < std::abs(share.rem) ? (share.rem < 0 ? -1 : 1) : 0;
+        split.push_back(FromCents(share.quot + extra));
+    }
+
+    return split;
+}
+
+int64_t money::Sum(std::span<const int64_t> cents) noexcept
+{
+    int64_t     lanes[LANES] = {};
+    std::size_t i            = 0;
+
+    for (; i + LANES <= cents.size(); i += LANES)
+    {
+        for (std::size_t lane = 0; lane < LANES; lane++)
+        {
+            lanes[lane] += cents[i + lane];
+        }
+    }
+
+    int64_t sum = 0;
+
+    for (; i < cents.size(); i++)
+    {
+        sum += cents[i];
+    }
+
+    for (int64_t lane : lanes)
+    {
+        sum += lane;
+    }
+
+    return sum;
+}
+
+void money::GroupedSum(std::span<const int64_t>  cents,
+                       std::span<const uint32_t> groups,
+                       std::span<int64_t>        sums) noexcept
+{
+    std::size_t size    = std::min(cents.size(), groups.size());
+    std::size_t buckets = sums.size();
+
+    std::vector<int64_t> lanes;
+
+    try
+    {
+        lanes.assign(LANES * buckets, 0);
+    }
+    catch (const std::bad_alloc&)
+    {
+        // Without room for the lanes every amount goes straight to its group
+        for (std::size_t i = 0; i < size; i++)
+        {
+            assert(groups[i] < buckets);
+            sums[groups[i]] += cents[i];
+        }
+
+        return;
+    }
+
+    // Each lane adds to its own copy of the sums, so adjacent amounts of the same
+    // group do not wait on each other
+    std::size_t i = 0;
+
+    for (; i + LANES <= size; i += LANES)
+    {
+        for (std::size_t lane = 0; lane < LANES; lane++)
+        {
+            assert(groups[i + lane] < buckets);
+            lanes[lane * buckets + groups[i + lane]] += cents[i + lane];
+        }
+    }
+
+    for (; i < size; i++)
+    {
+        assert(groups[i] < buckets);
+        sums[groups[i]] += cents[i];
+    }
+
+    for (std::size_t lane = 0; lane < LANES; lane++)
+    {
+        for (std::size_t group = 0; group < buckets; group++)
+        {
+            sums[group] += lanes[lane * buckets + group];
+        }
+    }
+}
+
+std::optional<std::pair<int64_t, int64_t>>
+money::MinMax(std::span<const int64_t> cents) noexcept
+{
+    if (cents.empty())
+    {
+        return std::nullopt;
+    }
+
+    int64_t     low[LANES];
+    int64_t     high[LANES];
+    std::size_t i = 0;
+
+    std::fill(std::begin(low), std::end(low), cents[0]);
+    std::fill(std::begin(high), std::end(high), cents[0]);
+
+    for (; i + LANES <= cents.size(); i += LANES)
+    {
+        for (std::size_t lane = 0; lane < LANES; lane++)
+        {
+            low[lane]  = std::min(low[lane], cents[i + lane]);
+            high[lane] = std::max(high[lane], cents[i + lane]);
+        }
+    }
+
+    int64_t lowest  = *std::min_element(std::begin(low), std::end(low));
+    int64_t highest = *std::max_element(std::begin(high), std::end(high));
+
+    for (; i < cents.size(); i++)
+    {
+        lowest  = std::min(lowest, cents[i]);
+        highest = std::max(highest, cents[i]);
+    }
+
+    return std::make_pair(lowest, highest);
+}
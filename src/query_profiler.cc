@@ -0,0 +1,299 @@
+/*
+ * Filename: query_profiler.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include "query_profiler.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <fmt/format.h>
+#include <mutex>
+#include <utility>
+
+LatencyHistogram::LatencyHistogram() noexcept
+    : m_count(0),
+      m_max(0)
+{
+    for (std::atomic<uint64_t>& bucket : this->m_buckets)
+    {
+        bucket = 0;
+    }
+}
+
+void LatencyHistogram::Record(uint64_t value) noexcept
+{
+    this->m_buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    this->m_count.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t max = this->m_max.load(std::memory_order_relaxed);
+
+    while (value > max and
+           not this->m_max.compare_exchange_weak(max,
+                                                 value,
+                                                 std::memory_order_relaxed))
+    { }
+}
+
+uint64_t LatencyHistogram::GetCount() const noexcept
+{
+    return this->m_count.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::GetMax() const noexcept
+{
+    return this->m_max.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::GetPercentile(double percentile) const noexcept
+{
+    uint64_t count = this->GetCount();
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    percentile    = std::clamp(percentile, 0.0, 1.0);
+    uint64_t rank = std::max<uint64_t>(
+        1,
+        static_cast<uint64_t>(std::ceil(percentile * static_cast<double>(count))));
+
+    uint64_t seen = 0;
+
+    for (std::size_t i = 0; i < BUCKET_COUNT; i++)
+    {
+        seen += this->m_buckets[i].load(std::memory_order_relaxed);
+
+        if (seen >= rank)
+        {
+            // The bucket bound may overshoot the values actually recorded
+            return std::min(BucketUpperBound(i), this->GetMax());
+        }
+    }
+
+    return this->GetMax();
+}
+
+std::size_t LatencyHistogram::BucketIndex(uint64_t value) noexcept
+{
+    if (value < SUB_BUCKET_COUNT)
+    {
+        return static_cast<std::size_t>(value);
+    }
+
+    // Values in [2^e, 2^(e+1)) are split in SUB_BUCKET_COUNT buckets by the bits
+    // that follow the leading one
+    uint32_t exponent = static_cast<uint32_t>(std::bit_width(value)) - 1;
+    uint32_t shift    = exponent - SUB_BUCKET_BITS;
+
+    return static_cast<std::size_t>(SUB_BUCKET_COUNT * (shift + 1) +
+                                    (value >> shift) - SUB_BUCKET_COUNT);
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(std::size_t index) noexcept
+{
+    if (index < SUB_BUCKET_COUNT)
+    {
+        return index;
+    }
+
+    uint64_t shift = index / SUB_BUCKET_COUNT - 1;
+    uint64_t sub   = index % SUB_BUCKET_COUNT;
+    uint64_t lower = (SUB_BUCKET_COUNT + sub) << shift;
+
+    return lower + ((uint64_t{ 1 } << shift) - 1);
+}
+
+void QueryProfiler::SetSlowQueryLog(SlowQueryLog* slowQueryLog) noexcept
+{
+    this->m_slowQueryLog = slowQueryLog;
+}
+
+void QueryProfiler::Attach(sqlite3* db) noexcept
+{
+    sqlite3_trace_v2(db,
+                     SQLITE_TRACE_STMT | SQLITE_TRACE_ROW | SQLITE_TRACE_PROFILE,
+                     &QueryProfiler::Trace,
+                     this);
+}
+
+void QueryProfiler::Record(std::string_view         sql,
+                           std::chrono::nanoseconds elapsed,
+                           uint64_t                 rows) noexcept
+{
+    uint64_t ns = static_cast<uint64_t>(std::max<int64_t>(elapsed.count(), 0));
+
+    auto add = [ns, rows](Entry& entry) {
+        entry.calls.fetch_add(1, std::memory_order_relaxed);
+        entry.rows.fetch_add(rows, std::memory_order_relaxed);
+        entry.totalNs.fetch_add(ns, std::memory_order_relaxed);
+        entry.latency.Record(ns);
+    };
+
+    {
+        std::shared_lock<std::shared_mutex> lock(this->m_mutex);
+
+        auto it = this->m_entries.find(sql);
+
+        if (it != this->m_entries.end())
+        {
+            add(*it->second);
+            return;
+        }
+    }
+
+    // First run of the statement template
+    try
+    {
+        std::unique_lock<std::shared_mutex> lock(this->m_mutex);
+
+        std::unique_ptr<Entry>& entry = this->m_entries[std::string(sql)];
+
+        if (not entry)
+        {
+            entry = std::make_unique<Entry>();
+        }
+
+        add(*entry);
+    }
+    catch (const std::bad_alloc&)
+    {
+        // Profiling must never fail the statement that is being profiled
+    }
+}
+
+std::vector<QueryProfiler::Stats> QueryProfiler::GetStats() const
+{
+    std::vector<Stats> stats;
+
+    {
+        std::shared_lock<std::shared_mutex> lock(this->m_mutex);
+
+        stats.reserve(this->m_entries.size());
+
+        for (const auto& [sql, entry] : this->m_entries)
+        {
+            Stats s;
+            s.sql   = sql;
+            s.calls = entry->calls.load(std::memory_order_relaxed);
+            s.rows  = entry->rows.load(std::memory_order_relaxed);
+            s.total = std::chrono::nanoseconds(
+                entry->totalNs.load(std::memory_order_relaxed));
+            s.p50 = std::chrono::nanoseconds(entry->latency.GetPercentile(0.50));
+            s.p95 = std::chrono::nanoseconds(entry->latency.GetPercentile(0.95));
+            s.p99 = std::chrono::nanoseconds(entry->latency.GetPercentile(0.99));
+            s.max = std::chrono::nanoseconds(entry->latency.GetMax());
+
+            stats.push_back(std::move(s));
+        }
+    }
+
+    std::sort(stats.begin(), stats.end(), [](const Stats& a, const Stats& b) {
+        return a.total > b.total;
+    });
+
+    return stats;
+}
+
+void QueryProfiler::Reset() noexcept
+{
+    std::unique_lock<std::shared_mutex> lock(this->m_mutex);
+
+    this->m_entries.clear();
+}
+
+std::string QueryProfiler::Report() const
+{
+    auto us = [](std::chrono::nanoseconds ns) {
+        return static_cast<double>(ns.count()) / 1000.0;
+    };
+
+    std::string report = fmt::format("{:>10} {:>10} {:>12} {:>10} {:>10} {:>10} "
+                                      "{:>10}  {}\n",
+                                      "calls",
+                                      "rows",
+                                      "total (ms)",
+                                      "p50 (us)",
+                                      "p95 (us)",
+                                      "p99 (us)",
+                                      "max (us)",
+                                      "statement");
+
+    for (const Stats& s : this->GetStats())
+    {
+        report += fmt::format("{:>10} {:>10} {:>12.3f} {:>10.1f} {:>10.1f} "
+                              "{:>10.1f} {:>10.1f}  {}\n",
+                              s.calls,
+                              s.rows,
+                              us(s.total) / 1000.0,
+                              us(s.p50),
+                              us(s.p95),
+                              us(s.p99),
+                              us(s.max),
+                              s.sql);
+    }
+
+    return report;
+}
+
+int QueryProfiler::Trace(unsigned type, void* context, void* p, void* x) noexcept
+{
+    // Statements running on this thread, until each run ends. A connection is used
+    // by one thread at a time, so a run never moves threads
+    thread_local std::vector<Run> running;
+
+    sqlite3_stmt* stmt = static_cast<sqlite3_stmt*>(p);
+
+    auto it = std::find_if(running.begin(), running.end(), [stmt](const Run& run) {
+        return run.stmt == stmt;
+    });
+
+    if (type == SQLITE_TRACE_STMT)
+    {
+        // Also reported for each trigger the statement fires
+        if (it == running.end())
+        {
+            running.push_back(Run{ stmt, std::chrono::steady_clock::now(), 0 });
+        }
+
+        return 0;
+    }
+
+    if (type == SQLITE_TRACE_ROW)
+    {
+        if (it != running.end())
+        {
+            it->rows++;
+        }
+
+        return 0;
+    }
+
+    // SQLite measures the run with the clock of the VFS, which usually has
+    // millisecond resolution, so it is only used if the start was missed
+    std::chrono::nanoseconds elapsed(*static_cast<sqlite3_int64*>(x));
+    uint64_t                 rows = 0;
+
+    if (it != running.end())
+    {
+        elapsed = std::chrono::steady_clock::now() - it->start;
+        rows    = it->rows;
+        running.erase(it);
+    }
+
+    const char* sql = sqlite3_sql(stmt);
+
+    QueryProfiler* profiler = static_cast<QueryProfiler*>(context);
+
+    profiler->Record(sql ? sql : "", elapsed, rows);
+
+    // The statement still has its parameters bound at this point
+    if (profiler->m_slowQueryLog and profiler->m_slowQueryLog->IsSlow(elapsed))
+    {
+        profiler->m_slowQueryLog->Record(stmt, elapsed);
+    }
+
+    return 0;
+}
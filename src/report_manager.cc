@@ -0,0 +1,112 @@
+/*
+ * Filename: report_manager.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include "report_manager.h"
+#include "money.h"
+#include "sqlite_ledger_store.h"
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+
+ReportManager::ReportManager() noexcept
+    : ReportManager(DBManager::GetInstance())
+{ }
+
+ReportManager::ReportManager(DBManager& dbManager) noexcept
+    : m_logManager(LogManager::GetInstance()),
+      m_ownedStore(std::make_unique<SqliteLedgerStore>(dbManager)),
+      m_store(*m_ownedStore)
+{ }
+
+ReportManager::ReportManager(LedgerStore& store) noexcept
+    : m_logManager(LogManager::GetInstance()),
+      m_store(store)
+{ }
+
+ReportManager::~ReportManager() noexcept { }
+
+void ReportManager::GetSpendingSummary(const std::string&         fromMonth,
+                                       const std::string&         toMonth,
+                                       std::vector<SpendingCell>& cells) noexcept
+{
+    cells = this->m_store.GetSpendingSummary(fromMonth, toMonth);
+}
+
+void ReportManager::GetSpendingByCategory(const std::string&        fromMonth,
+                                          const std::string&        toMonth,
+                                          std::vector<std::string>& categories,
+                                          std::vector<Money>&       totals) noexcept
+{
+    categories.clear();
+    totals.clear();
+
+    std::vector<std::pair<std::string, int64_t>> categoryIds =
+        this->m_store.GetCategories();
+
+    // Lay the cells out as arrays of cents and category indexes, so the totals
+    // are summed by the integer kernel
+    std::unordered_map<int64_t, uint32_t> indexes;
+
+    for (uint32_t i = 0; i < categoryIds.size(); i++)
+    {
+        indexes.emplace(categoryIds[i].second, i);
+    }
+
+    std::vector<int64_t>  cents;
+    std::vector<uint32_t> groups;
+    std::vector<bool>     seen(categoryIds.size(), false);
+
+    for (const SpendingCell& cell :
+         this->m_store.GetSpendingSummary(fromMonth, toMonth))
+    {
+        auto it = indexes.find(cell.categoryId);
+
+        if (cell.kind != "INCOME" and it != indexes.end())
+        {
+            cents.push_back(cell.total.Cents());
+            groups.push_back(it->second);
+            seen[it->second] = true;
+        }
+    }
+
+    std::vector<int64_t> sums(categoryIds.size(), 0);
+    money::GroupedSum(cents, groups, sums);
+
+    std::vector<std::pair<std::string, Money>> byCategory;
+
+    for (uint32_t i = 0; i < categoryIds.size(); i++)
+    {
+        if (seen[i])
+        {
+            byCategory.emplace_back(std::move(categoryIds[i].first),
+                                    Money::FromCents(sums[i]));
+        }
+    }
+
+    std::stable_sort(byCategory.begin(),
+                     byCategory.end(),
+                     [](const auto& a, const auto& b) { return a.second > b.second; });
+
+    for (auto& [name, total] : byCategory)
+    {
+        categories.push_back(std::move(name));
+        totals.push_back(total);
+    }
+}
+
+bool ReportManager::RebuildSpendingSummary() noexcept
+{
+    if (not this->m_store.RebuildSpendingSummary())
+    {
+        this->m_logManager.Log("Failed to rebuild the spending summary.",
+                               spdlog::level::err);
+        return false;
+    }
+
+    this->m_logManager.Log("Spending summary rebuilt.");
+    return true;
+}
@@ -0,0 +1,179 @@
+/*
+ * Filename: slow_query_log.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include "slow_query_log.h"
+#include <fmt/format.h>
+#include <new>
+#include <vector>
+
+SlowQueryLog::SlowQueryLog(LogManager&              logger,
+                           std::chrono::nanoseconds threshold) noexcept
+    : m_logger(logger),
+      m_thresholdNs(threshold.count()),
+      m_count(0),
+      m_explainDb(nullptr)
+{ }
+
+SlowQueryLog::~SlowQueryLog() noexcept
+{
+    sqlite3_close(this->m_explainDb);
+}
+
+void SlowQueryLog::SetThreshold(std::chrono::nanoseconds threshold) noexcept
+{
+    this->m_thresholdNs = threshold.count();
+}
+
+std::chrono::nanoseconds SlowQueryLog::GetThreshold() const noexcept
+{
+    return std::chrono::nanoseconds(this->m_thresholdNs.load());
+}
+
+bool SlowQueryLog::IsSlow(std::chrono::nanoseconds elapsed) const noexcept
+{
+    return elapsed.count() >= this->m_thresholdNs.load(std::memory_order_relaxed);
+}
+
+void SlowQueryLog::Record(sqlite3_stmt* stmt, std::chrono::nanoseconds elapsed) noexcept
+{
+    const char* sql = sqlite3_sql(stmt);
+
+    if (not sql)
+    {
+        return;
+    }
+
+    // The expanded text has the bound parameters in place of the placeholders
+    char* expanded = sqlite3_expanded_sql(stmt);
+
+    try
+    {
+        std::string plan;
+
+        {
+            std::lock_guard<std::mutex> lock(this->m_mutex);
+
+            auto it = this->m_plans.find(sql);
+
+            if (it == this->m_plans.end())
+            {
+                const char* path =
+                    sqlite3_db_filename(sqlite3_db_handle(stmt), "main");
+
+                it = this->m_plans.emplace(sql, this->Explain(path, sql)).first;
+            }
+
+            plan = it->second;
+        }
+
+        this->m_logger.LogSlowQuery(
+            fmt::format("{:.3f} ms: {}{}",
+                        static_cast<double>(elapsed.count()) / 1e6,
+                        expanded ? expanded : sql,
+                        plan));
+
+        this->m_count++;
+    }
+    catch (const std::bad_alloc&)
+    {
+        // The journal must never fail the statement that is being logged
+    }
+
+    sqlite3_free(expanded);
+}
+
+uint64_t SlowQueryLog::GetCount() const noexcept
+{
+    return this->m_count;
+}
+
+std::string SlowQueryLog::GetPlan(std::string_view sql) noexcept
+{
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+
+    auto it = this->m_plans.find(std::string(sql));
+
+    return it != this->m_plans.end() ? it->second : std::string();
+}
+
+std::string SlowQueryLog::Explain(const char* path, const std::string& sql)
+{
+    if (not path or *path == '\0')
+    {
+        return "\n    (no plan for a database without a file)";
+    }
+
+    // The connection follows the database if it is reopened elsewhere
+    const char* explainPath =
+        this->m_explainDb ? sqlite3_db_filename(this->m_explainDb, "main") : nullptr;
+
+    if (not explainPath or std::string_view(explainPath) != path)
+    {
+        sqlite3_close(this->m_explainDb);
+        this->m_explainDb = nullptr;
+
+        if (sqlite3_open_v2(path, &this->m_explainDb, SQLITE_OPEN_READONLY, nullptr) !=
+            SQLITE_OK)
+        {
+            std::string error = sqlite3_errmsg(this->m_explainDb);
+
+            sqlite3_close(this->m_explainDb);
+            this->m_explainDb = nullptr;
+
+            return "\n    (no plan: " + error + ")";
+        }
+
+        // Without WAL, the writer may be holding a lock. Give up quickly, since the
+        // writer may be waiting for this entry to be written
+        sqlite3_busy_timeout(this->m_explainDb, 100);
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(this->m_explainDb,
+                           ("EXPLAIN QUERY PLAN " + sql).c_str(),
+                           -1,
+                           &stmt,
+                           nullptr) != SQLITE_OK)
+    {
+        return "\n    (no plan: " + std::string(sqlite3_errmsg(this->m_explainDb)) +
+               ")";
+    }
+
+    // Each step names its parent step, so the depth of a step is one more than
+    // the depth of its parent
+    std::vector<std::pair<int, int>> depths;
+    std::string                      plan;
+
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        int         id     = sqlite3_column_int(stmt, 0);
+        int         parent = sqlite3_column_int(stmt, 1);
+        const char* detail =
+            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+
+        int depth = 0;
+
+        for (const auto& [stepId, stepDepth] : depths)
+        {
+            if (stepId == parent)
+            {
+                depth = stepDepth + 1;
+                break;
+            }
+        }
+
+        depths.emplace_back(id, depth);
+
+        plan += '\n';
+        plan.append(4 + 2 * static_cast<std::size_t>(depth), ' ');
+        plan += detail ? detail : "";
+    }
+
+    sqlite3_finalize(stmt);
+
+    return plan.empty() ? "\n    (no plan)" : plan;
+}
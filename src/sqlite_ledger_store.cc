@@ -0,0 +1,582 @@
+/*
+ * Filename: sqlite_ledger_store.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include "sqlite_ledger_store.h"
+#include "config.h"
+#include "sql_queries.h"
+#include <algorithm>
+#include <cstddef>
+#include <sqlite3.h>
+#include <string_view>
+#include <tuple>
+
+namespace
+{
+    /**
+     * @brief Bind text that outlives the statement, without copying it
+     **/
+    bool BindText(sqlite3_stmt* stmt, int index, const std::string& text) noexcept
+    {
+        return sqlite3_bind_text(stmt,
+                                 index,
+                                 text.data(),
+                                 static_cast<int>(text.size()),
+                                 SQLITE_STATIC) == SQLITE_OK;
+    }
+
+    /**
+     * @brief Insert records with multi-row inserts of config::BATCH_ROWS_PER_INSERT
+     *        rows
+     * @param insert The insert up to VALUES
+     * @param row The placeholders of one row
+     * @param columns The number of placeholders of one row
+     * @param bindRow Binds a record to the placeholders starting at an index
+     **/
+    template<typename Record, typename BindRow>
+    bool InsertRows(DBManager&              db,
+                    const std::string&      insert,
+                    const std::string&      row,
+                    int                     columns,
+                    std::span<const Record> records,
+                    BindRow                 bindRow) noexcept
+    {
+        const std::size_t batchRows = config::BATCH_ROWS_PER_INSERT;
+        const std::string fullInsert =
+            records.size() >= batchRows ? query::MultiRowInsert(insert, row, batchRows)
+                                        : std::string();
+
+        for (std::size_t first = 0; first < records.size(); first += batchRows)
+        {
+            std::size_t rows = std::min(batchRows, records.size() - first);
+
+            std::string      tailInsert;
+            std::string_view sql = fullInsert;
+
+            if (rows < batchRows)
+            {
+                sql = tailInsert = query::MultiRowInsert(insert, row, rows);
+            }
+
+            bool inserted = db.ExecuteBound(sql, [&](sqlite3_stmt* stmt) {
+                for (std::size_t i = 0; i < rows; i++)
+                {
+                    int index = static_cast<int>(i) * columns + 1;
+
+                    if (not bindRow(stmt, index, records[first + i]))
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            });
+
+            if (not inserted)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+} // namespace
+
+SqliteLedgerStore::SqliteScope::SqliteScope(DBManager& db) noexcept
+    : m_transaction(db)
+{ }
+
+bool SqliteLedgerStore::SqliteScope::Commit() noexcept
+{
+    return this->m_transaction.Commit();
+}
+
+void SqliteLedgerStore::SqliteScope::Rollback() noexcept
+{
+    this->m_transaction.Rollback();
+}
+
+bool SqliteLedgerStore::SqliteScope::IsActive() const noexcept
+{
+    return this->m_transaction.IsActive();
+}
+
+SqliteLedgerStore::SqliteLedgerStore(DBManager& dbManager,
+                                     uint32_t   checkpointInterval) noexcept
+    : m_dbManager(dbManager),
+      m_checkpointInterval(std::max<uint32_t>(checkpointInterval, 1))
+{ }
+
+std::unique_ptr<LedgerStore::Scope> SqliteLedgerStore::BeginTransaction() noexcept
+{
+    auto scope = std::make_unique<SqliteScope>(this->m_dbManager);
+
+    if (not scope->IsActive())
+    {
+        return nullptr;
+    }
+
+    return scope;
+}
+
+std::future<bool>
+SqliteLedgerStore::Enqueue(std::function<bool()> operation) noexcept
+{
+    return this->m_dbManager.Enqueue(std::move(operation));
+}
+
+void SqliteLedgerStore::AfterCommit(std::function<void()> action) noexcept
+{
+    this->m_dbManager.AfterCommit(std::move(action));
+}
+
+uint64_t SqliteLedgerStore::GetGeneration() noexcept
+{
+    return this->m_dbManager.GetRestoreCount();
+}
+
+std::vector<std::string> SqliteLedgerStore::GetWalletNames() noexcept
+{
+    return this->m_dbManager.QueryAs<std::string>(query::SELECT_WALLET_NAMES);
+}
+
+std::vector<std::pair<std::string, Money>>
+SqliteLedgerStore::GetWalletBalances() noexcept
+{
+    std::vector<std::pair<std::string, Money>> wallets;
+
+    this->m_dbManager.ForEach<std::tuple<std::string_view, Money>>(
+        query::SELECT_WALLET_NAMES_AND_CURRENT_BALANCES,
+        [&wallets](std::tuple<std::string_view, Money> row) {
+            wallets.emplace_back(std::get<0>(row), std::get<1>(row));
+        });
+
+    return wallets;
+}
+
+bool SqliteLedgerStore::WalletExists(const std::string& name) noexcept
+{
+    return this->m_dbManager.QueryOne<int64_t>(query::COUNT_WALLET, name)
+               .value_or(0) > 0;
+}
+
+std::optional<Money>
+SqliteLedgerStore::GetWalletBalance(const std::string& name) noexcept
+{
+    return this->m_dbManager.QueryOne<Money>(query::SELECT_WALLET_CURRENT_BALANCE,
+                                             name);
+}
+
+bool SqliteLedgerStore::InsertWallet(const std::string& name,
+                                     Money              balance) noexcept
+{
+    return this->m_dbManager.Execute(query::INSERT_WALLET, name, balance);
+}
+
+bool SqliteLedgerStore::DeleteWallet(const std::string& name) noexcept
+{
+    return this->m_dbManager.Execute(query::DELETE_WALLET_DAILY_BALANCES, name) and
+           this->m_dbManager.Execute(query::DELETE_WALLET_LEDGER_ENTRIES, name) and
+           this->m_dbManager.Execute(query::DELETE_WALLET_BALANCE_CHECKPOINTS, name) and
+           this->m_dbManager.Execute(query::DELETE_WALLET, name);
+}
+
+bool SqliteLedgerStore::SetWalletBalance(const std::string& name,
+                                         Money              balance) noexcept
+{
+    DBManager::Transaction transaction(this->m_dbManager);
+
+    if (not transaction.IsActive())
+    {
+        return false;
+    }
+
+    if (not this->IsInLedger(name))
+    {
+        return this->m_dbManager.Execute(query::UPDATE_WALLET_BALANCE,
+                                         balance,
+                                         name) and
+               transaction.Commit();
+    }
+
+    std::optional<Money> current = this->GetWalletBalance(name);
+
+    return current and this->AppendToLedger(name, balance - *current) and
+           transaction.Commit();
+}
+
+std::optional<Money>
+SqliteLedgerStore::CreditWallet(const std::string& name, Money amount) noexcept
+{
+    // Most wallets keep their balance in place, so the update is tried first
+    std::optional<Money> balance =
+        this->m_dbManager.QueryOne<Money>(query::CREDIT_WALLET_BALANCE, amount, name);
+
+    return balance ? balance : this->AppendToLedger(name, amount);
+}
+
+std::optional<Money>
+SqliteLedgerStore::DebitWallet(const std::string& name, Money amount) noexcept
+{
+    std::optional<Money> balance =
+        this->m_dbManager.QueryOne<Money>(query::DEBIT_WALLET_BALANCE, amount, name);
+
+    return balance ? balance : this->AppendToLedger(name, -amount, false);
+}
+
+bool SqliteLedgerStore::AddToDailyBalance(const std::string& name,
+                                          const std::string& date,
+                                          Money              delta,
+                                          Money              openingBalance) noexcept
+{
+    return this->m_dbManager.Execute(query::INSERT_WALLET_DAILY_BALANCE,
+                                     name,
+                                     date,
+                                     openingBalance) and
+           this->m_dbManager.Execute(query::ADD_TO_WALLET_DAILY_BALANCES,
+                                     name,
+                                     date,
+                                     delta);
+}
+
+std::optional<Money>
+SqliteLedgerStore::GetBalanceAsOf(const std::string& name,
+                                  const std::string& date) noexcept
+{
+    return this->m_dbManager.QueryOne<Money>(query::SELECT_WALLET_BALANCE_AS_OF,
+                                             name,
+                                             date);
+}
+
+std::vector<std::pair<std::string, Money>>
+SqliteLedgerStore::GetBalanceSeries(const std::string& name,
+                                    const std::string& from,
+                                    const std::string& to) noexcept
+{
+    std::vector<std::pair<std::string, Money>> series;
+
+    this->m_dbManager.ForEach<std::tuple<std::string_view, Money>>(
+        query::SELECT_WALLET_BALANCE_SERIES,
+        name,
+        from,
+        to,
+        [&series](std::tuple<std::string_view, Money> row) {
+            series.emplace_back(std::get<0>(row), std::get<1>(row));
+        });
+
+    return series;
+}
+
+bool SqliteLedgerStore::InsertWalletTransaction(
+    const WalletTransactionRecord& record) noexcept
+{
+    return this->m_dbManager.Execute(query::INSERT_WALLET_TRANSACTION,
+                                     record.wallet,
+                                     record.categoryId,
+                                     record.type,
+                                     record.date,
+                                     record.amount,
+                                     record.description);
+}
+
+bool SqliteLedgerStore::InsertWalletTransactions(
+    std::span<const WalletTransactionRecord> records) noexcept
+{
+    return InsertRows(
+        this->m_dbManager,
+        query::INSERT_WALLET_TRANSACTIONS,
+        query::WALLET_TRANSACTION_ROW,
+        6,
+        records,
+        [](sqlite3_stmt* stmt, int index, const WalletTransactionRecord& record) {
+            return BindText(stmt, index, record.wallet) and
+                   sqlite3_bind_int64(stmt, index + 1, record.categoryId) ==
+                       SQLITE_OK and
+                   BindText(stmt, index + 2, record.type) and
+                   BindText(stmt, index + 3, record.date) and
+                   sqlite3_bind_int64(stmt, index + 4, record.amount.Cents()) ==
+                       SQLITE_OK and
+                   BindText(stmt, index + 5, record.description);
+        });
+}
+
+bool SqliteLedgerStore::InsertTransfer(const TransferRecord& record) noexcept
+{
+    return this->m_dbManager.Execute(query::INSERT_TRANSFER,
+                                     record.sender,
+                                     record.receiver,
+                                     record.date,
+                                     record.amount);
+}
+
+bool SqliteLedgerStore::InsertTransfers(
+    std::span<const TransferRecord> records) noexcept
+{
+    return InsertRows(this->m_dbManager,
+                      query::INSERT_TRANSFERS,
+                      query::TRANSFER_ROW,
+                      4,
+                      records,
+                      [](sqlite3_stmt* stmt, int index, const TransferRecord& record) {
+                          return BindText(stmt, index, record.sender) and
+                                 BindText(stmt, index + 1, record.receiver) and
+                                 BindText(stmt, index + 2, record.date) and
+                                 sqlite3_bind_int64(stmt,
+                                                    index + 3,
+                                                    record.amount.Cents()) == SQLITE_OK;
+                      });
+}
+
+std::vector<std::string> SqliteLedgerStore::GetCategoryNames() noexcept
+{
+    return this->m_dbManager.QueryAs<std::string>(query::SELECT_CATEGORY_NAMES);
+}
+
+std::vector<std::pair<std::string, int64_t>>
+SqliteLedgerStore::GetCategories() noexcept
+{
+    std::vector<std::pair<std::string, int64_t>> categories;
+
+    this->m_dbManager.ForEach<std::tuple<std::string_view, int64_t>>(
+        query::SELECT_CATEGORY_NAMES_AND_IDS,
+        [&categories](std::tuple<std::string_view, int64_t> row) {
+            categories.emplace_back(std::get<0>(row), std::get<1>(row));
+        });
+
+    return categories;
+}
+
+std::optional<int64_t>
+SqliteLedgerStore::FindCategory(const std::string& name) noexcept
+{
+    return this->m_dbManager.QueryOne<int64_t>(query::SELECT_CATEGORY_ID, name);
+}
+
+std::optional<int64_t>
+SqliteLedgerStore::InsertCategory(const std::string& name) noexcept
+{
+    if (not this->m_dbManager.Execute(query::INSERT_CATEGORY, name))
+    {
+        return std::nullopt;
+    }
+
+    return this->m_dbManager.LastInsertRowId();
+}
+
+bool SqliteLedgerStore::AddToSpendingSummary(const SpendingCell& cell) noexcept
+{
+    return this->m_dbManager.Execute(query::ADD_TO_SPENDING_SUMMARY,
+                                     cell.month,
+                                     cell.categoryId,
+                                     cell.kind,
+                                     cell.source,
+                                     cell.total,
+                                     cell.count,
+                                     cell.minAmount,
+                                     cell.maxAmount);
+}
+
+std::vector<SpendingCell>
+SqliteLedgerStore::GetSpendingSummary(const std::string& fromMonth,
+                                      const std::string& toMonth) noexcept
+{
+    std::vector<SpendingCell> cells;
+
+    this->m_dbManager.ForEach<std::tuple<std::string_view,
+                                         int64_t,
+                                         std::string_view,
+                                         std::string_view,
+                                         Money,
+                                         int64_t,
+                                         Money,
+                                         Money>>(
+        query::SELECT_SPENDING_SUMMARY,
+        fromMonth,
+        toMonth,
+        [&cells](auto row) {
+            auto [month, categoryId, kind, source, total, count, minAmount, maxAmount] =
+                row;
+
+            cells.push_back({ std::string(month),
+                              categoryId,
+                              std::string(kind),
+                              std::string(source),
+                              total,
+                              count,
+                              minAmount,
+                              maxAmount });
+        });
+
+    return cells;
+}
+
+bool SqliteLedgerStore::RebuildSpendingSummary() noexcept
+{
+    DBManager::Transaction transaction(this->m_dbManager);
+
+    return transaction.IsActive() and
+           this->m_dbManager.ExecuteQuery(
+               std::string(query::REBUILD_SPENDING_SUMMARY)) and
+           transaction.Commit();
+}
+
+std::vector<std::string> SqliteLedgerStore::GetCreditCardNumbers() noexcept
+{
+    return this->m_dbManager.QueryAs<std::string>(query::SELECT_CREDIT_CARD_NUMBERS);
+}
+
+std::optional<CreditCardRecord>
+SqliteLedgerStore::FindCreditCard(const std::string& number) noexcept
+{
+    auto info =
+        this->m_dbManager.QueryOne<std::tuple<std::string, Money, uint16_t>>(
+            query::SELECT_CREDIT_CARD_INFO,
+            number);
+
+    if (not info)
+    {
+        return std::nullopt;
+    }
+
+    auto& [name, maxDebt, billingDueDay] = *info;
+
+    return CreditCardRecord{ number, std::move(name), maxDebt, billingDueDay };
+}
+
+bool SqliteLedgerStore::InsertCreditCard(const CreditCardRecord& record) noexcept
+{
+    return this->m_dbManager.Execute(query::INSERT_CREDIT_CARD,
+                                     record.number,
+                                     record.name,
+                                     record.maxDebt,
+                                     record.billingDueDay);
+}
+
+std::optional<int64_t>
+SqliteLedgerStore::InsertCreditCardDebt(const CreditCardDebtRecord& record) noexcept
+{
+    if (not this->m_dbManager.Execute(query::INSERT_CREDIT_CARD_DEBT,
+                                      record.cardNumber,
+                                      record.categoryId,
+                                      record.date,
+                                      record.totalAmount,
+                                      record.description))
+    {
+        return std::nullopt;
+    }
+
+    return this->m_dbManager.LastInsertRowId();
+}
+
+bool SqliteLedgerStore::InsertCreditCardPayment(
+    const CreditCardPaymentRecord& record) noexcept
+{
+    if (record.wallet)
+    {
+        return this->m_dbManager.Execute(query::INSERT_PAID_CREDIT_CARD_PAYMENT,
+                                         record.debtId,
+                                         *record.wallet,
+                                         record.date,
+                                         record.amount,
+                                         record.installment);
+    }
+
+    return this->m_dbManager.Execute(query::INSERT_CREDIT_CARD_PAYMENT,
+                                     record.debtId,
+                                     record.date,
+                                     record.amount,
+                                     record.installment);
+}
+
+Money SqliteLedgerStore::GetPendingDebt(const std::string& number) noexcept
+{
+    // The sum is NULL when there is no pending debt, which is decoded as zero
+    return this->m_dbManager
+        .QueryOne<Money>(query::SELECT_CREDIT_CARD_PENDING_DEBT, number)
+        .value_or(Money());
+}
+
+std::optional<CreditCardExpense>
+SqliteLedgerStore::GetLastCreditCardExpense(const std::string& number) noexcept
+{
+    auto expense = this->m_dbManager.QueryOne<std::tuple<uint32_t,
+                                                         std::string,
+                                                         std::string,
+                                                         Money,
+                                                         std::string,
+                                                         uint16_t>>(
+        query::SELECT_LAST_CREDIT_CARD_EXPENSE,
+        number);
+
+    if (not expense)
+    {
+        return std::nullopt;
+    }
+
+    auto& [debtId, category, date, totalAmount, description, installments] =
+        *expense;
+
+    return CreditCardExpense{ debtId,
+                              std::move(category),
+                              std::move(date),
+                              totalAmount,
+                              std::move(description),
+                              installments };
+}
+
+bool SqliteLedgerStore::IsInLedger(const std::string& name) noexcept
+{
+    return this->m_dbManager.QueryOne<int64_t>(query::COUNT_WALLET_BALANCE_CHECKPOINTS,
+                                               name)
+               .value_or(0) > 0;
+}
+
+std::optional<Money>
+SqliteLedgerStore::AppendToLedger(const std::string& name,
+                                  Money              change,
+                                  bool               allowNegative) noexcept
+{
+    DBManager::Transaction transaction(this->m_dbManager);
+
+    if (not transaction.IsActive() or not this->IsInLedger(name))
+    {
+        return std::nullopt;
+    }
+
+    // The balance read and the entry appended are in the same transaction, so
+    // the check holds against concurrent debits
+    std::optional<Money> current = this->GetWalletBalance(name);
+
+    if (not current)
+    {
+        return std::nullopt;
+    }
+
+    Money balance = *current + change;
+
+    if (not allowNegative and balance < Money())
+    {
+        return std::nullopt;
+    }
+
+    if (change != Money() and
+        (not this->m_dbManager.Execute(query::APPEND_WALLET_LEDGER_ENTRY,
+                                       name,
+                                       change.Cents()) or
+         not this->m_dbManager.Execute(
+             query::INSERT_WALLET_BALANCE_CHECKPOINT,
+             name,
+             static_cast<int64_t>(this->m_checkpointInterval))))
+    {
+        return std::nullopt;
+    }
+
+    if (not transaction.Commit())
+    {
+        return std::nullopt;
+    }
+
+    return balance;
+}
@@ -0,0 +1,284 @@
+/*
+ * Filename: statement_cache.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include "statement_cache.h"
+#include <algorithm>
+#include <cctype>
+#include <utility>
+
+StatementCache::Lease::Lease(StatementCache* cache,
+                             std::string     key,
+                             sqlite3_stmt*   stmt,
+                             bool            hasTail) noexcept
+    : m_cache(cache),
+      m_key(std::move(key)),
+      m_stmt(stmt),
+      m_hasTail(hasTail)
+{ }
+
+StatementCache::Lease::Lease() noexcept
+    : m_cache(nullptr),
+      m_stmt(nullptr),
+      m_hasTail(false)
+{ }
+
+StatementCache::Lease::Lease(Lease&& other) noexcept
+    : m_cache(std::exchange(other.m_cache, nullptr)),
+      m_key(std::move(other.m_key)),
+      m_stmt(std::exchange(other.m_stmt, nullptr)),
+      m_hasTail(other.m_hasTail)
+{ }
+
+StatementCache::Lease& StatementCache::Lease::operator=(Lease&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (this->m_cache and this->m_stmt)
+        {
+            this->m_cache->Release(std::move(this->m_key), this->m_stmt);
+        }
+
+        this->m_cache   = std::exchange(other.m_cache, nullptr);
+        this->m_key     = std::move(other.m_key);
+        this->m_stmt    = std::exchange(other.m_stmt, nullptr);
+        this->m_hasTail = other.m_hasTail;
+    }
+
+    return *this;
+}
+
+StatementCache::Lease::~Lease() noexcept
+{
+    if (this->m_cache and this->m_stmt)
+    {
+        this->m_cache->Release(std::move(this->m_key), this->m_stmt);
+    }
+}
+
+sqlite3_stmt* StatementCache::Lease::Get() const noexcept
+{
+    return this->m_stmt;
+}
+
+bool StatementCache::Lease::HasTail() const noexcept
+{
+    return this->m_hasTail;
+}
+
+StatementCache::Lease::operator bool() const noexcept
+{
+    return this->m_stmt != nullptr;
+}
+
+StatementCache::StatementCache(sqlite3* db, std::size_t capacity) noexcept
+    : m_db(db),
+      m_capacity(capacity),
+      m_hits(0),
+      m_misses(0),
+      m_evictions(0),
+      m_size(0)
+{ }
+
+StatementCache::~StatementCache() noexcept
+{
+    this->Clear();
+}
+
+StatementCache::Lease StatementCache::Acquire(std::string_view sql) noexcept
+{
+    std::string key = Normalize(sql);
+
+    auto it = this->m_index.find(key);
+
+    if (it != this->m_index.end())
+    {
+        // Check the statement out of the cache while it is in use
+        sqlite3_stmt* stmt = it->second->stmt;
+
+        this->m_lru.erase(it->second);
+        this->m_index.erase(it);
+        this->m_size = this->m_lru.size();
+        this->m_hits++;
+
+        return Lease(this, std::move(key), stmt, false);
+    }
+
+    this->m_misses++;
+
+    sqlite3_stmt* stmt = nullptr;
+    const char*   tail = nullptr;
+
+    // The key only identifies the statement, the text compiled is the caller's.
+    // The profiler groups statements by that text, so the terminating semicolons
+    // are left out as they are from the key
+    std::string_view text = sql;
+
+    while (not text.empty() and (text.back() == ';' or
+                                 std::isspace(static_cast<unsigned char>(text.back()))))
+    {
+        text.remove_suffix(1);
+    }
+
+    int rc = sqlite3_prepare_v3(this->m_db,
+                                text.data(),
+                                static_cast<int>(text.size()),
+                                SQLITE_PREPARE_PERSISTENT,
+                                &stmt,
+                                &tail);
+
+    if (rc != SQLITE_OK)
+    {
+        sqlite3_finalize(stmt);
+        return Lease(nullptr, std::move(key), nullptr, false);
+    }
+
+    bool hasTail = false;
+
+    while (tail and tail < text.data() + text.size())
+    {
+        if (not std::isspace(static_cast<unsigned char>(*tail)) and *tail != ';')
+        {
+            hasTail = true;
+            break;
+        }
+
+        tail++;
+    }
+
+    // Scripts with more than one statement are not cached, since the key does not
+    // describe a single statement. The caller must run them some other way
+    if (hasTail)
+    {
+        sqlite3_finalize(stmt);
+        return Lease(nullptr, std::move(key), nullptr, true);
+    }
+
+    return Lease(this, std::move(key), stmt, false);
+}
+
+void StatementCache::Clear() noexcept
+{
+    for (Entry& entry : this->m_lru)
+    {
+        sqlite3_finalize(entry.stmt);
+    }
+
+    this->m_lru.clear();
+    this->m_index.clear();
+    this->m_size = 0;
+}
+
+StatementCache::Stats StatementCache::GetStats() const noexcept
+{
+    Stats stats;
+    stats.hits      = this->m_hits;
+    stats.misses    = this->m_misses;
+    stats.evictions = this->m_evictions;
+    stats.size      = this->m_size;
+    stats.capacity  = this->m_capacity;
+    return stats;
+}
+
+std::string StatementCache::Normalize(std::string_view sql)
+{
+    std::string normalized;
+    normalized.reserve(sql.size());
+
+    char quote        = '\0';
+    bool pendingSpace = false;
+
+    for (std::size_t i = 0; i < sql.size(); i++)
+    {
+        char c = sql[i];
+
+        if (quote != '\0')
+        {
+            normalized.push_back(c);
+
+            if (c == quote)
+            {
+                quote = '\0';
+            }
+
+            continue;
+        }
+
+        // Comments count as whitespace. A line comment ends at the newline and a
+        // block comment at its closing mark, or at the end of the text
+        if (sql.substr(i, 2) == "--")
+        {
+            i = std::min(sql.find('\n', i), sql.size());
+            c = ' ';
+        }
+        else if (sql.substr(i, 2) == "/*")
+        {
+            std::size_t end = sql.find("*/", i + 2);
+            i               = end == std::string_view::npos ? sql.size() : end + 1;
+            c               = ' ';
+        }
+
+        if (std::isspace(static_cast<unsigned char>(c)))
+        {
+            pendingSpace = not normalized.empty();
+            continue;
+        }
+
+        if (pendingSpace)
+        {
+            normalized.push_back(' ');
+            pendingSpace = false;
+        }
+
+        if (c == '\'' or c == '"' or c == '`')
+        {
+            quote = c;
+        }
+
+        normalized.push_back(c);
+    }
+
+    // Drop trailing semicolons and the whitespace between them
+    while (not normalized.empty() and
+           (normalized.back() == ';' or normalized.back() == ' '))
+    {
+        normalized.pop_back();
+    }
+
+    return normalized;
+}
+
+void StatementCache::Release(std::string&& key, sqlite3_stmt* stmt) noexcept
+{
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+
+    // A nested query may have prepared a second copy of the same statement
+    if (this->m_capacity == 0 or this->m_index.contains(key))
+    {
+        sqlite3_finalize(stmt);
+        return;
+    }
+
+    this->m_lru.push_front(Entry { key, stmt });
+    this->m_index.emplace(std::move(key), this->m_lru.begin());
+
+    this->EvictOverflow();
+
+    this->m_size = this->m_lru.size();
+}
+
+void StatementCache::EvictOverflow() noexcept
+{
+    while (this->m_lru.size() > this->m_capacity)
+    {
+        Entry& victim = this->m_lru.back();
+
+        sqlite3_finalize(victim.stmt);
+        this->m_index.erase(victim.key);
+        this->m_lru.pop_back();
+        this->m_evictions++;
+    }
+}
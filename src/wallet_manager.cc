@@ -7,220 +7,266 @@
 #include "wallet_manager.h"
 #include "category_manager.h"
 #include "db_manager.h"
-#include "sql_queries.h"
+#include "sqlite_ledger_store.h"
 #include <cmath>
 #include <cstddef>
-#include <fmt/core.h>
-#include <fmt/format.h>
-#include <stdexcept>
+#include <map>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 WalletManager::WalletManager() noexcept
-    : m_dbManager(DBManager::GetInstance()),
-      m_logManager(LogManager::GetInstance())
+    : WalletManager(DBManager::GetInstance())
+{ }
+
+WalletManager::WalletManager(DBManager& dbManager) noexcept
+    : m_logManager(LogManager::GetInstance()),
+      m_ownedStore(std::make_unique<SqliteLedgerStore>(dbManager)),
+      m_store(*m_ownedStore),
+      m_categoryManager(m_store),
+      m_cacheLoaded(false),
+      m_cacheGeneration(0)
+{ }
+
+WalletManager::WalletManager(LedgerStore& store) noexcept
+    : m_logManager(LogManager::GetInstance()),
+      m_store(store),
+      m_categoryManager(store),
+      m_cacheLoaded(false),
+      m_cacheGeneration(0)
 { }
 
 WalletManager::~WalletManager() noexcept { }
 
 void WalletManager::GetWallets(std::vector<std::string>& wallets) noexcept
 {
-    wallets.clear();
-
-    std::string query = "SELECT name FROM Wallet;";
-
-    this->m_dbManager.ExecuteQueryWithResult(query, [&wallets](sqlite3_stmt* stmt) {
-        wallets.push_back(
-            std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0))));
-    });
+    wallets = this->m_store.GetWalletNames();
 }
 
 void WalletManager::GetWallets(std::vector<std::string>& wallets,
-                               std::vector<double_t>&    balances) noexcept
+                               std::vector<Money>&       balances) noexcept
 {
     wallets.clear();
     balances.clear();
 
-    std::string query = "SELECT name, balance FROM Wallet;";
-
-    this->m_dbManager.ExecuteQueryWithResult(
-        query,
-        [&wallets, &balances](sqlite3_stmt* stmt) {
-            wallets.push_back(std::string(
-                reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0))));
-            balances.push_back(sqlite3_column_double(stmt, 1));
-        });
+    for (auto& [name, balance] : this->m_store.GetWalletBalances())
+    {
+        wallets.push_back(std::move(name));
+        balances.push_back(balance);
+    }
 }
 
 void WalletManager::CreateWallet(const std::string& walletName,
-                                 const double_t     initialBalance) noexcept
+                                 const Money        initialBalance) noexcept
 {
-    std::string query =
-        fmt::format("INSERT INTO Wallet (name, balance) VALUES ('{}', '{}')",
-                    walletName,
-                    initialBalance);
+    LedgerStore::Transaction transaction(this->m_store);
+
+    if (not transaction.IsActive())
+    {
+        return;
+    }
 
     if (this->WalletExists(walletName))
     {
         this->m_logManager.Log("Wallet '" + walletName + "' already exists.");
+        return;
     }
-    else
+
+    if (this->m_store.InsertWallet(walletName, initialBalance))
     {
-        this->m_dbManager.ExecuteQuery(query);
-        this->m_logManager.Log("Wallet '" + walletName + "' created.");
+        this->SetCachedBalance(walletName, initialBalance);
+
+        if (transaction.Commit())
+        {
+            this->m_logManager.Log("Wallet '" + walletName + "' created.");
+            return;
+        }
     }
+
+    this->m_logManager.Log("Failed to create wallet '" + walletName + "'.",
+                           spdlog::level::err);
 }
 
 void WalletManager::DeleteWallet(const std::string& walletName) noexcept
 {
-    std::string query =
-        fmt::format("DELETE FROM Wallet WHERE name = '{}';", walletName);
+    LedgerStore::Transaction transaction(this->m_store);
 
-    if (this->WalletExists(walletName))
+    if (not transaction.IsActive())
     {
-        this->m_dbManager.ExecuteQuery(query);
-        this->m_logManager.Log("Wallet '" + walletName + "' deleted.");
+        return;
     }
-    else
+
+    if (not this->WalletExists(walletName))
     {
         this->m_logManager.Log("Wallet '" + walletName + "' does not exist.");
+        return;
     }
+
+    if (this->m_store.DeleteWallet(walletName))
+    {
+        this->SetCachedBalance(walletName, std::nullopt);
+
+        if (transaction.Commit())
+        {
+            this->m_logManager.Log("Wallet '" + walletName + "' deleted.");
+            return;
+        }
+    }
+
+    this->m_logManager.Log("Failed to delete wallet '" + walletName + "'.",
+                           spdlog::level::err);
 }
 
-void WalletManager::Expense(const std::string& walletName,
+bool WalletManager::Expense(const std::string& walletName,
                             const std::string& category,
                             const std::string& date,
                             const std::string& description,
-                            const double_t     amount) noexcept
+                            const Money        amount) noexcept
 {
-    // Check if wallet exists
+    // The checks below only read the cache, so they are done before the
+    // transaction is opened
     if (not this->WalletExists(walletName))
     {
         this->m_logManager.Log("Wallet '" + walletName + "' does not exist.");
-        return;
+        return false;
     }
 
-    // Check if amount is valid
-    if (amount <= 0)
+    if (not amount.IsPositive())
     {
-        this->m_logManager.Log("Invalid income amount.");
-        return;
+        this->m_logManager.Log("Invalid expense amount.");
+        return false;
     }
 
-    // Check if wallet has sufficient balance
-    double_t balance = this->GetBalance(walletName);
+    // The category, the balance and the transaction are written together
+    LedgerStore::Transaction transaction(this->m_store);
 
-    if (balance < amount)
+    if (not transaction.IsActive())
     {
-        this->m_logManager.Log("Insufficient balance in wallet '" + walletName + "'.");
-        return;
+        return false;
     }
 
-    // Check if category exists
-    if (not this->m_categoryManager.CategoryExists(category))
+    std::optional<int64_t> categoryId = this->ResolveCategory(category);
+
+    // The debit only applies if the balance covers the amount, so concurrent
+    // writers cannot overdraw the wallet
+    std::optional<Money> balance =
+        categoryId ? this->m_store.DebitWallet(walletName, amount) : std::nullopt;
+
+    if (categoryId and not balance)
     {
-        this->m_logManager.Log("Category '" + category +
-                               "' does not exist. Creating it.");
-        this->m_categoryManager.CreateCategory(category);
+        this->m_logManager.Log("Insufficient balance in wallet '" + walletName + "'.");
+        return false;
     }
 
-    // Insert transaction
-    try
+    if (balance and
+        this->m_store.InsertWalletTransaction(
+            { walletName, *categoryId, "EXPENSE", date, amount, description }) and
+        this->m_store.AddToSpendingSummary(
+            SpendingOf(date, *categoryId, "EXPENSE", walletName, amount)) and
+        this->m_store.AddToDailyBalance(walletName, date, -amount, *balance + amount))
     {
-        std::string query = fmt::format("INSERT INTO WalletTransaction (wallet, "
-                                        "category_id, type, date, amount, description) "
-                                        "VALUES ('{}', {}, '{}', '{}', {}, '{}');",
-                                        walletName,
-                                        this->m_categoryManager.GetCategoryID(category),
-                                        "EXPENSE",
-                                        date,
-                                        amount,
-                                        description);
+        this->SetCachedBalance(walletName, *balance);
 
-        if (not this->m_dbManager.ExecuteQuery(query))
+        if (transaction.Commit())
         {
-            this->m_logManager.Log("Failed to register expense of " +
-                                       std::to_string(amount) + " in wallet '" +
-                                       walletName + "'.",
-                                   spdlog::level::err);
-            return;
+            this->m_logManager.Log("Expense of " + amount.ToString() +
+                                   " in wallet '" + walletName + "' registered.");
+            return true;
         }
     }
-    catch (std::runtime_error& re)
-    {
-        this->m_logManager.Log(re.what(), spdlog::level::err);
-        return;
-    }
 
-    // Update wallet balance
-    this->UpdateBalance(walletName, balance - amount);
-
-    this->m_logManager.Log("Expense of " + std::to_string(amount) + " in wallet '" +
-                           walletName + "' registered.");
+    this->m_logManager.Log("Failed to register expense of " + amount.ToString() +
+                               " in wallet '" + walletName + "'.",
+                           spdlog::level::err);
+    return false;
 }
 
-void WalletManager::Income(const std::string& walletName,
+bool WalletManager::Income(const std::string& walletName,
                            const std::string& category,
                            const std::string& date,
                            const std::string& description,
-                           const double_t     amount) noexcept
+                           const Money        amount) noexcept
 {
-    // Check if wallet exists
+    // The checks below only read the cache, so they are done before the
+    // transaction is opened
     if (not this->WalletExists(walletName))
     {
         this->m_logManager.Log("Wallet '" + walletName + "' does not exist.");
-        return;
+        return false;
     }
 
-    // Check if amount is valid
-    if (amount <= 0)
+    if (not amount.IsPositive())
     {
         this->m_logManager.Log("Invalid income amount.");
-        return;
+        return false;
     }
 
-    // Check if category exists
-    if (not this->m_categoryManager.CategoryExists(category))
+    // The category, the balance and the transaction are written together
+    LedgerStore::Transaction transaction(this->m_store);
+
+    if (not transaction.IsActive())
     {
-        this->m_logManager.Log("Category '" + category +
-                               "' does not exist. Creating it.");
-        this->m_categoryManager.CreateCategory(category);
+        return false;
     }
 
-    // Insert transaction
-    try
-    {
-        std::string query = fmt::format("INSERT INTO WalletTransaction (wallet, "
-                                        "category_id, type, date, amount, description) "
-                                        "VALUES ('{}', {}, '{}', '{}', {}, '{}');",
-                                        walletName,
-                                        this->m_categoryManager.GetCategoryID(category),
-                                        "INCOME",
-                                        date,
-                                        amount,
-                                        description);
+    std::optional<int64_t> categoryId = this->ResolveCategory(category);
+    std::optional<Money>   balance =
+        categoryId ? this->m_store.CreditWallet(walletName, amount) : std::nullopt;
 
-        this->m_dbManager.ExecuteQuery(query);
-    }
-    catch (std::runtime_error& re)
+    if (balance and
+        this->m_store.InsertWalletTransaction(
+            { walletName, *categoryId, "INCOME", date, amount, description }) and
+        this->m_store.AddToSpendingSummary(
+            SpendingOf(date, *categoryId, "INCOME", walletName, amount)) and
+        this->m_store.AddToDailyBalance(walletName, date, amount, *balance - amount))
     {
-        this->m_logManager.Log(re.what(), spdlog::level::err);
-        return;
+        this->SetCachedBalance(walletName, *balance);
+
+        if (transaction.Commit())
+        {
+            this->m_logManager.Log("Income of " + amount.ToString() +
+                                   " in wallet '" + walletName + "' registered.");
+            return true;
+        }
     }
 
-    // Update wallet balance
-    double_t balance = this->GetBalance(walletName);
-    this->UpdateBalance(walletName, balance + amount);
+    this->m_logManager.Log("Failed to register income of " + amount.ToString() +
+                               " in wallet '" + walletName + "'.",
+                           spdlog::level::err);
+    return false;
+}
+
+std::future<bool> WalletManager::ExpenseAsync(const std::string& walletName,
+                                              const std::string& category,
+                                              const std::string& date,
+                                              const std::string& description,
+                                              const Money        amount) noexcept
+{
+    return this->m_store.Enqueue(
+        [this, walletName, category, date, description, amount]() {
+            return this->Expense(walletName, category, date, description, amount);
+        });
+}
 
-    this->m_logManager.Log("Income of " + std::to_string(amount) + " in wallet '" +
-                           walletName + "' registered.");
+std::future<bool> WalletManager::IncomeAsync(const std::string& walletName,
+                                             const std::string& category,
+                                             const std::string& date,
+                                             const std::string& description,
+                                             const Money        amount) noexcept
+{
+    return this->m_store.Enqueue(
+        [this, walletName, category, date, description, amount]() {
+            return this->Income(walletName, category, date, description, amount);
+        });
 }
 
 void WalletManager::Transfer(const std::string& fromWallet,
                              const std::string& toWallet,
                              const std::string& date,
-                             const double_t     amount) noexcept
+                             const Money        amount) noexcept
 {
-    // Check if wallets exist
+    // The checks below only read the cache, so they are done before the
+    // transaction is opened
     if (not this->WalletExists(fromWallet))
     {
         this->m_logManager.Log("Source wallet '" + fromWallet + "' does not exist.");
@@ -239,91 +285,445 @@ void WalletManager::Transfer(const std::string& fromWallet,
         return;
     }
 
-    if (amount <= 0)
+    if (not amount.IsPositive())
     {
         this->m_logManager.Log("Invalid transfer amount.");
         return;
     }
 
-    // Check if fromWallet has sufficient balance
-    double_t balance = this->GetBalance(fromWallet);
+    // Both balances and the transfer are written together
+    LedgerStore::Transaction transaction(this->m_store);
 
-    if (balance < amount)
+    if (not transaction.IsActive())
+    {
+        return;
+    }
+
+    // The debit only applies if the balance covers the amount
+    std::optional<Money> fromBalance = this->m_store.DebitWallet(fromWallet, amount);
+
+    if (not fromBalance)
     {
         this->m_logManager.Log("Insufficient balance in source wallet '" + fromWallet +
                                "'.");
         return;
     }
 
-    // Insert transaction
-    try
-    {
-        std::string query = fmt::format("INSERT INTO Transfer (sender_wallet, "
-                                        "receiver_wallet, date, amount) "
-                                        "VALUES ('{}', {}, '{}', '{}');",
-                                        fromWallet,
-                                        toWallet,
+    std::optional<Money> toBalance = this->m_store.CreditWallet(toWallet, amount);
+
+    if (toBalance and
+        this->m_store.InsertTransfer({ fromWallet, toWallet, date, amount }) and
+        this->m_store.AddToDailyBalance(fromWallet,
                                         date,
-                                        amount);
+                                        -amount,
+                                        *fromBalance + amount) and
+        this->m_store.AddToDailyBalance(toWallet, date, amount, *toBalance - amount))
+    {
+        this->SetCachedBalance(fromWallet, *fromBalance);
+        this->SetCachedBalance(toWallet, *toBalance);
 
-        this->m_dbManager.ExecuteQuery(query);
+        if (transaction.Commit())
+        {
+            this->m_logManager.Log("Transfer of " + amount.ToString() +
+                                   " from wallet '" + fromWallet + "' to wallet '" +
+                                   toWallet + "' registered.");
+            return;
+        }
     }
-    catch (std::runtime_error& re)
+
+    this->m_logManager.Log("Failed to register transfer of " + amount.ToString() +
+                               " from wallet '" + fromWallet + "' to wallet '" +
+                               toWallet + "'.",
+                           spdlog::level::err);
+}
+
+bool WalletManager::RecordBatch(std::span<const WalletOp> ops,
+                                std::vector<OpStatus>&    results) noexcept
+{
+    // Balance of each wallet as the batch is checked, and its net change in
+    // total and on each day
+    struct WalletState
     {
-        this->m_logManager.Log(re.what(), spdlog::level::err);
-        return;
+            Money                        balance;
+            Money                        delta;
+            std::map<std::string, Money> days;
+    };
+
+    std::unordered_map<std::string, WalletState> wallets;
+
+    auto findWallet = [this, &wallets](const std::string& name) -> WalletState* {
+        auto it = wallets.find(name);
+
+        if (it == wallets.end())
+        {
+            std::optional<Money> balance = this->GetCachedBalance(name);
+
+            if (not balance)
+            {
+                return nullptr;
+            }
+
+            it = wallets.emplace(name, WalletState{ *balance, Money(), {} }).first;
+        }
+
+        return &it->second;
+    };
+
+    // Accepted operations stay Failed until the batch is committed
+    results.assign(ops.size(), OpStatus::Failed);
+
+    std::size_t accepted = 0;
+
+    for (std::size_t i = 0; i < ops.size(); i++)
+    {
+        const WalletOp& op = ops[i];
+
+        WalletState* from = findWallet(op.wallet);
+        WalletState* to   = op.type == WalletOp::Type::Transfer
+                                ? findWallet(op.toWallet)
+                                : nullptr;
+
+        if (not from or (op.type == WalletOp::Type::Transfer and not to))
+        {
+            results[i] = OpStatus::WalletNotFound;
+        }
+        else if (op.type == WalletOp::Type::Transfer and op.wallet == op.toWallet)
+        {
+            results[i] = OpStatus::SameWallet;
+        }
+        else if (not op.amount.IsPositive())
+        {
+            results[i] = OpStatus::InvalidAmount;
+        }
+        else if (op.type != WalletOp::Type::Income and from->balance < op.amount)
+        {
+            results[i] = OpStatus::InsufficientBalance;
+        }
+        else
+        {
+            Money change = op.type == WalletOp::Type::Income ? op.amount : -op.amount;
+
+            from->balance += change;
+            from->delta += change;
+            from->days[op.date] += change;
+
+            if (to)
+            {
+                to->balance += op.amount;
+                to->delta += op.amount;
+                to->days[op.date] += op.amount;
+            }
+
+            accepted++;
+        }
+    }
+
+    if (accepted == 0)
+    {
+        return true;
+    }
+
+    // Everything accepted is written together
+    LedgerStore::Transaction transaction(this->m_store);
+
+    if (not transaction.IsActive())
+    {
+        return false;
+    }
+
+    std::unordered_map<std::string, int64_t> categories;
+
+    for (auto& [name, id] : this->m_store.GetCategories())
+    {
+        categories.emplace(std::move(name), id);
+    }
+
+    std::vector<WalletTransactionRecord> records;
+    std::vector<TransferRecord>          transfers;
+
+    for (std::size_t i = 0; i < ops.size(); i++)
+    {
+        const WalletOp& op = ops[i];
+
+        if (results[i] != OpStatus::Failed)
+        {
+            continue;
+        }
+
+        if (op.type == WalletOp::Type::Transfer)
+        {
+            transfers.push_back({ op.wallet, op.toWallet, op.date, op.amount });
+            continue;
+        }
+
+        auto category = categories.find(op.category);
+
+        if (category == categories.end())
+        {
+            this->m_logManager.Log("Category '" + op.category +
+                                   "' does not exist. Creating it.");
+
+            std::optional<int64_t> id = this->m_store.InsertCategory(op.category);
+
+            if (not id)
+            {
+                this->m_logManager.Log("Failed to create category '" + op.category +
+                                           "'.",
+                                       spdlog::level::err);
+                return false;
+            }
+
+            category = categories.emplace(op.category, *id).first;
+        }
+
+        records.push_back({ op.wallet,
+                            category->second,
+                            op.type == WalletOp::Type::Income ? "INCOME" : "EXPENSE",
+                            op.date,
+                            op.amount,
+                            op.description });
+    }
+
+    bool recorded = this->m_store.InsertWalletTransactions(records) and
+                    this->m_store.InsertTransfers(transfers);
+
+    // Operations that share a cell of the spending summary are merged first, so
+    // each cell is written once
+    std::map<std::tuple<std::string, int64_t, std::string, std::string>, SpendingCell>
+        spending;
+
+    for (const WalletTransactionRecord& record : records)
+    {
+        SpendingCell cell = SpendingOf(record.date,
+                                       record.categoryId,
+                                       record.type,
+                                       record.wallet,
+                                       record.amount);
+
+        auto [it, added] = spending.try_emplace(
+            { cell.month, cell.categoryId, cell.kind, cell.source },
+            cell);
+
+        if (not added)
+        {
+            it->second.Merge(cell);
+        }
+    }
+
+    for (auto it = spending.begin(); recorded and it != spending.end(); ++it)
+    {
+        recorded = this->m_store.AddToSpendingSummary(it->second);
+    }
+
+    // The net change of a wallet is applied with a single update. A debit is
+    // still guarded, in case the cache missed a write made by someone else
+    for (auto it = wallets.begin(); recorded and it != wallets.end(); ++it)
+    {
+        const auto& [name, state] = *it;
+
+        if (state.days.empty())
+        {
+            continue;
+        }
+
+        std::optional<Money> balance;
+
+        if (state.delta > Money())
+        {
+            balance = this->m_store.CreditWallet(name, state.delta);
+        }
+        else if (state.delta < Money())
+        {
+            balance = this->m_store.DebitWallet(name, -state.delta);
+        }
+        else
+        {
+            balance = this->m_store.GetWalletBalance(name);
+        }
+
+        if (not balance)
+        {
+            this->m_logManager.Log("Insufficient balance in wallet '" + name + "'.");
+            recorded = false;
+            break;
+        }
+
+        this->SetCachedBalance(name, *balance);
+
+        // Each day the wallet moved on is patched once
+        Money opening = *balance - state.delta;
+
+        for (const auto& [date, delta] : state.days)
+        {
+            recorded = recorded and this->m_store.AddToDailyBalance(name,
+                                                                    date,
+                                                                    delta,
+                                                                    opening);
+        }
+    }
+
+    if (not recorded or not transaction.Commit())
+    {
+        // A guarded debit that failed means the cache missed a write made by
+        // someone else
+        this->InvalidateCache();
+        this->m_logManager.Log("Failed to record batch of " +
+                                   std::to_string(ops.size()) + " operations.",
+                               spdlog::level::err);
+        return false;
+    }
+
+    for (OpStatus& status : results)
+    {
+        if (status == OpStatus::Failed)
+        {
+            status = OpStatus::Recorded;
+        }
     }
 
-    // Update wallet balances
-    this->UpdateBalance(fromWallet, balance - amount);
-    this->UpdateBalance(toWallet, this->GetBalance(toWallet) + amount);
+    this->m_logManager.Log("Batch of " + std::to_string(ops.size()) +
+                           " operations recorded, " +
+                           std::to_string(ops.size() - accepted) + " rejected.");
 
-    this->m_logManager.Log("Transfer of " + std::to_string(amount) + " from wallet '" +
-                           fromWallet + "' to wallet '" + toWallet + "' registered.");
+    return true;
 }
 
-bool WalletManager::WalletExists(const std::string& walletName) noexcept
+bool WalletManager::GetBalanceAsOf(const std::string& walletName,
+                                   const std::string& date,
+                                   Money&             balance) noexcept
 {
-    std::string query =
-        "SELECT COUNT(*) FROM Wallet WHERE name = '" + walletName + "';";
+    std::optional<Money> balanceAsOf = this->m_store.GetBalanceAsOf(walletName, date);
+
+    if (not balanceAsOf)
+    {
+        this->m_logManager.Log("Wallet '" + walletName + "' does not exist.");
+        return false;
+    }
 
-    int count = 0;
+    balance = *balanceAsOf;
+    return true;
+}
 
-    this->m_dbManager.ExecuteQueryWithResult(query, [&count](sqlite3_stmt* stmt) {
-        count = sqlite3_column_int(stmt, 0);
-    });
+bool WalletManager::GetBalanceSeries(const std::string&        walletName,
+                                     const std::string&        from,
+                                     const std::string&        to,
+                                     std::vector<std::string>& dates,
+                                     std::vector<Money>&       balances) noexcept
+{
+    dates.clear();
+    balances.clear();
 
-    return count > 0;
+    if (not this->WalletExists(walletName))
+    {
+        this->m_logManager.Log("Wallet '" + walletName + "' does not exist.");
+        return false;
+    }
+
+    for (auto& [date, balance] : this->m_store.GetBalanceSeries(walletName, from, to))
+    {
+        dates.push_back(std::move(date));
+        balances.push_back(balance);
+    }
+
+    return true;
 }
 
-void WalletManager::UpdateBalance(const std::string& walletName,
-                                  const double_t     newBalance) noexcept
+void WalletManager::InvalidateCache() noexcept
 {
-    std::string query = fmt::format("UPDATE Wallet SET balance = {} WHERE name = '{}';",
-                                    newBalance,
-                                    walletName);
+    std::lock_guard lock(this->m_cacheMutex);
 
-    if (this->WalletExists(walletName))
+    this->m_balances.clear();
+    this->m_cacheLoaded = false;
+}
+
+void WalletManager::ReloadCache() noexcept
+{
+    // Read outside the cache lock, which must never be held while waiting for the
+    // store
+    std::unordered_map<std::string, Money> balances;
+
+    // Taken before the read, so a restore that runs meanwhile reloads it again
+    uint64_t generation = this->m_store.GetGeneration();
+
+    for (auto& [name, balance] : this->m_store.GetWalletBalances())
     {
-        this->m_dbManager.ExecuteQuery(query);
-        this->m_logManager.Log("Balance for wallet '" + walletName + "' updated.");
+        balances.emplace(std::move(name), balance);
     }
-    else
+
+    std::lock_guard lock(this->m_cacheMutex);
+
+    this->m_balances        = std::move(balances);
+    this->m_cacheLoaded     = true;
+    this->m_cacheGeneration = generation;
+}
+
+std::optional<Money>
+WalletManager::GetCachedBalance(const std::string& walletName) noexcept
+{
+    uint64_t generation = this->m_store.GetGeneration();
+
     {
-        this->m_logManager.Log("Wallet '" + walletName + "' does not exist.");
+        std::lock_guard lock(this->m_cacheMutex);
+
+        if (this->m_cacheLoaded and this->m_cacheGeneration == generation)
+        {
+            auto it = this->m_balances.find(walletName);
+
+            if (it == this->m_balances.end())
+            {
+                return std::nullopt;
+            }
+
+            return it->second;
+        }
     }
+
+    this->ReloadCache();
+    return this->GetCachedBalance(walletName);
 }
 
-double_t WalletManager::GetBalance(const std::string& walletName) noexcept
+void WalletManager::SetCachedBalance(const std::string&   walletName,
+                                     std::optional<Money> balance) noexcept
 {
-    std::string query =
-        fmt::format("SELECT balance FROM Wallet WHERE name = '{}';", walletName);
+    // A write that is still inside a transaction may be rolled back, so the
+    // cache only follows it once the outermost transaction commits
+    this->m_store.AfterCommit([this, walletName, balance]() {
+        std::lock_guard lock(this->m_cacheMutex);
 
-    double_t balance = 0.0;
+        if (not this->m_cacheLoaded)
+        {
+            return;
+        }
 
-    this->m_dbManager.ExecuteQueryWithResult(query, [&balance](sqlite3_stmt* stmt) {
-        balance = sqlite3_column_double(stmt, 0);
+        if (balance)
+        {
+            this->m_balances[walletName] = *balance;
+        }
+        else
+        {
+            this->m_balances.erase(walletName);
+        }
     });
+}
+
+bool WalletManager::WalletExists(const std::string& walletName) noexcept
+{
+    return this->GetCachedBalance(walletName).has_value();
+}
+
+std::optional<int64_t>
+WalletManager::ResolveCategory(const std::string& category) noexcept
+{
+    std::optional<int64_t> categoryId = this->m_store.FindCategory(category);
+
+    if (not categoryId)
+    {
+        this->m_logManager.Log("Category '" + category +
+                               "' does not exist. Creating it.");
+        this->m_categoryManager.CreateCategory(category);
+
+        categoryId = this->m_store.FindCategory(category);
+    }
 
-    return balance;
+    return categoryId;
 }
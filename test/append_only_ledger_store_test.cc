@@ -0,0 +1,161 @@
+/*
+ * Filename: append_only_ledger_store_test.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "append_only_ledger_store.h"
+#include "config.h"
+#include "db_manager.h"
+#include "sql_queries.h"
+#include "wallet_manager.h"
+
+class AppendOnlyLedgerStoreTest : public testing::Test
+{
+    protected:
+        DBManager             m_dbManager;
+        AppendOnlyLedgerStore m_store;
+
+        int64_t Count(const std::string& table)
+        {
+            return m_dbManager.QueryOne<int64_t>("SELECT COUNT(*) FROM " + table + ";")
+                .value_or(-1);
+        }
+
+        Money WalletRowBalance(const std::string& name)
+        {
+            return m_dbManager.QueryOne<Money>(query::SELECT_WALLET_BALANCE, name)
+                .value_or(Money(-1));
+        }
+
+    public:
+        AppendOnlyLedgerStoreTest()
+            : m_dbManager(config::IN_MEMORY_DATABASE),
+              m_store(m_dbManager, 4)
+        { }
+};
+
+TEST_F(AppendOnlyLedgerStoreTest, ChangesAreAppended)
+{
+    ASSERT_TRUE(m_store.InsertWallet("w1", Money(100)));
+
+    EXPECT_EQ(Money(110.5), m_store.CreditWallet("w1", Money(10.5)));
+    EXPECT_EQ(Money(110.2), m_store.DebitWallet("w1", Money(0.3)));
+    EXPECT_FALSE(m_store.DebitWallet("w1", Money(110.21)).has_value());
+    EXPECT_FALSE(m_store.CreditWallet("none", Money(1)).has_value());
+
+    EXPECT_EQ(Money(110.2), m_store.GetWalletBalance("w1"));
+
+    // The row of the wallet keeps the balance it entered the ledger with
+    EXPECT_EQ(Money(100), WalletRowBalance("w1"));
+    EXPECT_EQ(2, Count("WalletLedgerEntry"));
+
+    ASSERT_TRUE(m_store.SetWalletBalance("w1", Money(50)));
+    EXPECT_EQ(Money(50), m_store.GetWalletBalance("w1"));
+    EXPECT_EQ(3, Count("WalletLedgerEntry"));
+}
+
+TEST_F(AppendOnlyLedgerStoreTest, CheckpointsEveryIntervalEntries)
+{
+    ASSERT_TRUE(m_store.InsertWallet("w1", Money(0)));
+
+    for (int i = 1; i <= 10; i++)
+    {
+        ASSERT_TRUE(m_store.CreditWallet("w1", Money(i)).has_value());
+    }
+
+    // Seq 0, 4 and 8
+    EXPECT_EQ(3, Count("WalletBalanceCheckpoint"));
+    EXPECT_EQ(Money(55), m_store.GetWalletBalance("w1"));
+
+    EXPECT_EQ(Money(0), m_store.GetBalanceAfterEntry("w1", 0));
+    EXPECT_EQ(Money(15), m_store.GetBalanceAfterEntry("w1", 5));
+    EXPECT_EQ(Money(36), m_store.GetBalanceAfterEntry("w1", 8));
+    EXPECT_EQ(Money(55), m_store.GetBalanceAfterEntry("w1", 100));
+    EXPECT_FALSE(m_store.GetBalanceAfterEntry("none", 1).has_value());
+}
+
+TEST_F(AppendOnlyLedgerStoreTest, ExistingWalletEntersLedger)
+{
+    // Created in place, before the ledger was used
+    ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "w1", Money(20)));
+    ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "w2", Money(5)));
+
+    EXPECT_EQ(Money(25), m_store.CreditWallet("w1", Money(5)));
+    EXPECT_EQ(1, Count("WalletBalanceCheckpoint"));
+
+    std::vector<std::pair<std::string, Money>> balances = m_store.GetWalletBalances();
+
+    ASSERT_EQ(2, balances.size());
+    EXPECT_EQ(std::make_pair(std::string("w1"), Money(25)), balances[0]);
+    EXPECT_EQ(std::make_pair(std::string("w2"), Money(5)), balances[1]);
+
+    ASSERT_TRUE(m_store.DeleteWallet("w1"));
+    EXPECT_EQ(0, Count("WalletLedgerEntry"));
+    EXPECT_EQ(0, Count("WalletBalanceCheckpoint"));
+}
+
+TEST_F(AppendOnlyLedgerStoreTest, WalletManagerOnLedger)
+{
+    WalletManager walletManager(m_store);
+
+    walletManager.CreateWallet("w1", Money(100));
+    walletManager.CreateWallet("w2", Money(0));
+
+    ASSERT_TRUE(walletManager.Expense("w1", "Food", "2024-01-02", "Market", Money(30)));
+    ASSERT_TRUE(walletManager.Income("w1", "Job", "2024-01-03", "Salary", Money(12.5)));
+    walletManager.Transfer("w1", "w2", "2024-01-04", Money(50));
+
+    // Another manager reads the balances from the ledger, not from its cache
+    WalletManager            reader(m_store);
+    std::vector<std::string> wallets;
+    std::vector<Money>       balances;
+
+    reader.GetWallets(wallets, balances);
+
+    EXPECT_EQ(std::vector<std::string>({ "w1", "w2" }), wallets);
+    EXPECT_EQ(std::vector<Money>({ Money(32.5), Money(50) }), balances);
+
+    Money balance;
+
+    ASSERT_TRUE(reader.GetBalanceAsOf("w1", "2024-01-03", balance));
+    EXPECT_EQ(Money(82.5), balance);
+
+    EXPECT_EQ(Money(100), WalletRowBalance("w1"));
+}
+
+TEST_F(AppendOnlyLedgerStoreTest, PlainStoreSharesLedgerWallets)
+{
+    WalletManager ledgerManager(m_store);
+
+    ledgerManager.CreateWallet("w", Money(100));
+    ASSERT_TRUE(ledgerManager.Expense("w", "", "", "", Money(60)));
+
+    // A manager on the plain store reads and changes the same wallet
+    WalletManager            plainManager(m_dbManager);
+    std::vector<std::string> wallets;
+    std::vector<Money>       balances;
+
+    plainManager.GetWallets(wallets, balances);
+
+    EXPECT_EQ(std::vector<Money>({ Money(40) }), balances);
+    EXPECT_FALSE(plainManager.Expense("w", "", "", "", Money(90)));
+    EXPECT_TRUE(plainManager.Income("w", "", "", "", Money(15)));
+    EXPECT_TRUE(plainManager.Expense("w", "", "", "", Money(50)));
+
+    // The changes went to the ledger, which the ledger store sees
+    EXPECT_EQ(Money(5), m_store.GetWalletBalance("w"));
+    EXPECT_EQ(Money(100), WalletRowBalance("w"));
+    EXPECT_EQ(3, Count("WalletLedgerEntry"));
+
+    SqliteLedgerStore plainStore(m_dbManager);
+
+    ASSERT_TRUE(plainStore.SetWalletBalance("w", Money(20)));
+    EXPECT_EQ(Money(20), m_store.GetWalletBalance("w"));
+}
@@ -0,0 +1,133 @@
+/*
+ * Filename: async_writer_test.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "async_writer.h"
+#include "db_manager.h"
+#include "sql_queries.h"
+
+class AsyncWriterTest : public testing::Test
+{
+    protected:
+        DBManager m_dbManager;
+
+        AsyncWriterTest()
+            : m_dbManager(config::IN_MEMORY_DATABASE)
+        { }
+
+        int64_t CountWallets()
+        {
+            int64_t count = 0;
+            m_dbManager.Query("SELECT COUNT(*) FROM Wallet",
+                              [&count](sqlite3_stmt* stmt) {
+                                  count = sqlite3_column_int64(stmt, 0);
+                              });
+            return count;
+        }
+};
+
+TEST_F(AsyncWriterTest, OperationsAreGroupCommitted)
+{
+    AsyncWriter writer(m_dbManager, std::chrono::milliseconds(50), 1000);
+
+    std::vector<std::future<bool>> results;
+
+    for (int i = 0; i < 100; i++)
+    {
+        std::string name = "w" + std::to_string(i);
+        results.push_back(writer.Enqueue([this, name, i]() {
+            return m_dbManager.Execute(query::INSERT_WALLET, name, i);
+        }));
+    }
+
+    for (std::future<bool>& result : results)
+    {
+        EXPECT_TRUE(result.get());
+    }
+
+    EXPECT_EQ(100, CountWallets());
+
+    AsyncWriter::Stats stats = writer.GetStats();
+
+    EXPECT_EQ(100, stats.operations);
+    EXPECT_EQ(0, stats.failed);
+    EXPECT_LT(stats.batches, stats.operations);
+}
+
+TEST_F(AsyncWriterTest, FailedOperationIsRolledBackAlone)
+{
+    AsyncWriter writer(m_dbManager, std::chrono::milliseconds(50), 1000);
+
+    std::future<bool> first = writer.Enqueue(
+        [this]() { return m_dbManager.Execute(query::INSERT_WALLET, "w1", 1); });
+
+    // Writes, then fails, so its insert must be undone
+    std::future<bool> failed = writer.Enqueue([this]() {
+        m_dbManager.Execute(query::INSERT_WALLET, "w2", 2);
+        return false;
+    });
+
+    std::future<bool> throwing = writer.Enqueue([this]() -> bool {
+        m_dbManager.Execute(query::INSERT_WALLET, "w3", 3);
+        throw std::runtime_error("failure");
+    });
+
+    std::future<bool> last = writer.Enqueue(
+        [this]() { return m_dbManager.Execute(query::INSERT_WALLET, "w4", 4); });
+
+    EXPECT_TRUE(first.get());
+    EXPECT_FALSE(failed.get());
+    EXPECT_FALSE(throwing.get());
+    EXPECT_TRUE(last.get());
+
+    EXPECT_EQ(2, CountWallets());
+    EXPECT_EQ(2, writer.GetStats().failed);
+}
+
+TEST_F(AsyncWriterTest, FlushWaitsForQueuedOperations)
+{
+    AsyncWriter writer(m_dbManager, std::chrono::milliseconds(10), 1000);
+
+    std::vector<std::thread> producers;
+
+    for (int t = 0; t < 4; t++)
+    {
+        producers.emplace_back([this, &writer, t]() {
+            for (int i = 0; i < 25; i++)
+            {
+                std::string name = "w" + std::to_string(t) + "_" + std::to_string(i);
+                writer.Enqueue([this, name]() {
+                    return m_dbManager.Execute(query::INSERT_WALLET, name, 0);
+                });
+            }
+        });
+    }
+
+    for (std::thread& producer : producers)
+    {
+        producer.join();
+    }
+
+    ASSERT_TRUE(writer.Flush());
+    EXPECT_EQ(100, CountWallets());
+}
+
+TEST_F(AsyncWriterTest, FlushInsideTransactionFails)
+{
+    m_dbManager.Enqueue([]() { return true; });
+
+    DBManager::Transaction transaction(m_dbManager);
+
+    EXPECT_FALSE(m_dbManager.Flush());
+}
@@ -0,0 +1,208 @@
+/*
+ * Filename: balance_reconciler_test.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include <cmath>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+#include "append_only_ledger_store.h"
+#include "balance_reconciler.h"
+#include "config.h"
+#include "db_manager.h"
+#include "sql_queries.h"
+#include "wallet_manager.h"
+
+/**
+ * @brief Reconciles a database file, so the partitions run on reader connections
+ **/
+class BalanceReconcilerTest : public testing::Test
+{
+    protected:
+        std::string       m_path;
+        DBManager         m_dbManager;
+        WalletManager     m_walletManager;
+        BalanceReconciler m_reconciler;
+
+        static std::string Path()
+        {
+            std::string path = config::DATABASE_PATH + "balance_reconciler_test_" +
+                               std::to_string(getpid()) + ".db";
+            RemoveFiles(path);
+            return path;
+        }
+
+        static void RemoveFiles(const std::string& path)
+        {
+            std::error_code error;
+
+            for (const char* suffix : { "", "-wal", "-shm" })
+            {
+                std::filesystem::remove(path + suffix, error);
+            }
+        }
+
+        void SetUp() override
+        {
+            // Ten wallets, each with expenses, an income and transfers
+            for (int i = 0; i < 10; i++)
+            {
+                std::string wallet = "w" + std::to_string(i);
+
+                m_walletManager.CreateWallet(wallet, Money(100));
+                m_walletManager.Expense(wallet,
+                                        "Food",
+                                        "2024-01-02",
+                                        "Market",
+                                        Money(10.1));
+                m_walletManager.Income(wallet,
+                                       "Job",
+                                       "2024-01-05",
+                                       "Salary",
+                                       Money(50.05));
+                m_walletManager.Expense(wallet,
+                                        "Food",
+                                        "2024-01-09",
+                                        "Bakery",
+                                        Money(0.3));
+            }
+
+            m_walletManager.Transfer("w0", "w5", "2024-01-10", Money(20));
+            m_walletManager.Transfer("w5", "w9", "2024-01-11", Money(0.7));
+        }
+
+        void TearDown() override
+        {
+            RemoveFiles(m_path);
+        }
+
+    public:
+        BalanceReconcilerTest()
+            : m_path(Path()),
+              m_dbManager(m_path),
+              m_walletManager(m_dbManager),
+              m_reconciler(m_dbManager, 4)
+        { }
+};
+
+TEST_F(BalanceReconcilerTest, NoMismatchAfterManagerWrites)
+{
+    std::vector<BalanceReconciler::Mismatch> mismatches;
+    BalanceReconciler::Stats                 stats;
+
+    ASSERT_TRUE(m_reconciler.Check(mismatches, stats));
+
+    EXPECT_TRUE(mismatches.empty());
+    EXPECT_EQ(10, stats.wallets);
+    EXPECT_EQ(4, stats.partitions);
+    EXPECT_EQ(0, stats.mismatches);
+}
+
+TEST_F(BalanceReconcilerTest, CheckAndRepairDrift)
+{
+    // Balances changed behind the history
+    ASSERT_TRUE(m_dbManager.Execute(query::UPDATE_WALLET_BALANCE, Money(1), "w3"));
+    ASSERT_TRUE(m_dbManager.Execute(query::UPDATE_WALLET_BALANCE, Money(500), "w7"));
+
+    std::vector<BalanceReconciler::Mismatch> mismatches;
+    BalanceReconciler::Stats                 stats;
+
+    ASSERT_TRUE(m_reconciler.Check(mismatches, stats));
+
+    ASSERT_EQ(2, mismatches.size());
+    EXPECT_EQ("w3", mismatches[0].wallet);
+    EXPECT_EQ(Money(1), mismatches[0].stored);
+    EXPECT_EQ(Money(139.65), mismatches[0].computed);
+    EXPECT_EQ("w7", mismatches[1].wallet);
+    EXPECT_EQ(Money(500), mismatches[1].stored);
+
+    // A check changes nothing
+    ASSERT_TRUE(m_reconciler.Check(mismatches, stats));
+    EXPECT_EQ(2, stats.mismatches);
+
+    ASSERT_TRUE(m_reconciler.Repair(mismatches, stats));
+    EXPECT_EQ(2, stats.repaired);
+
+    ASSERT_TRUE(m_reconciler.Check(mismatches, stats));
+    EXPECT_TRUE(mismatches.empty());
+
+    // The daily balances are rebuilt along with the balance
+    WalletManager walletManager(m_dbManager);
+    Money         balance;
+
+    ASSERT_TRUE(walletManager.GetBalanceAsOf("w3", "2024-12-31", balance));
+    EXPECT_EQ(Money(139.65), balance);
+
+    ASSERT_TRUE(walletManager.GetBalanceAsOf("w3", "2024-01-03", balance));
+    EXPECT_EQ(Money(89.9), balance);
+}
+
+TEST_F(BalanceReconcilerTest, TransfersAreReconciled)
+{
+    // w5 received 20 and sent 0.7
+    ASSERT_TRUE(m_dbManager.Execute(query::UPDATE_WALLET_BALANCE, Money(139.65), "w5"));
+
+    std::vector<BalanceReconciler::Mismatch> mismatches;
+    BalanceReconciler::Stats                 stats;
+
+    ASSERT_TRUE(m_reconciler.Repair(mismatches, stats));
+
+    ASSERT_EQ(1, mismatches.size());
+    EXPECT_EQ("w5", mismatches[0].wallet);
+    EXPECT_EQ(Money(158.95), mismatches[0].computed);
+    EXPECT_EQ(1, stats.repaired);
+}
+
+TEST_F(BalanceReconcilerTest, LedgerWalletIsCorrectedWithEntry)
+{
+    AppendOnlyLedgerStore store(m_dbManager);
+    WalletManager         walletManager(store);
+
+    walletManager.CreateWallet("ledger", Money(10));
+    ASSERT_TRUE(walletManager.Expense("ledger",
+                                      "Food",
+                                      "2024-01-02",
+                                      "Market",
+                                      Money(4)));
+
+    // An entry with no transaction behind it
+    ASSERT_TRUE(m_dbManager.Execute(query::APPEND_WALLET_LEDGER_ENTRY,
+                                    "ledger",
+                                    int64_t{ 250 }));
+
+    std::vector<BalanceReconciler::Mismatch> mismatches;
+    BalanceReconciler::Stats                 stats;
+
+    ASSERT_TRUE(m_reconciler.Repair(mismatches, stats));
+
+    ASSERT_EQ(1, mismatches.size());
+    EXPECT_EQ("ledger", mismatches[0].wallet);
+    EXPECT_EQ(Money(8.5), mismatches[0].stored);
+    EXPECT_EQ(Money(6), mismatches[0].computed);
+
+    EXPECT_EQ(Money(6), store.GetWalletBalance("ledger"));
+    EXPECT_EQ(3,
+              m_dbManager
+                  .QueryOne<int64_t>("SELECT COUNT(*) FROM WalletLedgerEntry;")
+                  .value_or(-1));
+}
+
+TEST(BalanceReconcilerEmptyTest, NoWallets)
+{
+    DBManager         dbManager(config::IN_MEMORY_DATABASE);
+    BalanceReconciler reconciler(dbManager);
+
+    std::vector<BalanceReconciler::Mismatch> mismatches;
+    BalanceReconciler::Stats                 stats;
+
+    ASSERT_TRUE(reconciler.Check(mismatches, stats));
+    EXPECT_TRUE(mismatches.empty());
+    EXPECT_EQ(0, stats.wallets);
+    EXPECT_EQ(0, stats.partitions);
+}
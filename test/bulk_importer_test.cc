@@ -0,0 +1,258 @@
+/*
+ * Filename: bulk_importer_test.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+
+#include "append_only_ledger_store.h"
+#include "bulk_importer.h"
+#include "category_manager.h"
+#include "config.h"
+#include "db_manager.h"
+#include "sql_queries.h"
+#include "wallet_manager.h"
+
+class BulkImporterTest : public testing::Test
+{
+    protected:
+        DBManager       m_dbManager;
+        WalletManager   m_walletManager;
+        CategoryManager m_categoryManager;
+        BulkImporter    m_importer;
+
+        int64_t CountTransactions(const std::string& type)
+        {
+            return m_dbManager
+                .QueryOne<int64_t>("SELECT COUNT(*) FROM WalletTransaction "
+                                   "WHERE type = ?;",
+                                   type)
+                .value_or(-1);
+        }
+
+        double_t Balance()
+        {
+            return m_dbManager.QueryOne<Money>(query::SELECT_WALLET_BALANCE, "w1")
+                .value_or(Money(-1))
+                .ToDouble();
+        }
+
+    public:
+        BulkImporterTest()
+            : m_dbManager(config::IN_MEMORY_DATABASE),
+              m_walletManager(m_dbManager),
+              m_categoryManager(m_dbManager),
+              m_importer(m_dbManager)
+        {
+            m_walletManager.CreateWallet("w1", Money(100));
+        }
+};
+
+TEST_F(BulkImporterTest, ImportCsv)
+{
+    m_categoryManager.CreateCategory("Food");
+
+    std::string csv = "date,description,category,amount\r\n"
+                      "2024-01-02,Market,Food,-30.5\r\n"
+                      "2024-01-03,\"Salary, January\",Job,1000\r\n"
+                      "2024-01-04,\"The \"\"best\"\" pizza\",Food,-19.5\r\n"
+                      "\r\n"
+                      "2024-02-30,Invalid date,Food,-1\r\n"
+                      "2024-01-05,Invalid amount,Food,abc\r\n"
+                      "2024-01-06,Too few fields,-1\r\n"
+                      "2024-01-07,Refund,,+50";
+
+    BulkImporter::Stats stats;
+
+    ASSERT_TRUE(m_importer.ImportText(csv, "w1", BulkImporter::Format::Csv, stats));
+
+    EXPECT_EQ(7, stats.rows);
+    EXPECT_EQ(4, stats.imported);
+    EXPECT_EQ(3, stats.rejected);
+
+    EXPECT_DOUBLE_EQ(100 - 30.5 + 1000 - 19.5 + 50, Balance());
+
+    // The daily balances follow the imported rows
+    EXPECT_DOUBLE_EQ(100 - 30.5 + 1000,
+                     m_dbManager
+                         .QueryOne<Money>(query::SELECT_WALLET_BALANCE_AS_OF,
+                                          "w1",
+                                          "2024-01-03")
+                         .value_or(Money(-1))
+                         .ToDouble());
+
+    EXPECT_EQ(2, CountTransactions("EXPENSE"));
+    EXPECT_EQ(2, CountTransactions("INCOME"));
+
+    EXPECT_TRUE(m_categoryManager.CategoryExists("Job"));
+    EXPECT_TRUE(m_categoryManager.CategoryExists(config::IMPORT_DEFAULT_CATEGORY));
+
+    EXPECT_EQ("The \"best\" pizza",
+              m_dbManager
+                  .QueryOne<std::string>("SELECT description FROM WalletTransaction "
+                                         "WHERE date = '2024-01-04';")
+                  .value_or(""));
+
+    EXPECT_EQ("Salary, January",
+              m_dbManager
+                  .QueryOne<std::string>("SELECT description FROM WalletTransaction "
+                                         "WHERE type = 'INCOME' AND amount = 100000;")
+                  .value_or(""));
+}
+
+TEST_F(BulkImporterTest, ImportManyChunks)
+{
+    std::string csv;
+
+    std::size_t rows = config::IMPORT_CHUNK_ROWS * 2 + 7;
+
+    for (std::size_t i = 0; i < rows; i++)
+    {
+        csv += "2024-03-01,Coffee,Food,-0.5\n";
+    }
+
+    BulkImporter::Stats stats;
+
+    ASSERT_TRUE(m_importer.ImportText(csv, "w1", BulkImporter::Format::Csv, stats));
+
+    EXPECT_EQ(rows, stats.imported);
+    EXPECT_EQ(static_cast<int64_t>(rows), CountTransactions("EXPENSE"));
+    EXPECT_DOUBLE_EQ(100 - 0.5 * static_cast<double>(rows), Balance());
+}
+
+TEST_F(BulkImporterTest, ImportOfxFile)
+{
+    std::string path = config::DATABASE_PATH + "bulk_importer_test_" +
+                       std::to_string(getpid()) + ".ofx";
+
+    {
+        std::ofstream file(path);
+
+        file << "OFXHEADER:100\n"
+                "<OFX><BANKMSGSRSV1><STMTTRNRS><STMTRS><BANKTRANLIST>\n"
+                "<STMTTRN>\n"
+                "<TRNTYPE>DEBIT\n"
+                "<DTPOSTED>20240110120000[-3:BRT]\n"
+                "<TRNAMT>-25.00\n"
+                "<NAME>Pharmacy\n"
+                "</STMTTRN>\n"
+                "<STMTTRN>\n"
+                "<TRNTYPE>CREDIT\n"
+                "<DTPOSTED>20240111\n"
+                "<TRNAMT>75.00\n"
+                "<NAME>Transfer\n"
+                "<MEMO>Rent share\n"
+                "</STMTTRN>\n"
+                "<STMTTRN>\n"
+                "<DTPOSTED>20241311\n"
+                "<TRNAMT>1.00\n"
+                "</STMTTRN>\n"
+                "</BANKTRANLIST></STMTRS></STMTTRNRS></BANKMSGSRSV1></OFX>\n";
+    }
+
+    BulkImporter::Stats stats;
+
+    bool imported =
+        m_importer.ImportFile(path, "w1", BulkImporter::Format::Ofx, stats);
+
+    std::remove(path.c_str());
+
+    ASSERT_TRUE(imported);
+
+    EXPECT_EQ(3, stats.rows);
+    EXPECT_EQ(2, stats.imported);
+    EXPECT_EQ(1, stats.rejected);
+
+    EXPECT_DOUBLE_EQ(150, Balance());
+
+    EXPECT_EQ("Rent share",
+              m_dbManager
+                  .QueryOne<std::string>("SELECT description FROM WalletTransaction "
+                                         "WHERE date = '2024-01-11';")
+                  .value_or(""));
+}
+
+TEST_F(BulkImporterTest, AmountsAreSummedInCents)
+{
+    std::string csv = "2024-01-02,Tip,Job,0.005\n"
+                      "2024-01-02,Tip,Job,0.005\n"
+                      "2024-01-03,Tip,Job,0.005\n"
+                      "2024-01-03,Dust,Job,0.004\n";
+
+    BulkImporter::Stats stats;
+
+    ASSERT_TRUE(m_importer.ImportText(csv, "w1", BulkImporter::Format::Csv, stats));
+
+    // Each row is rounded to a cent, and the balance moves by what was stored
+    EXPECT_EQ(3, stats.imported);
+    EXPECT_EQ(1, stats.rejected);
+    EXPECT_EQ(3,
+              m_dbManager
+                  .QueryOne<int64_t>("SELECT SUM(amount) FROM WalletTransaction;")
+                  .value_or(-1));
+    EXPECT_EQ(Money(100.03),
+              m_dbManager.QueryOne<Money>(query::SELECT_WALLET_BALANCE, "w1"));
+
+    Money balance;
+
+    ASSERT_TRUE(m_walletManager.GetBalanceAsOf("w1", "2024-01-02", balance));
+    EXPECT_EQ(Money(100.02), balance);
+}
+
+TEST_F(BulkImporterTest, ImportIntoMissingWallet)
+{
+    BulkImporter::Stats stats;
+
+    EXPECT_FALSE(m_importer.ImportText("2024-01-02,Market,Food,-30.5\n",
+                                       "w2",
+                                       BulkImporter::Format::Csv,
+                                       stats));
+
+    EXPECT_EQ(0, CountTransactions("EXPENSE"));
+    EXPECT_FALSE(m_categoryManager.CategoryExists("Food"));
+}
+
+TEST_F(BulkImporterTest, ImportMissingFile)
+{
+    BulkImporter::Stats stats;
+
+    EXPECT_FALSE(m_importer.ImportFile(config::DATABASE_PATH + "missing.csv",
+                                       "w1",
+                                       BulkImporter::Format::Csv,
+                                       stats));
+
+    EXPECT_DOUBLE_EQ(100, Balance());
+}
+
+TEST_F(BulkImporterTest, ImportIntoLedgerWallet)
+{
+    AppendOnlyLedgerStore store(m_dbManager);
+    WalletManager         walletManager(store);
+
+    walletManager.CreateWallet("w2", Money(10));
+
+    std::string csv = "2024-01-02,Market,Food,-3.5\n"
+                      "2024-01-03,Salary,Job,20";
+
+    BulkImporter::Stats stats;
+
+    ASSERT_TRUE(m_importer.ImportText(csv, "w2", BulkImporter::Format::Csv, stats));
+
+    // The net change is one entry, and the row of the wallet is not updated
+    EXPECT_EQ(Money(26.5), store.GetWalletBalance("w2"));
+    EXPECT_DOUBLE_EQ(10,
+                     m_dbManager.QueryOne<Money>(query::SELECT_WALLET_BALANCE, "w2")
+                         .value_or(Money(-1))
+                         .ToDouble());
+
+    Money balance;
+
+    ASSERT_TRUE(walletManager.GetBalanceAsOf("w2", "2024-01-02", balance));
+    EXPECT_EQ(Money(6.5), balance);
+}
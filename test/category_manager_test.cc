@@ -14,17 +14,16 @@
 class CategoryManagerTest : public testing::Test
 {
     protected:
-        DBManager&       m_dbManager;
+        DBManager        m_dbManager;
         CategoryManager* m_categoryManager;
 
         CategoryManagerTest()
-            : m_dbManager(DBManager::GetInstance())
+            : m_dbManager(config::IN_MEMORY_DATABASE)
         { }
 
         void SetUp() override
         {
-            m_dbManager.ResetDatabase();
-            m_categoryManager = new CategoryManager();
+            m_categoryManager = new CategoryManager(m_dbManager);
         }
 
         void TearDown() override
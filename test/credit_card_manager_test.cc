@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <gtest/gtest.h>
 #include <stdatomic.h>
+#include <tuple>
 #include <vector>
 
 #include "config.h"
@@ -16,13 +17,11 @@ class CreditCardManagerTest : public testing::Test
 {
     protected:
         CreditCardManager* m_creditCardManager;
-        DBManager&         m_dbManager;
+        DBManager          m_dbManager;
 
         void SetUp() override
         {
-            m_dbManager.ResetDatabase();
-
-            m_creditCardManager = new CreditCardManager();
+            m_creditCardManager = new CreditCardManager(m_dbManager);
         }
 
         void TearDown() override
@@ -31,7 +30,7 @@ class CreditCardManagerTest : public testing::Test
         }
 
         CreditCardManagerTest()
-            : m_dbManager(DBManager::GetInstance())
+            : m_dbManager(config::IN_MEMORY_DATABASE)
         { }
 
         ~CreditCardManagerTest() { }
@@ -39,36 +38,36 @@ class CreditCardManagerTest : public testing::Test
 
 TEST_F(CreditCardManagerTest, AddCreditCardValid)
 {
-    CreditCardManager creditCardManager;
+    CreditCardManager creditCardManager(m_dbManager);
     bool              succAddCreditCard =
-        creditCardManager.AddCreditCard("1234567890123456", 1, "John Doe", 1000);
+        creditCardManager.AddCreditCard("1234567890123456", 1, "John Doe", Money(1000));
 
     EXPECT_TRUE(succAddCreditCard);
 }
 
 TEST_F(CreditCardManagerTest, AddCreditCardInvalidNumber)
 {
-    CreditCardManager creditCardManager;
+    CreditCardManager creditCardManager(m_dbManager);
     bool              succAddCreditCard =
-        creditCardManager.AddCreditCard("1234567890123456", 1, "John Doe", 1000);
+        creditCardManager.AddCreditCard("1234567890123456", 1, "John Doe", Money(1000));
 
     EXPECT_TRUE(succAddCreditCard);
 
     // Try to add the same credit card again
     bool succAddCreditCardAgain =
-        creditCardManager.AddCreditCard("1234567890123456", 1, "John", 1001);
+        creditCardManager.AddCreditCard("1234567890123456", 1, "John", Money(1001));
 
     EXPECT_FALSE(succAddCreditCardAgain);
 }
 
 TEST_F(CreditCardManagerTest, AddCreditCardInvalidDueDay)
 {
-    CreditCardManager creditCardManager;
+    CreditCardManager creditCardManager(m_dbManager);
     bool              succAddCreditCard =
         creditCardManager.AddCreditCard("1234567890123456",
                                         config::MIN_BILLING_DAY - 1,
                                         "John Doe",
-                                        1000);
+                                        Money(1000));
 
     EXPECT_FALSE(succAddCreditCard);
 
@@ -76,21 +75,21 @@ TEST_F(CreditCardManagerTest, AddCreditCardInvalidDueDay)
         creditCardManager.AddCreditCard("00031123213123",
                                         config::MAX_BILLING_DAY + 1,
                                         "John Does",
-                                        1001);
+                                        Money(1001));
 
     EXPECT_FALSE(succAddCreditCardAgain);
 }
 
 TEST_F(CreditCardManagerTest, AddCreditCardInvalidMaxDebt)
 {
-    CreditCardManager creditCardManager;
+    CreditCardManager creditCardManager(m_dbManager);
     bool              succAddCreditCard =
-        creditCardManager.AddCreditCard("1234567890123456", 10, "John Doe", 0);
+        creditCardManager.AddCreditCard("1234567890123456", 10, "John Doe", Money(0));
 
     EXPECT_FALSE(succAddCreditCard);
 
     bool succAddCreditCardAgain =
-        creditCardManager.AddCreditCard("00031123213123", 10, "John Does", -1);
+        creditCardManager.AddCreditCard("00031123213123", 10, "John Does", Money(-1));
 
     EXPECT_FALSE(succAddCreditCardAgain);
 }
@@ -99,14 +98,17 @@ TEST_F(CreditCardManagerTest, GetCreditCardInfo)
 {
     // Add a credit
     bool succAddCreditCard =
-        m_creditCardManager->AddCreditCard("1234567890123456", 1, "John Doe", 1000);
+        m_creditCardManager->AddCreditCard("1234567890123456",
+                                           1,
+                                           "John Doe",
+                                           Money(1000));
 
     ASSERT_TRUE(succAddCreditCard);
 
     // Check if the credit card info can be retrieved correctly
     std::string cardName;
-    double_t    maxDebt;
-    double_t    pendingDebt;
+    Money       maxDebt;
+    Money       pendingDebt;
     uint16_t    billingDueDay;
     bool        succGetCreditCardInfo =
         m_creditCardManager->GetCreditCardInfo("1234567890123456",
@@ -118,8 +120,8 @@ TEST_F(CreditCardManagerTest, GetCreditCardInfo)
     ASSERT_TRUE(succGetCreditCardInfo);
 
     EXPECT_EQ(cardName, "John Doe");
-    EXPECT_EQ(maxDebt, 1000);
-    EXPECT_EQ(pendingDebt, 0);
+    EXPECT_EQ(maxDebt, Money(1000));
+    EXPECT_EQ(pendingDebt, Money(0));
     EXPECT_EQ(billingDueDay, 1);
 }
 
@@ -127,8 +129,8 @@ TEST_F(CreditCardManagerTest, GetCreditCardInfoInvalid)
 {
     // Try to retrieve the info of a non-existent credit card
     std::string cardName;
-    double_t    maxDebt;
-    double_t    pendingDebt;
+    Money       maxDebt;
+    Money       pendingDebt;
     uint16_t    billingDueDay;
     bool        succGetCreditCardInfo =
         m_creditCardManager->GetCreditCardInfo("1234567890123456",
@@ -143,9 +145,9 @@ TEST_F(CreditCardManagerTest, GetCreditCardInfoInvalid)
 TEST_F(CreditCardManagerTest, GetCreditCards)
 {
     // Add some credit cards
-    m_creditCardManager->AddCreditCard("1111222233334444", 1, "Card 1", 500);
-    m_creditCardManager->AddCreditCard("2222333344445555", 15, "Card 2", 1000);
-    m_creditCardManager->AddCreditCard("3333444455556666", 5, "Card 3", 1500);
+    m_creditCardManager->AddCreditCard("1111222233334444", 1, "Card 1", Money(500));
+    m_creditCardManager->AddCreditCard("2222333344445555", 15, "Card 2", Money(1000));
+    m_creditCardManager->AddCreditCard("3333444455556666", 5, "Card 3", Money(1500));
 
     // Retrieve the credit cards
     std::vector<std::string> creditCards;
@@ -165,7 +167,10 @@ TEST_F(CreditCardManagerTest, AddDebt)
 {
     // Add a credit card first
     bool succAddCreditCard =
-        m_creditCardManager->AddCreditCard("1234567890123456", 1, "John Doe", 1000);
+        m_creditCardManager->AddCreditCard("1234567890123456",
+                                           1,
+                                           "John Doe",
+                                           Money(1000));
 
     ASSERT_TRUE(succAddCreditCard);
 
@@ -173,7 +178,7 @@ TEST_F(CreditCardManagerTest, AddDebt)
     bool succAddDebt = m_creditCardManager->AddDebt("1234567890123456",
                                                     "Groceries",
                                                     "2024-01-12",
-                                                    150,
+                                                    Money(150),
                                                     "Groceries shopping",
                                                     1);
 
@@ -181,7 +186,7 @@ TEST_F(CreditCardManagerTest, AddDebt)
 
     std::string category;
     std::string date;
-    double_t    amount;
+    Money       amount;
     std::string description;
     uint16_t    installments;
     uint32_t    debtId;
@@ -199,14 +204,14 @@ TEST_F(CreditCardManagerTest, AddDebt)
 
     EXPECT_EQ(category, "Groceries");
     EXPECT_EQ(date, "2024-01-12");
-    EXPECT_EQ(amount, 150);
+    EXPECT_EQ(amount, Money(150));
     EXPECT_EQ(description, "Groceries shopping");
     EXPECT_EQ(installments, 1);
 
     // Check if the debt was added to the credit card
     std::string cardName;
-    double_t    pendingDebt;
-    double_t    maxDebt;
+    Money       pendingDebt;
+    Money       maxDebt;
     uint16_t    billingDueDay;
 
     bool succGetCreditCardInfo =
@@ -218,7 +223,7 @@ TEST_F(CreditCardManagerTest, AddDebt)
 
     ASSERT_TRUE(succGetCreditCardInfo);
 
-    EXPECT_EQ(pendingDebt, 150);
+    EXPECT_EQ(pendingDebt, Money(150));
 }
 
 TEST_F(CreditCardManagerTest, AddDebtWithNoCreditCard)
@@ -227,7 +232,7 @@ TEST_F(CreditCardManagerTest, AddDebtWithNoCreditCard)
     bool succAddDebt = m_creditCardManager->AddDebt("1234567890123456",
                                                     "Groceries",
                                                     "2024-06-12",
-                                                    150,
+                                                    Money(150),
                                                     "Groceries shopping",
                                                     1);
 
@@ -238,7 +243,10 @@ TEST_F(CreditCardManagerTest, AddDebtInvalidAmount)
 {
     // Add a credit card first
     bool succAddCreditCard =
-        m_creditCardManager->AddCreditCard("1234567890123456", 1, "John Doe", 1000);
+        m_creditCardManager->AddCreditCard("1234567890123456",
+                                           1,
+                                           "John Doe",
+                                           Money(1000));
 
     ASSERT_TRUE(succAddCreditCard);
 
@@ -246,7 +254,7 @@ TEST_F(CreditCardManagerTest, AddDebtInvalidAmount)
     bool succAddDebt = m_creditCardManager->AddDebt("1234567890123456",
                                                     "Groceries",
                                                     "2024-06-12",
-                                                    0,
+                                                    Money(0),
                                                     "Groceries shopping",
                                                     1);
 
@@ -255,7 +263,7 @@ TEST_F(CreditCardManagerTest, AddDebtInvalidAmount)
     bool succAddDebtAgain = m_creditCardManager->AddDebt("1234567890123456",
                                                          "Groceries",
                                                          "2024-06-12",
-                                                         -1,
+                                                         Money(-1),
                                                          "Groceries shopping",
                                                          1);
 
@@ -266,7 +274,10 @@ TEST_F(CreditCardManagerTest, AddDebtWithInstallments)
 {
     // Add a credit card first
     bool succAddCreditCard =
-        m_creditCardManager->AddCreditCard("1234567890123456", 1, "John Doe", 1000);
+        m_creditCardManager->AddCreditCard("1234567890123456",
+                                           1,
+                                           "John Doe",
+                                           Money(1000));
 
     ASSERT_TRUE(succAddCreditCard);
 
@@ -274,20 +285,41 @@ TEST_F(CreditCardManagerTest, AddDebtWithInstallments)
     bool succAddDebt = m_creditCardManager->AddDebt("1234567890123456",
                                                     "Groceries",
                                                     "2024-06-12",
-                                                    150,
+                                                    Money(150),
                                                     "Groceries shopping",
                                                     7);
 
     ASSERT_TRUE(succAddDebt);
 
-    // TODO: Criar função para verificar se a dívida foi adicionada corretamente
+    std::string category;
+    std::string date;
+    Money       amount;
+    std::string description;
+    uint16_t    installments;
+    uint32_t    debtId;
+
+    bool succGetDebt = m_creditCardManager->GetLastExpense("1234567890123456",
+                                                           category,
+                                                           date,
+                                                           amount,
+                                                           description,
+                                                           installments,
+                                                           debtId);
+
+    ASSERT_TRUE(succGetDebt);
+
+    EXPECT_EQ(amount, Money(150));
+    EXPECT_EQ(installments, 7);
 }
 
 TEST_F(CreditCardManagerTest, AddDebtWithInstallmentsInvalidInstallments)
 {
     // Add a credit card first
     bool succAddCreditCard =
-        m_creditCardManager->AddCreditCard("1234567890123456", 1, "John Doe", 1000);
+        m_creditCardManager->AddCreditCard("1234567890123456",
+                                           1,
+                                           "John Doe",
+                                           Money(1000));
 
     ASSERT_TRUE(succAddCreditCard);
 
@@ -295,7 +327,7 @@ TEST_F(CreditCardManagerTest, AddDebtWithInstallmentsInvalidInstallments)
     bool succAddDebt = m_creditCardManager->AddDebt("1234567890123456",
                                                     "Groceries",
                                                     "2024-06-12",
-                                                    150,
+                                                    Money(150),
                                                     "Groceries shopping",
                                                     0);
 
@@ -306,7 +338,10 @@ TEST_F(CreditCardManagerTest, AddDebtWithInstallmentsInvalidAmount)
 {
     // Add a credit card first
     bool succAddCreditCard =
-        m_creditCardManager->AddCreditCard("1234567890123456", 1, "John Doe", 1000);
+        m_creditCardManager->AddCreditCard("1234567890123456",
+                                           1,
+                                           "John Doe",
+                                           Money(1000));
 
     ASSERT_TRUE(succAddCreditCard);
 
@@ -314,7 +349,7 @@ TEST_F(CreditCardManagerTest, AddDebtWithInstallmentsInvalidAmount)
     bool succAddDebt = m_creditCardManager->AddDebt("1234567890123456",
                                                     "Groceries",
                                                     "2024-06-12",
-                                                    0,
+                                                    Money(0),
                                                     "Groceries shopping",
                                                     7);
 
@@ -323,9 +358,48 @@ TEST_F(CreditCardManagerTest, AddDebtWithInstallmentsInvalidAmount)
     bool succAddDebtAgain = m_creditCardManager->AddDebt("1234567890123456",
                                                          "Groceries",
                                                          "2024-06-12",
-                                                         -1,
+                                                         Money(-1),
                                                          "Groceries shopping",
                                                          7);
 
     EXPECT_FALSE(succAddDebtAgain);
 }
+
+TEST_F(CreditCardManagerTest, AddDebtInstallmentsAddUpToTotal)
+{
+    bool succAddCreditCard =
+        m_creditCardManager->AddCreditCard("1234567890123456",
+                                           1,
+                                           "John Doe",
+                                           Money(100));
+
+    ASSERT_TRUE(succAddCreditCard);
+
+    // 100 does not split evenly in 3 installments, the first gets the extra cent
+    bool succAddDebt = m_creditCardManager->AddDebt("1234567890123456",
+                                                    "Groceries",
+                                                    "2024-06-12",
+                                                    Money(100),
+                                                    "Groceries shopping",
+                                                    3);
+
+    ASSERT_TRUE(succAddDebt);
+
+    std::vector<double_t> amounts;
+
+    for (const auto& [amount] : m_dbManager.QueryAs<std::tuple<Money>>(
+             "SELECT amount FROM CreditCardPayment ORDER BY installment;"))
+    {
+        amounts.push_back(amount.ToDouble());
+    }
+
+    EXPECT_EQ(std::vector<double_t>({ 33.34, 33.33, 33.33 }), amounts);
+
+    // The whole limit is taken, to the cent
+    EXPECT_FALSE(m_creditCardManager->AddDebt("1234567890123456",
+                                              "Groceries",
+                                              "2024-06-13",
+                                              Money(0.01),
+                                              "Gum",
+                                              1));
+}
@@ -0,0 +1,656 @@
+/*
+ * Filename: db_manager_test.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <gtest/gtest.h>
+#include <optional>
+#include <ranges>
+#include <sqlite3.h>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <unistd.h>
+#include <vector>
+
+#include "db_manager.h"
+#include "money.h"
+#include "sql_queries.h"
+
+/**
+ * @brief Database file of a single test, removed before and after it runs.
+ *        Readers need WAL, which in-memory databases do not support
+ **/
+struct TemporaryDatabase
+{
+        std::string path;
+
+        explicit TemporaryDatabase(const std::string& name)
+            : path(config::DATABASE_PATH + name + "_" + std::to_string(getpid()) +
+                   ".db")
+        {
+            Remove();
+        }
+
+        ~TemporaryDatabase()
+        {
+            Remove();
+        }
+
+        void Remove() const
+        {
+            std::error_code error;
+
+            for (const char* suffix : { "", "-wal", "-shm" })
+            {
+                std::filesystem::remove(path + suffix, error);
+            }
+        }
+};
+
+class DBManagerTest : public testing::Test
+{
+    protected:
+        TemporaryDatabase m_database;
+        DBManager         m_dbManager;
+
+        DBManagerTest()
+            : m_database("db_manager_test"),
+              m_dbManager(m_database.path)
+        { }
+};
+
+TEST_F(DBManagerTest, ExecuteBindsParameters)
+{
+    ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "it's mine", 10.5));
+    ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, std::string("w2"), 3));
+
+    double_t balance = 0;
+    bool     found   = m_dbManager.Query(query::SELECT_WALLET_BALANCE,
+                                       std::string_view("it's mine"),
+                                       [&balance](sqlite3_stmt* stmt) {
+                                           balance = sqlite3_column_double(stmt, 0);
+                                       });
+
+    ASSERT_TRUE(found);
+    EXPECT_EQ(10.5, balance);
+}
+
+TEST_F(DBManagerTest, QueryWithoutRows)
+{
+    bool called = false;
+    bool found  = m_dbManager.Query(query::SELECT_WALLET_BALANCE,
+                                   "none",
+                                   [&called](sqlite3_stmt*) { called = true; });
+
+    EXPECT_FALSE(found);
+    EXPECT_FALSE(called);
+}
+
+TEST_F(DBManagerTest, QueryAllSucceedsWithoutRows)
+{
+    bool called = false;
+    auto rowFn  = [&called](sqlite3_stmt*) { called = true; };
+
+    EXPECT_TRUE(m_dbManager.QueryAll(query::SELECT_WALLET_BALANCE, "none", rowFn));
+    EXPECT_FALSE(called);
+
+    // Errors still fail
+    EXPECT_FALSE(m_dbManager.QueryAll("SELECT * FROM None;", rowFn));
+}
+
+TEST_F(DBManagerTest, BindNullParameters)
+{
+    ASSERT_TRUE(m_dbManager.Execute(query::INSERT_CREDIT_CARD_PAYMENT,
+                                    1,
+                                    std::nullopt,
+                                    std::optional<double_t>(20.0),
+                                    1));
+
+    int64_t nullDates = 0;
+    m_dbManager.Query("SELECT COUNT(*) FROM CreditCardPayment WHERE date IS ?",
+                      nullptr,
+                      [&nullDates](sqlite3_stmt* stmt) {
+                          nullDates = sqlite3_column_int64(stmt, 0);
+                      });
+
+    EXPECT_EQ(1, nullDates);
+}
+
+TEST_F(DBManagerTest, WrongNumberOfParameters)
+{
+    EXPECT_FALSE(m_dbManager.Execute(query::INSERT_WALLET, "w1"));
+    EXPECT_FALSE(m_dbManager.Execute(query::DELETE_WALLET, "w1", 1, 2));
+}
+
+TEST_F(DBManagerTest, ParameterizedStatementsAreReused)
+{
+    m_dbManager.Execute(query::INSERT_WALLET, "w1", 1);
+
+    StatementCache::Stats before = m_dbManager.GetStatementCacheStats();
+
+    m_dbManager.Execute(query::INSERT_WALLET, "w2", 2);
+    m_dbManager.Execute(query::INSERT_WALLET, "w3", 3);
+
+    StatementCache::Stats after = m_dbManager.GetStatementCacheStats();
+
+    EXPECT_EQ(before.misses, after.misses);
+    EXPECT_EQ(before.hits + 2, after.hits);
+}
+
+TEST_F(DBManagerTest, TransactionRollbackOnScopeExit)
+{
+    {
+        DBManager::Transaction transaction(m_dbManager);
+        ASSERT_TRUE(transaction.IsActive());
+        ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "w1", 1));
+    }
+
+    EXPECT_FALSE(m_dbManager.Query(query::SELECT_WALLET_BALANCE,
+                                   "w1",
+                                   [](sqlite3_stmt*) { }));
+}
+
+TEST_F(DBManagerTest, NestedTransactionRollback)
+{
+    {
+        DBManager::Transaction outer(m_dbManager);
+        ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "w1", 1));
+
+        {
+            DBManager::Transaction inner(m_dbManager);
+            ASSERT_TRUE(inner.IsActive());
+            ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "w2", 2));
+            inner.Rollback();
+        }
+
+        {
+            DBManager::Transaction inner(m_dbManager);
+            ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "w3", 3));
+            ASSERT_TRUE(inner.Commit());
+        }
+
+        ASSERT_TRUE(outer.Commit());
+    }
+
+    std::vector<std::string> wallets;
+    m_dbManager.Query(query::SELECT_WALLET_NAMES, [&wallets](sqlite3_stmt* stmt) {
+        wallets.push_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+    });
+
+    ASSERT_EQ(2, wallets.size());
+    EXPECT_EQ("w1", wallets[0]);
+    EXPECT_EQ("w3", wallets[1]);
+}
+
+TEST_F(DBManagerTest, AfterCommitWaitsForOutermostCommit)
+{
+    std::vector<std::string> ran;
+
+    {
+        DBManager::Transaction outer(m_dbManager);
+        m_dbManager.AfterCommit([&ran]() { ran.push_back("outer"); });
+
+        {
+            DBManager::Transaction inner(m_dbManager);
+            m_dbManager.AfterCommit([&ran]() { ran.push_back("rolled back"); });
+        }
+
+        {
+            DBManager::Transaction inner(m_dbManager);
+            m_dbManager.AfterCommit([&ran]() { ran.push_back("released"); });
+            ASSERT_TRUE(inner.Commit());
+        }
+
+        // Releasing a savepoint commits nothing yet
+        EXPECT_TRUE(ran.empty());
+        ASSERT_TRUE(outer.Commit());
+    }
+
+    EXPECT_EQ(std::vector<std::string>({ "outer", "released" }), ran);
+
+    {
+        DBManager::Transaction outer(m_dbManager);
+        m_dbManager.AfterCommit([&ran]() { ran.push_back("dropped"); });
+    }
+
+    m_dbManager.AfterCommit([&ran]() { ran.push_back("now"); });
+
+    EXPECT_EQ(std::vector<std::string>({ "outer", "released", "now" }), ran);
+}
+
+TEST_F(DBManagerTest, SwitchStorageProfile)
+{
+    auto synchronous = [this]() {
+        int64_t level = -1;
+        m_dbManager.ExecuteQueryWithResult("PRAGMA synchronous;",
+                                           [&level](sqlite3_stmt* stmt) {
+                                               level = sqlite3_column_int64(stmt, 0);
+                                           });
+        return level;
+    };
+
+    const config::StorageProfile& previous = m_dbManager.GetStorageProfile();
+
+    ASSERT_TRUE(m_dbManager.SetStorageProfile("bulk-load"));
+    EXPECT_STREQ("bulk-load", m_dbManager.GetStorageProfile().name);
+    EXPECT_EQ(0, synchronous()); // OFF
+
+    ASSERT_TRUE(m_dbManager.SetStorageProfile("durable"));
+    EXPECT_EQ(2, synchronous()); // FULL
+
+    EXPECT_FALSE(m_dbManager.SetStorageProfile("unknown"));
+    EXPECT_STREQ("durable", m_dbManager.GetStorageProfile().name);
+
+    ASSERT_TRUE(m_dbManager.SetStorageProfile(previous.name));
+}
+
+TEST_F(DBManagerTest, StorageProfileInsideTransaction)
+{
+    DBManager::Transaction transaction(m_dbManager);
+
+    EXPECT_FALSE(m_dbManager.SetStorageProfile("durable"));
+}
+
+TEST_F(DBManagerTest, ReadersSeeCommittedSnapshot)
+{
+    ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "w1", 1.0));
+
+    auto readBalance = [this]() {
+        double_t balance = -1;
+        m_dbManager.Query(query::SELECT_WALLET_BALANCE,
+                          "w1",
+                          [&balance](sqlite3_stmt* stmt) {
+                              balance = sqlite3_column_double(stmt, 0);
+                          });
+        return balance;
+    };
+
+    // Runs the read on another thread, which does not own the transaction
+    auto readBalanceConcurrently = [&readBalance]() {
+        double_t    balance = -1;
+        std::thread reader([&]() { balance = readBalance(); });
+        reader.join();
+        return balance;
+    };
+
+    DBManager::Transaction transaction(m_dbManager);
+    ASSERT_TRUE(transaction.IsActive());
+    ASSERT_TRUE(m_dbManager.Execute(query::UPDATE_WALLET_BALANCE, 2.0, "w1"));
+
+    // The owner of the transaction reads its own changes, while other threads read
+    // the last committed snapshot without waiting for the writer
+    EXPECT_EQ(2.0, readBalance());
+    EXPECT_EQ(1.0, readBalanceConcurrently());
+
+    ASSERT_TRUE(transaction.Commit());
+
+    EXPECT_EQ(2.0, readBalanceConcurrently());
+}
+
+TEST_F(DBManagerTest, ConcurrentQueries)
+{
+    for (int i = 0; i < 10; i++)
+    {
+        ASSERT_TRUE(
+            m_dbManager.Execute(query::INSERT_WALLET, "w" + std::to_string(i), i));
+    }
+
+    constexpr int threadCount = 8;
+    constexpr int iterations  = 200;
+
+    std::vector<std::thread> threads;
+    std::vector<int>         succeeded(threadCount, 0);
+
+    for (int t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([this, t, &succeeded]() {
+            for (int i = 0; i < iterations; i++)
+            {
+                std::size_t wallets = 0;
+                m_dbManager.Query(query::SELECT_WALLET_NAMES,
+                                  [&wallets](sqlite3_stmt*) { wallets++; });
+
+                if (wallets == 10)
+                {
+                    succeeded[t]++;
+                }
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int t = 0; t < threadCount; t++)
+    {
+        EXPECT_EQ(iterations, succeeded[t]);
+    }
+}
+
+TEST_F(DBManagerTest, QueryAsTuplesAndScalars)
+{
+    ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "w1", 1.5));
+    ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "w2", 2.5));
+
+    auto rows = m_dbManager.QueryAs<std::tuple<std::string, double_t>>(
+        query::SELECT_WALLET_NAMES_AND_BALANCES);
+
+    ASSERT_EQ(2, rows.size());
+    EXPECT_EQ("w1", std::get<0>(rows[0]));
+    EXPECT_EQ(2.5, std::get<1>(rows[1]));
+
+    std::vector<std::string> names =
+        m_dbManager.QueryAs<std::string>(query::SELECT_WALLET_NAMES);
+
+    ASSERT_EQ(2, names.size());
+    EXPECT_EQ("w2", names[1]);
+
+    EXPECT_EQ(2, m_dbManager.QueryOne<int64_t>("SELECT COUNT(*) FROM Wallet"));
+    EXPECT_FALSE(m_dbManager.QueryOne<double_t>(query::SELECT_WALLET_BALANCE, "none"));
+}
+
+struct WalletRow
+{
+        std::string name;
+        double_t    balance;
+
+        using Columns = std::tuple<std::string, double_t>;
+};
+
+TEST_F(DBManagerTest, QueryAsStruct)
+{
+    ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "w1", 7));
+
+    std::optional<WalletRow> row =
+        m_dbManager.QueryOne<WalletRow>(query::SELECT_WALLET_NAMES_AND_BALANCES);
+
+    ASSERT_TRUE(row);
+    EXPECT_EQ("w1", row->name);
+    EXPECT_EQ(7, row->balance);
+}
+
+TEST_F(DBManagerTest, QueryNullableColumns)
+{
+    ASSERT_TRUE(m_dbManager.Execute(query::INSERT_CREDIT_CARD_PAYMENT,
+                                    1,
+                                    std::nullopt,
+                                    20.0,
+                                    1));
+
+    auto row =
+        m_dbManager.QueryOne<std::tuple<std::optional<std::string>, double_t>>(
+            "SELECT date, amount FROM CreditCardPayment");
+
+    ASSERT_TRUE(row);
+    EXPECT_FALSE(std::get<0>(*row));
+    EXPECT_EQ(20.0, std::get<1>(*row));
+}
+
+TEST_F(DBManagerTest, ForEachBorrowsText)
+{
+    ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "w1", 1));
+    ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "w2", 2));
+
+    std::vector<std::string> names;
+    double_t                 total = 0;
+
+    bool found = m_dbManager.ForEach<std::tuple<std::string_view, double_t>>(
+        "SELECT name, balance FROM Wallet WHERE balance > ? ORDER BY name",
+        0,
+        [&names, &total](std::tuple<std::string_view, double_t> row) {
+            names.emplace_back(std::get<0>(row));
+            total += std::get<1>(row);
+        });
+
+    ASSERT_TRUE(found);
+    ASSERT_EQ(2, names.size());
+    EXPECT_EQ("w1", names[0]);
+    EXPECT_EQ(3, total);
+}
+
+TEST_F(DBManagerTest, StreamRowsLazily)
+{
+    static_assert(std::ranges::input_range<DBManager::Cursor<WalletRow>>);
+
+    for (int i = 0; i < 5; i++)
+    {
+        ASSERT_TRUE(
+            m_dbManager.Execute(query::INSERT_WALLET, "w" + std::to_string(i), i));
+    }
+
+    std::vector<std::string> names;
+
+    for (WalletRow row : m_dbManager.Stream<WalletRow>(
+             "SELECT name, balance FROM Wallet WHERE name <> ? ORDER BY name",
+             std::string("w0")))
+    {
+        names.push_back(row.name);
+
+        // Stop before reading the whole result
+        if (row.balance == 2)
+        {
+            break;
+        }
+    }
+
+    ASSERT_EQ(2, names.size());
+    EXPECT_EQ("w1", names[0]);
+    EXPECT_EQ("w2", names[1]);
+
+    using NameAndBalance = std::tuple<std::string_view, int64_t>;
+
+    int64_t total = 0;
+
+    for (auto [name, balance] :
+         m_dbManager.Stream<NameAndBalance>(query::SELECT_WALLET_NAMES_AND_BALANCES))
+    {
+        EXPECT_FALSE(name.empty());
+        total += balance;
+    }
+
+    EXPECT_EQ(10, total);
+}
+
+TEST_F(DBManagerTest, StreamInvalidQuery)
+{
+    DBManager::Cursor<int64_t> cursor =
+        m_dbManager.Stream<int64_t>("SELECT * FROM None");
+
+    EXPECT_TRUE(cursor.HasFailed());
+    EXPECT_EQ(cursor.begin(), cursor.end());
+}
+
+TEST_F(DBManagerTest, SchemaIsMigrated)
+{
+    EXPECT_EQ(std::size(query::MIGRATIONS), m_dbManager.GetSchemaVersion());
+
+    // Applying the migrations again changes nothing
+    EXPECT_TRUE(m_dbManager.Migrate(query::MIGRATIONS));
+    EXPECT_EQ(std::size(query::MIGRATIONS), m_dbManager.GetSchemaVersion());
+}
+
+TEST_F(DBManagerTest, SchemaFingerprintSkipsDdl)
+{
+    EXPECT_FALSE(m_dbManager.GetStartupReport().schemaUpToDate);
+
+    DBManager reopened(m_database.path);
+
+    EXPECT_TRUE(reopened.GetStartupReport().schemaUpToDate);
+    EXPECT_LE(reopened.GetStartupReport().schema, reopened.GetStartupReport().Total());
+}
+
+TEST_F(DBManagerTest, StaleSchemaFingerprintAppliesDdl)
+{
+    ASSERT_TRUE(m_dbManager.Execute("UPDATE SchemaInfo SET fingerprint = 0;"));
+    ASSERT_TRUE(m_dbManager.Execute("DROP TABLE Transfer;"));
+
+    DBManager reopened(m_database.path);
+
+    EXPECT_FALSE(reopened.GetStartupReport().schemaUpToDate);
+    EXPECT_TRUE(reopened.Execute(query::INSERT_TRANSFER, "a", "b", "2024-01-01", 1.0));
+    EXPECT_EQ(static_cast<int64_t>(DBManager::GetSchemaFingerprint()),
+              reopened.QueryOne<int64_t>(query::SELECT_SCHEMA_FINGERPRINT));
+}
+
+TEST_F(DBManagerTest, FailedMigrationIsRolledBack)
+{
+    uint32_t version = m_dbManager.GetSchemaVersion();
+
+    const query::Migration migrations[] = {
+        { version + 1,
+          "Partially valid",
+          "CREATE TABLE MigrationTest (id INTEGER);"
+          "INSERT INTO MissingTable VALUES (1);" }
+    };
+
+    EXPECT_FALSE(m_dbManager.Migrate(migrations));
+    EXPECT_EQ(version, m_dbManager.GetSchemaVersion());
+    EXPECT_EQ(0,
+              m_dbManager
+                  .QueryOne<int64_t>("SELECT COUNT(*) FROM sqlite_master "
+                                     "WHERE name = 'MigrationTest';")
+                  .value_or(-1));
+}
+
+TEST_F(DBManagerTest, PendingDebtUsesPartialIndex)
+{
+    // EXPLAIN does not read the database, so a reader that loaded the schema
+    // before the migration would not see the indexes. Run it on the writer
+    DBManager::Transaction transaction(m_dbManager);
+
+    std::string plan;
+
+    m_dbManager.ForEach<std::tuple<int64_t, int64_t, int64_t, std::string_view>>(
+        "EXPLAIN QUERY PLAN " + query::SELECT_CREDIT_CARD_PENDING_DEBT,
+        "1234",
+        [&plan](auto row) { plan += std::string(std::get<3>(row)) + "\n"; });
+
+    EXPECT_NE(std::string::npos, plan.find("idx_credit_card_payment_pending")) << plan;
+    EXPECT_NE(std::string::npos, plan.find("idx_credit_card_debt_crc_number")) << plan;
+}
+
+TEST_F(DBManagerTest, BackupWhileWriting)
+{
+    TemporaryDatabase backup("db_manager_backup");
+
+    for (int i = 0; i < 200; i++)
+    {
+        ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET,
+                                        "wallet " + std::string(500, 'x') +
+                                            std::to_string(i),
+                                        i));
+    }
+
+    int steps     = 0;
+    int remaining = -1;
+
+    std::future<bool> done =
+        m_dbManager.Backup(backup.path, 1, [&steps, &remaining](int left, int) {
+            steps++;
+            remaining = left;
+        });
+
+    // Writes go on while the backup runs, and end up in the copy
+    ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "late", 1.0));
+
+    ASSERT_TRUE(done.get());
+    EXPECT_LT(1, steps);
+    EXPECT_EQ(0, remaining);
+
+    DBManager copy(backup.path);
+    EXPECT_EQ(201, copy.QueryOne<int64_t>("SELECT COUNT(*) FROM Wallet;").value_or(0));
+}
+
+TEST_F(DBManagerTest, RestoreFromBackup)
+{
+    TemporaryDatabase backup("db_manager_backup");
+
+    ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "kept", 10.0));
+    ASSERT_TRUE(m_dbManager.Backup(backup.path).get());
+
+    ASSERT_TRUE(m_dbManager.Execute(query::DELETE_WALLET, "kept"));
+    ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "dropped", 1.0));
+
+    ASSERT_TRUE(m_dbManager.Restore(backup.path));
+
+    EXPECT_EQ(std::vector<std::string>{ "kept" },
+              m_dbManager.QueryAs<std::string>(query::SELECT_WALLET_NAMES));
+    EXPECT_EQ(std::size(query::MIGRATIONS), m_dbManager.GetSchemaVersion());
+}
+
+TEST_F(DBManagerTest, RestoreOlderSchema)
+{
+    TemporaryDatabase backup("db_manager_backup");
+
+    ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "kept", Money(10.25)));
+    ASSERT_TRUE(m_dbManager.Backup(backup.path).get());
+
+    // Take the copy back to the first schema version, before the tables and
+    // columns the later migrations added and with the balances in units
+    sqlite3* copy = nullptr;
+    ASSERT_EQ(SQLITE_OK, sqlite3_open(backup.path.c_str(), &copy));
+    EXPECT_EQ(SQLITE_OK,
+              sqlite3_exec(copy,
+                           "DROP TABLE WalletDailyBalance;"
+                           "DROP TABLE SpendingSummary;"
+                           "DROP TABLE WalletLedgerEntry;"
+                           "DROP TABLE WalletBalanceCheckpoint;"
+                           "DROP TABLE SchemaInfo;"
+                           "ALTER TABLE Wallet DROP COLUMN opening_balance;"
+                           "UPDATE Wallet SET balance = balance / 100.0;"
+                           "PRAGMA user_version = 1;",
+                           nullptr,
+                           nullptr,
+                           nullptr));
+    sqlite3_close(copy);
+
+    // Warm the statement caches with the current schema
+    ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "dropped", 1.0));
+
+    uint64_t restores = m_dbManager.GetRestoreCount();
+
+    ASSERT_TRUE(m_dbManager.Restore(backup.path));
+
+    EXPECT_EQ(restores + 1, m_dbManager.GetRestoreCount());
+    EXPECT_EQ(query::MIGRATIONS[std::size(query::MIGRATIONS) - 1].version,
+              m_dbManager.GetSchemaVersion());
+    EXPECT_EQ(static_cast<int64_t>(DBManager::GetSchemaFingerprint()),
+              m_dbManager.QueryOne<int64_t>(query::SELECT_SCHEMA_FINGERPRINT));
+    EXPECT_EQ(1025,
+              m_dbManager.QueryOne<int64_t>(
+                  "SELECT opening_balance FROM Wallet WHERE name = 'kept';"));
+    EXPECT_EQ("integer",
+              m_dbManager.QueryOne<std::string>(
+                  "SELECT typeof(balance) FROM Wallet WHERE name = 'kept';"));
+
+    // The tables the copy lacked were created
+    EXPECT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "added", 5.0));
+    EXPECT_TRUE(m_dbManager.Execute(query::INSERT_WALLET_LEDGER_START, "added"));
+    EXPECT_EQ(1,
+              m_dbManager.QueryOne<int64_t>(query::COUNT_WALLET_BALANCE_CHECKPOINTS,
+                                            "added"));
+}
+
+TEST_F(DBManagerTest, RestoreInsideTransaction)
+{
+    TemporaryDatabase backup("db_manager_backup");
+
+    ASSERT_TRUE(m_dbManager.Backup(backup.path).get());
+
+    DBManager::Transaction transaction(m_dbManager);
+    EXPECT_FALSE(m_dbManager.Restore(backup.path));
+}
+
+TEST_F(DBManagerTest, RestoreMissingBackup)
+{
+    EXPECT_FALSE(m_dbManager.Restore(config::DATABASE_PATH + "missing_backup.db"));
+}
@@ -0,0 +1,269 @@
+/*
+ * Filename: exporter_test.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+
+#include "config.h"
+#include "credit_card_manager.h"
+#include "db_manager.h"
+#include "exporter.h"
+#include "wallet_manager.h"
+
+/**
+ * @brief Sequential reader of a columnar export
+ **/
+struct ColumnarReader
+{
+        std::string data;
+        std::size_t position = 0;
+
+        template<typename T>
+        T Read()
+        {
+            T value;
+            std::memcpy(&value, data.data() + position, sizeof(T));
+            position += sizeof(T);
+            return value;
+        }
+
+        std::string ReadText(std::size_t size)
+        {
+            std::string text = data.substr(position, size);
+            position += size;
+            return text;
+        }
+};
+
+class ExporterTest : public testing::Test
+{
+    protected:
+        DBManager         m_dbManager;
+        WalletManager     m_walletManager;
+        CreditCardManager m_creditCardManager;
+        Exporter          m_exporter;
+        std::string       m_path;
+
+        std::string ReadFile()
+        {
+            std::ifstream file(m_path, std::ios::binary);
+
+            return std::string(std::istreambuf_iterator<char>(file),
+                               std::istreambuf_iterator<char>());
+        }
+
+    public:
+        ExporterTest()
+            : m_dbManager(config::IN_MEMORY_DATABASE),
+              m_walletManager(m_dbManager),
+              m_creditCardManager(m_dbManager),
+              m_exporter(m_dbManager),
+              m_path(config::DATABASE_PATH + "exporter_test_" +
+                     std::to_string(getpid()))
+        {
+            m_walletManager.CreateWallet("w1", Money(2000));
+            m_walletManager.CreateWallet("w2", Money(0));
+
+            m_walletManager.Expense("w1",
+                                    "Food",
+                                    "2024-01-02",
+                                    "Market, \"big\"",
+                                    Money(30));
+            m_walletManager.Income("w1", "Job", "2024-01-03", "Salary", Money(1000.5));
+            m_walletManager.Expense("w1", "Food", "2024-01-04", "Bakery", Money(4.25));
+
+            m_walletManager.Transfer("w1", "w2", "2024-01-05", Money(100));
+
+            m_creditCardManager.AddCreditCard("1234", 10, "card", Money(5000));
+            m_creditCardManager.AddDebt("1234",
+                                        "Travel",
+                                        "2024-01-06",
+                                        Money(300),
+                                        "Trip",
+                                        2);
+        }
+
+        ~ExporterTest()
+        {
+            std::remove(m_path.c_str());
+        }
+};
+
+TEST_F(ExporterTest, ExportCsv)
+{
+    Exporter::Stats stats;
+
+    ASSERT_TRUE(m_exporter.Export(Exporter::Table::WalletTransaction,
+                                  Exporter::Format::Csv,
+                                  m_path,
+                                  stats));
+
+    std::string expected =
+        "wallet_transaction_id,wallet,category,type,date,amount,description\n"
+        "1,w1,Food,EXPENSE,2024-01-02,30,\"Market, \"\"big\"\"\"\n"
+        "2,w1,Job,INCOME,2024-01-03,1000.5,Salary\n"
+        "3,w1,Food,EXPENSE,2024-01-04,4.25,Bakery\n";
+
+    EXPECT_EQ(expected, ReadFile());
+    EXPECT_EQ(3, stats.rows);
+    EXPECT_EQ(expected.size(), stats.bytes);
+}
+
+TEST_F(ExporterTest, ExportNdjson)
+{
+    Exporter::Stats stats;
+
+    ASSERT_TRUE(m_exporter.Export(Exporter::Table::CreditCardPayment,
+                                  Exporter::Format::Ndjson,
+                                  m_path,
+                                  stats));
+
+    std::string payments = ReadFile();
+
+    EXPECT_EQ(2, stats.rows);
+    EXPECT_EQ("{\"payment_id\":1,\"wallet\":null,\"debt_id\":1,\"date\":\"2024-02-10\","
+              "\"amount\":150,\"installment\":1}\n",
+              payments.substr(0, payments.find('\n') + 1));
+
+    ASSERT_TRUE(m_exporter.Export(Exporter::Table::Transfer,
+                                  Exporter::Format::Ndjson,
+                                  m_path,
+                                  stats));
+
+    EXPECT_EQ("{\"transfer_id\":1,\"sender_wallet\":\"w1\",\"receiver_wallet\":\"w2\","
+              "\"date\":\"2024-01-05\",\"amount\":100,\"description\":null}\n",
+              ReadFile());
+}
+
+TEST_F(ExporterTest, ExportColumnar)
+{
+    Exporter::Stats stats;
+
+    ASSERT_TRUE(m_exporter.Export(Exporter::Table::WalletTransaction,
+                                  Exporter::Format::Columnar,
+                                  m_path,
+                                  stats));
+
+    ColumnarReader reader{ ReadFile() };
+
+    EXPECT_EQ(stats.bytes, reader.data.size());
+    EXPECT_EQ(std::string("MFNCOL1", 8), reader.ReadText(8));
+
+    auto columns = Exporter::GetColumns(Exporter::Table::WalletTransaction);
+
+    ASSERT_EQ(columns.size(), reader.Read<uint32_t>());
+
+    for (const Exporter::Column& column : columns)
+    {
+        EXPECT_EQ(static_cast<uint8_t>(column.type), reader.Read<uint8_t>());
+        EXPECT_EQ(column.name, reader.ReadText(reader.Read<uint16_t>()));
+    }
+
+    ASSERT_EQ(3, reader.Read<uint32_t>());
+
+    // wallet_transaction_id
+    EXPECT_EQ(0, reader.Read<uint8_t>());
+    EXPECT_EQ(1, reader.Read<int64_t>());
+    EXPECT_EQ(2, reader.Read<int64_t>());
+    EXPECT_EQ(3, reader.Read<int64_t>());
+
+    // wallet
+    EXPECT_EQ(0, reader.Read<uint8_t>());
+    ASSERT_EQ(1, reader.Read<uint32_t>());
+    EXPECT_EQ("w1", reader.ReadText(reader.Read<uint32_t>()));
+    EXPECT_EQ(0, reader.Read<uint32_t>());
+    EXPECT_EQ(0, reader.Read<uint32_t>());
+    EXPECT_EQ(0, reader.Read<uint32_t>());
+
+    // category
+    EXPECT_EQ(0, reader.Read<uint8_t>());
+    ASSERT_EQ(2, reader.Read<uint32_t>());
+    EXPECT_EQ("Food", reader.ReadText(reader.Read<uint32_t>()));
+    EXPECT_EQ("Job", reader.ReadText(reader.Read<uint32_t>()));
+    EXPECT_EQ(0, reader.Read<uint32_t>());
+    EXPECT_EQ(1, reader.Read<uint32_t>());
+    EXPECT_EQ(0, reader.Read<uint32_t>());
+
+    // type
+    EXPECT_EQ(0, reader.Read<uint8_t>());
+    ASSERT_EQ(2, reader.Read<uint32_t>());
+    EXPECT_EQ("EXPENSE", reader.ReadText(reader.Read<uint32_t>()));
+    EXPECT_EQ("INCOME", reader.ReadText(reader.Read<uint32_t>()));
+    reader.position += 3 * sizeof(uint32_t);
+
+    // date
+    EXPECT_EQ(0, reader.Read<uint8_t>());
+    EXPECT_EQ(0, reader.Read<uint32_t>());
+    EXPECT_EQ(10, reader.Read<uint32_t>());
+    EXPECT_EQ(20, reader.Read<uint32_t>());
+    EXPECT_EQ(30, reader.Read<uint32_t>());
+    EXPECT_EQ("2024-01-022024-01-032024-01-04", reader.ReadText(30));
+
+    // amount
+    EXPECT_EQ(0, reader.Read<uint8_t>());
+    EXPECT_DOUBLE_EQ(30, reader.Read<double>());
+    EXPECT_DOUBLE_EQ(1000.5, reader.Read<double>());
+    EXPECT_DOUBLE_EQ(4.25, reader.Read<double>());
+
+    // description
+    EXPECT_EQ(0, reader.Read<uint8_t>());
+    reader.position += 3 * sizeof(uint32_t);
+    EXPECT_EQ(25, reader.Read<uint32_t>());
+    EXPECT_EQ("Market, \"big\"SalaryBakery", reader.ReadText(25));
+
+    EXPECT_EQ(0, reader.Read<uint32_t>());
+    EXPECT_EQ(reader.data.size(), reader.position);
+}
+
+TEST_F(ExporterTest, ExportNullsToColumnar)
+{
+    Exporter::Stats stats;
+
+    ASSERT_TRUE(m_exporter.Export(Exporter::Table::Transfer,
+                                  Exporter::Format::Columnar,
+                                  m_path,
+                                  stats));
+
+    std::string data = ReadFile();
+
+    // The description is the last column. Its null bitmap comes before the
+    // offsets of its single row
+    std::size_t bitmap = data.size() - sizeof(uint32_t) - 2 * sizeof(uint32_t) - 1;
+
+    EXPECT_EQ(1, data[bitmap]);
+}
+
+TEST_F(ExporterTest, ExportEmptyTable)
+{
+    m_dbManager.Execute("DELETE FROM Transfer;");
+
+    Exporter::Stats stats;
+
+    ASSERT_TRUE(m_exporter.Export(Exporter::Table::Transfer,
+                                  Exporter::Format::Csv,
+                                  m_path,
+                                  stats));
+
+    EXPECT_EQ(0, stats.rows);
+    EXPECT_EQ("transfer_id,sender_wallet,receiver_wallet,date,amount,description\n",
+              ReadFile());
+}
+
+TEST_F(ExporterTest, ExportToInvalidPath)
+{
+    Exporter::Stats stats;
+
+    EXPECT_FALSE(m_exporter.Export(Exporter::Table::Transfer,
+                                   Exporter::Format::Csv,
+                                   m_path + "/missing/export.csv",
+                                   stats));
+}
@@ -0,0 +1,301 @@
+/*
+ * Filename: memory_ledger_store_test.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "config.h"
+#include "credit_card_manager.h"
+#include "db_manager.h"
+#include "memory_ledger_store.h"
+#include "sqlite_ledger_store.h"
+#include "wallet_manager.h"
+
+class MemoryLedgerStoreTest : public testing::Test
+{
+    protected:
+        MemoryLedgerStore m_store;
+        WalletManager     m_walletManager;
+        CreditCardManager m_creditCardManager;
+
+    public:
+        MemoryLedgerStoreTest()
+            : m_walletManager(m_store),
+              m_creditCardManager(m_store)
+        { }
+};
+
+TEST_F(MemoryLedgerStoreTest, WalletOperations)
+{
+    m_walletManager.CreateWallet("w1", Money(1000));
+    m_walletManager.CreateWallet("w2", Money(0));
+    m_walletManager.CreateWallet("w1", Money(5));
+
+    EXPECT_TRUE(m_walletManager.Expense("w1",
+                                        "Food",
+                                        "2024-01-02",
+                                        "Market",
+                                        Money(100)));
+    EXPECT_TRUE(m_walletManager.Income("w2", "Job", "2024-01-03", "Salary", Money(50)));
+    EXPECT_FALSE(m_walletManager.Expense("w2",
+                                         "Food",
+                                         "2024-01-04",
+                                         "Bakery",
+                                         Money(60)));
+    EXPECT_FALSE(m_walletManager.Expense("w3",
+                                         "Food",
+                                         "2024-01-04",
+                                         "Bakery",
+                                         Money(1)));
+
+    m_walletManager.Transfer("w1", "w2", "2024-01-05", Money(200));
+
+    std::vector<std::string> wallets;
+    std::vector<Money>       balances;
+
+    m_walletManager.GetWallets(wallets, balances);
+
+    ASSERT_EQ(2, wallets.size());
+    EXPECT_EQ("w1", wallets[0]);
+    EXPECT_EQ("w2", wallets[1]);
+    EXPECT_EQ(Money(700), balances[0]);
+    EXPECT_EQ(Money(250), balances[1]);
+
+    EXPECT_EQ(std::vector<std::string>({ "Food", "Job" }), m_store.GetCategoryNames());
+
+    // Back-dated before the first day of w1
+    EXPECT_TRUE(m_walletManager.Expense("w1",
+                                        "Food",
+                                        "2024-01-01",
+                                        "Bakery",
+                                        Money(10)));
+
+    EXPECT_EQ(Money(1000), m_store.GetBalanceAsOf("w1", "2023-12-31"));
+    EXPECT_EQ(Money(890), m_store.GetBalanceAsOf("w1", "2024-01-04"));
+    EXPECT_EQ((std::vector<std::pair<std::string, Money>>{
+                  { "2024-01-01", Money(990) },
+                  { "2024-01-02", Money(890) },
+                  { "2024-01-05", Money(690) } }),
+              m_store.GetBalanceSeries("w1", "2024-01-01", "2024-01-31"));
+
+    m_walletManager.DeleteWallet("w1");
+
+    EXPECT_FALSE(m_store.WalletExists("w1"));
+    EXPECT_TRUE(m_store.GetBalanceSeries("w1", "2024-01-01", "2024-01-31").empty());
+    EXPECT_EQ(Money(250), m_store.GetWalletBalance("w2"));
+}
+
+TEST_F(MemoryLedgerStoreTest, AsyncOperations)
+{
+    m_walletManager.CreateWallet("w1", Money(100));
+
+    EXPECT_TRUE(
+        m_walletManager.ExpenseAsync("w1",
+                                     "Food",
+                                     "2024-01-02",
+                                     "Market",
+                                     Money(30)).get());
+    EXPECT_FALSE(
+        m_walletManager.ExpenseAsync("w1",
+                                     "Food",
+                                     "2024-01-02",
+                                     "Market",
+                                     Money(90)).get());
+
+    EXPECT_EQ(Money(70), m_store.GetWalletBalance("w1"));
+}
+
+TEST_F(MemoryLedgerStoreTest, CreditCardOperations)
+{
+    EXPECT_TRUE(m_creditCardManager.AddCreditCard("1234", 10, "card", Money(1000)));
+    EXPECT_FALSE(m_creditCardManager.AddCreditCard("1234", 10, "card", Money(1000)));
+
+    EXPECT_TRUE(m_creditCardManager.AddDebt("1234",
+                                            "Food",
+                                            "2024-01-02",
+                                            Money(300),
+                                            "A",
+                                            3));
+    EXPECT_TRUE(m_creditCardManager.AddDebt("1234",
+                                            "Trip",
+                                            "2024-01-03",
+                                            Money(600),
+                                            "B",
+                                            2));
+    EXPECT_FALSE(m_creditCardManager.AddDebt("1234",
+                                             "Food",
+                                             "2024-01-04",
+                                             Money(200),
+                                             "",
+                                             1));
+
+    std::string cardName;
+    Money       maxDebt;
+    Money       pendingDebt;
+    uint16_t    billingDueDay;
+
+    ASSERT_TRUE(m_creditCardManager.GetCreditCardInfo("1234",
+                                                      cardName,
+                                                      maxDebt,
+                                                      pendingDebt,
+                                                      billingDueDay));
+
+    EXPECT_EQ("card", cardName);
+    EXPECT_EQ(Money(1000), maxDebt);
+    EXPECT_EQ(Money(900), pendingDebt);
+    EXPECT_EQ(10, billingDueDay);
+
+    std::string category;
+    std::string date;
+    Money       totalAmount;
+    std::string description;
+    uint16_t    installments;
+    uint32_t    debtId;
+
+    ASSERT_TRUE(m_creditCardManager.GetLastExpense("1234",
+                                                   category,
+                                                   date,
+                                                   totalAmount,
+                                                   description,
+                                                   installments,
+                                                   debtId));
+
+    EXPECT_EQ("Trip", category);
+    EXPECT_EQ("2024-01-03", date);
+    EXPECT_EQ(Money(600), totalAmount);
+    EXPECT_EQ("B", description);
+    EXPECT_EQ(2, installments);
+    EXPECT_EQ(2, debtId);
+}
+
+TEST_F(MemoryLedgerStoreTest, RollbackNestedTransactions)
+{
+    m_store.InsertWallet("w1", Money(10));
+
+    {
+        LedgerStore::Transaction outer(m_store);
+
+        ASSERT_TRUE(outer.IsActive());
+
+        m_store.SetWalletBalance("w1", Money(20));
+        m_store.InsertCategory("Food");
+
+        {
+            LedgerStore::Transaction inner(m_store);
+
+            m_store.DeleteWallet("w1");
+            m_store.InsertWallet("w2", Money(5));
+        }
+
+        // Only the inner writes were rolled back
+        EXPECT_TRUE(m_store.WalletExists("w1"));
+        EXPECT_FALSE(m_store.WalletExists("w2"));
+
+        {
+            LedgerStore::Transaction inner(m_store);
+
+            m_store.InsertWallet("w3", Money(5));
+            EXPECT_TRUE(inner.Commit());
+        }
+    }
+
+    EXPECT_EQ(Money(10), m_store.GetWalletBalance("w1"));
+    EXPECT_FALSE(m_store.WalletExists("w3"));
+    EXPECT_FALSE(m_store.FindCategory("Food"));
+    EXPECT_EQ(std::vector<std::string>({ "w1" }), m_store.GetWalletNames());
+}
+
+TEST_F(MemoryLedgerStoreTest, AfterCommitWaitsForOutermostCommit)
+{
+    std::vector<std::string> ran;
+
+    {
+        LedgerStore::Transaction outer(m_store);
+
+        {
+            LedgerStore::Transaction inner(m_store);
+            m_store.AfterCommit([&ran]() { ran.push_back("rolled back"); });
+        }
+
+        {
+            LedgerStore::Transaction inner(m_store);
+            m_store.AfterCommit([&ran]() { ran.push_back("released"); });
+            EXPECT_TRUE(inner.Commit());
+        }
+
+        EXPECT_TRUE(ran.empty());
+        EXPECT_TRUE(outer.Commit());
+    }
+
+    m_store.AfterCommit([&ran]() { ran.push_back("now"); });
+
+    EXPECT_EQ(std::vector<std::string>({ "released", "now" }), ran);
+}
+
+TEST_F(MemoryLedgerStoreTest, PersistToDatabase)
+{
+    m_walletManager.CreateWallet("w1", Money(1000));
+    m_walletManager.CreateWallet("w2", Money(0));
+    m_walletManager.Expense("w1", "Food", "2024-01-02", "Market", Money(100));
+    m_walletManager.Transfer("w1", "w2", "2024-01-05", Money(200));
+
+    m_creditCardManager.AddCreditCard("1234", 10, "card", Money(1000));
+    m_creditCardManager.AddDebt("1234", "Travel", "2024-01-03", Money(600), "Trip", 2);
+
+    DBManager         db(config::IN_MEMORY_DATABASE);
+    SqliteLedgerStore target(db);
+
+    // Categories the database already has are reused
+    ASSERT_TRUE(target.InsertCategory("Travel"));
+
+    ASSERT_TRUE(m_store.PersistTo(target));
+
+    WalletManager     walletManager(db);
+    CreditCardManager creditCardManager(db);
+
+    std::vector<std::string> wallets;
+    std::vector<Money>       balances;
+
+    walletManager.GetWallets(wallets, balances);
+
+    ASSERT_EQ(2, wallets.size());
+    EXPECT_EQ(Money(700), balances[0]);
+    EXPECT_EQ(Money(200), balances[1]);
+
+    std::string category;
+    std::string date;
+    Money       totalAmount;
+    std::string description;
+    uint16_t    installments;
+    uint32_t    debtId;
+
+    ASSERT_TRUE(creditCardManager.GetLastExpense("1234",
+                                                 category,
+                                                 date,
+                                                 totalAmount,
+                                                 description,
+                                                 installments,
+                                                 debtId));
+
+    // The daily balances are copied too
+    EXPECT_EQ(Money(900), target.GetBalanceAsOf("w1", "2024-01-04"));
+    EXPECT_EQ(m_store.GetBalanceSeries("w1", "2024-01-01", "2024-01-31"),
+              target.GetBalanceSeries("w1", "2024-01-01", "2024-01-31"));
+
+    EXPECT_EQ("Travel", category);
+    EXPECT_EQ(2, installments);
+    EXPECT_EQ(Money(600), target.GetPendingDebt("1234"));
+    EXPECT_EQ(1, target.FindCategory("Travel").value_or(0));
+    EXPECT_EQ(2, target.FindCategory("Food").value_or(0));
+
+    // A second copy conflicts with the wallets already there, and is rolled back
+    EXPECT_FALSE(m_store.PersistTo(target));
+    EXPECT_EQ(1, db.QueryOne<int64_t>("SELECT COUNT(*) FROM Transfer;").value_or(0));
+}
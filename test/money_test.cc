@@ -0,0 +1,128 @@
+/*
+ * Filename: money_test.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
+
+#include "money.h"
+
+TEST(MoneyTest, RoundsToCents)
+{
+    EXPECT_EQ(10, Money(0.1).Cents());
+    EXPECT_EQ(30, (Money(0.1) + Money(0.2)).Cents());
+    EXPECT_EQ(Money(0.3), Money(0.1) + Money(0.2));
+    EXPECT_EQ(-1235, Money(-12.345).Cents());
+    EXPECT_DOUBLE_EQ(0.3, (Money(0.1) + Money(0.2)).ToDouble());
+
+    EXPECT_TRUE(Money(0.01).IsPositive());
+    EXPECT_FALSE(Money(0.004).IsPositive());
+    EXPECT_LT(Money(1), Money(1.01));
+}
+
+TEST(MoneyTest, ToString)
+{
+    EXPECT_EQ("0.00", Money().ToString());
+    EXPECT_EQ("12.05", Money(12.05).ToString());
+    EXPECT_EQ("-0.50", Money(-0.5).ToString());
+    EXPECT_EQ("-1234.99", Money::FromCents(-123499).ToString());
+}
+
+TEST(MoneyTest, SplitAddsUpToAmount)
+{
+    for (int64_t cents : { 10000, 1, 99, -10000, 0 })
+    {
+        for (uint16_t parts : { 1, 3, 7, 12 })
+        {
+            std::vector<Money> split = Money::FromCents(cents).Split(parts);
+
+            ASSERT_EQ(parts, split.size());
+
+            Money total;
+
+            for (Money part : split)
+            {
+                total += part;
+                EXPECT_LE(std::abs(part.Cents() - split.back().Cents()), 1);
+            }
+
+            EXPECT_EQ(cents, total.Cents());
+        }
+    }
+
+    EXPECT_EQ(std::vector<Money>({ Money(33.34), Money(33.33), Money(33.33) }),
+              Money(100).Split(3));
+    EXPECT_TRUE(Money(100).Split(0).empty());
+}
+
+TEST(MoneyTest, KernelsMatchPlainLoops)
+{
+    // Sizes around the number of lanes, so the tails are covered
+    for (std::size_t size : { 0, 1, 7, 8, 9, 16, 17, 1000 })
+    {
+        std::vector<int64_t>  cents(size);
+        std::vector<uint32_t> groups(size);
+
+        for (std::size_t i = 0; i < size; i++)
+        {
+            cents[i]  = static_cast<int64_t>((i * 7919) % 20011) - 10000;
+            groups[i] = static_cast<uint32_t>((i / 3) % 5);
+        }
+
+        EXPECT_EQ(std::accumulate(cents.begin(), cents.end(), int64_t{ 0 }),
+                  money::Sum(cents));
+
+        std::vector<int64_t> expected(5, 0);
+        std::vector<int64_t> sums(5, 0);
+
+        for (std::size_t i = 0; i < size; i++)
+        {
+            expected[groups[i]] += cents[i];
+        }
+
+        money::GroupedSum(cents, groups, sums);
+        EXPECT_EQ(expected, sums);
+
+        // Interleaved groups, as report rows usually come
+        std::fill(expected.begin(), expected.end(), 0);
+        std::fill(sums.begin(), sums.end(), 0);
+
+        for (std::size_t i = 0; i < size; i++)
+        {
+            groups[i] = static_cast<uint32_t>(i % 5);
+            expected[groups[i]] += cents[i];
+        }
+
+        money::GroupedSum(cents, groups, sums);
+        EXPECT_EQ(expected, sums);
+
+        auto minMax = money::MinMax(cents);
+
+        if (size == 0)
+        {
+            EXPECT_FALSE(minMax.has_value());
+            continue;
+        }
+
+        ASSERT_TRUE(minMax.has_value());
+        EXPECT_EQ(*std::min_element(cents.begin(), cents.end()), minMax->first);
+        EXPECT_EQ(*std::max_element(cents.begin(), cents.end()), minMax->second);
+    }
+}
+
+// The bound is only checked when assertions are enabled
+#ifndef NDEBUG
+TEST(MoneyTest, GroupedSumRejectsGroupOutOfRange)
+{
+    std::vector<int64_t>  cents  = { 1, 2 };
+    std::vector<uint32_t> groups = { 0, 2 };
+    std::vector<int64_t>  sums(2, 0);
+
+    EXPECT_DEATH(money::GroupedSum(cents, groups, sums), "");
+}
+#endif
@@ -0,0 +1,107 @@
+/*
+ * Filename: query_profiler_test.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "db_manager.h"
+#include "query_profiler.h"
+#include "sql_queries.h"
+
+class QueryProfilerTest : public testing::Test
+{
+    protected:
+        DBManager m_dbManager;
+
+        QueryProfilerTest()
+            : m_dbManager(config::IN_MEMORY_DATABASE)
+        { }
+
+        static const QueryProfiler::Stats*
+        FindStats(const std::vector<QueryProfiler::Stats>& stats,
+                  std::string                              sql)
+        {
+            // SQLite reports the statement text without the terminating semicolon
+            if (sql.ends_with(';'))
+            {
+                sql.pop_back();
+            }
+
+            auto it = std::find_if(stats.begin(),
+                                   stats.end(),
+                                   [&sql](const QueryProfiler::Stats& s) {
+                                       return s.sql == sql;
+                                   });
+
+            return it != stats.end() ? &*it : nullptr;
+        }
+};
+
+TEST_F(QueryProfilerTest, HistogramPercentiles)
+{
+    LatencyHistogram histogram;
+
+    EXPECT_EQ(0, histogram.GetPercentile(0.5));
+
+    for (uint64_t value = 1; value <= 1000; value++)
+    {
+        histogram.Record(value);
+    }
+
+    EXPECT_EQ(1000, histogram.GetCount());
+    EXPECT_EQ(1000, histogram.GetMax());
+
+    // Buckets are at most 1/16 of their value wide
+    EXPECT_NEAR(500, histogram.GetPercentile(0.50), 500 / 16);
+    EXPECT_NEAR(950, histogram.GetPercentile(0.95), 950 / 16);
+    EXPECT_NEAR(990, histogram.GetPercentile(0.99), 990 / 16);
+    EXPECT_EQ(1000, histogram.GetPercentile(1.0));
+}
+
+TEST_F(QueryProfilerTest, HistogramSmallAndLargeValues)
+{
+    LatencyHistogram histogram;
+
+    histogram.Record(0);
+    histogram.Record(UINT64_MAX);
+
+    EXPECT_EQ(0, histogram.GetPercentile(0.5));
+    EXPECT_EQ(UINT64_MAX, histogram.GetPercentile(1.0));
+}
+
+TEST_F(QueryProfilerTest, StatementsAreGroupedByTemplate)
+{
+    for (int i = 0; i < 5; i++)
+    {
+        ASSERT_TRUE(
+            m_dbManager.Execute(query::INSERT_WALLET, "w" + std::to_string(i), i));
+    }
+
+    EXPECT_EQ(5, m_dbManager.QueryAs<std::string>(query::SELECT_WALLET_NAMES).size());
+    EXPECT_EQ(5, m_dbManager.QueryAs<std::string>(query::SELECT_WALLET_NAMES).size());
+
+    std::vector<QueryProfiler::Stats> stats = m_dbManager.GetQueryStats();
+
+    const QueryProfiler::Stats* insert = FindStats(stats, query::INSERT_WALLET);
+    ASSERT_NE(nullptr, insert);
+    EXPECT_EQ(5, insert->calls);
+    EXPECT_EQ(0, insert->rows);
+
+    const QueryProfiler::Stats* select = FindStats(stats, query::SELECT_WALLET_NAMES);
+    ASSERT_NE(nullptr, select);
+    EXPECT_EQ(2, select->calls);
+    EXPECT_EQ(10, select->rows);
+    EXPECT_LE(select->p50, select->p99);
+    EXPECT_LE(select->p99, select->max);
+    EXPECT_LE(select->max, select->total);
+
+    m_dbManager.ResetQueryStats();
+    EXPECT_TRUE(m_dbManager.GetQueryStats().empty());
+}
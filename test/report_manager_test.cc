@@ -0,0 +1,146 @@
+/*
+ * Filename: report_manager_test.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "config.h"
+#include "credit_card_manager.h"
+#include "db_manager.h"
+#include "memory_ledger_store.h"
+#include "report_manager.h"
+#include "sql_queries.h"
+#include "wallet_manager.h"
+
+class ReportManagerTest : public testing::Test
+{
+    protected:
+        DBManager         m_dbManager;
+        WalletManager     m_walletManager;
+        CreditCardManager m_creditCardManager;
+        ReportManager     m_reportManager;
+
+        void SetUp() override
+        {
+            m_walletManager.CreateWallet("w1", Money(1000));
+            m_creditCardManager.AddCreditCard("1234", 10, "card", Money(1000));
+
+            m_walletManager.Expense("w1", "Food", "2024-01-02", "Market", Money(100));
+            m_walletManager.Expense("w1", "Food", "2024-01-20", "Bakery", Money(20));
+            m_walletManager.Income("w1", "Job", "2024-01-05", "Salary", Money(500));
+            m_walletManager.Expense("w1", "Rent", "2024-02-01", "February", Money(300));
+            m_creditCardManager.AddDebt("1234",
+                                        "Food",
+                                        "2024-02-10",
+                                        Money(90),
+                                        "Dinner",
+                                        3);
+        }
+
+    public:
+        ReportManagerTest()
+            : m_dbManager(config::IN_MEMORY_DATABASE),
+              m_walletManager(m_dbManager),
+              m_creditCardManager(m_dbManager),
+              m_reportManager(m_dbManager)
+        { }
+};
+
+TEST_F(ReportManagerTest, SpendingSummary)
+{
+    std::vector<SpendingCell> cells;
+
+    m_reportManager.GetSpendingSummary("2024-01", "2024-01", cells);
+
+    ASSERT_EQ(2, cells.size());
+
+    EXPECT_EQ("2024-01", cells[0].month);
+    EXPECT_EQ("EXPENSE", cells[0].kind);
+    EXPECT_EQ("w1", cells[0].source);
+    EXPECT_EQ(Money(120), cells[0].total);
+    EXPECT_EQ(2, cells[0].count);
+    EXPECT_EQ(Money(20), cells[0].minAmount);
+    EXPECT_EQ(Money(100), cells[0].maxAmount);
+
+    EXPECT_EQ("INCOME", cells[1].kind);
+    EXPECT_EQ(Money(500), cells[1].total);
+
+    std::vector<std::string> categories;
+    std::vector<Money>       totals;
+
+    m_reportManager.GetSpendingByCategory("2024-01", "2024-12", categories, totals);
+
+    EXPECT_EQ(std::vector<std::string>({ "Rent", "Food" }), categories);
+    EXPECT_EQ(std::vector<Money>({ Money(300), Money(210) }), totals);
+}
+
+TEST_F(ReportManagerTest, RebuildSpendingSummary)
+{
+    std::vector<SpendingCell> before;
+    std::vector<SpendingCell> after;
+
+    m_reportManager.GetSpendingSummary("0000-00", "9999-12", before);
+
+    // An expense written without the managers is only seen after a rebuild
+    ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET_TRANSACTION,
+                                    "w1",
+                                    1,
+                                    "EXPENSE",
+                                    "2024-03-01",
+                                    Money(7),
+                                    "Coffee"));
+
+    m_reportManager.GetSpendingSummary("2024-03", "2024-03", after);
+    EXPECT_TRUE(after.empty());
+
+    ASSERT_TRUE(m_reportManager.RebuildSpendingSummary());
+
+    m_reportManager.GetSpendingSummary("2024-03", "2024-03", after);
+    ASSERT_EQ(1, after.size());
+    EXPECT_EQ(Money(7), after[0].total);
+
+    // The rebuilt cells of the other months match the incremental ones
+    m_reportManager.GetSpendingSummary("0000-00", "2024-02", after);
+    ASSERT_EQ(before.size(), after.size());
+
+    for (std::size_t i = 0; i < before.size(); i++)
+    {
+        EXPECT_EQ(before[i].month, after[i].month);
+        EXPECT_EQ(before[i].kind, after[i].kind);
+        EXPECT_EQ(before[i].count, after[i].count);
+        EXPECT_EQ(before[i].total, after[i].total);
+    }
+}
+
+TEST_F(ReportManagerTest, MemoryStoreSummary)
+{
+    MemoryLedgerStore store;
+    WalletManager     walletManager(store);
+    ReportManager     reportManager(store);
+
+    walletManager.CreateWallet("w1", Money(100));
+    walletManager.Expense("w1", "Food", "2024-01-02", "Market", Money(10));
+    walletManager.Expense("w1", "Food", "2024-01-03", "Market", Money(30));
+
+    std::vector<SpendingCell> cells;
+
+    reportManager.GetSpendingSummary("2024-01", "2024-01", cells);
+
+    ASSERT_EQ(1, cells.size());
+    EXPECT_EQ(Money(40), cells[0].total);
+    EXPECT_EQ(Money(10), cells[0].minAmount);
+    EXPECT_EQ(Money(30), cells[0].maxAmount);
+
+    ASSERT_TRUE(reportManager.RebuildSpendingSummary());
+
+    reportManager.GetSpendingSummary("2024-01", "2024-01", cells);
+
+    ASSERT_EQ(1, cells.size());
+    EXPECT_EQ(2, cells[0].count);
+    EXPECT_EQ(Money(40), cells[0].total);
+}
@@ -0,0 +1,100 @@
+/*
+ * Filename: slow_query_log_test.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+
+#include "config.h"
+#include "db_manager.h"
+#include "slow_query_log.h"
+#include "sql_queries.h"
+
+/**
+ * @brief Database file of a single test, removed before and after it runs.
+ *        Plans are captured on a connection of their own, which cannot see an
+ *        in-memory database
+ **/
+struct TemporaryDatabase
+{
+        std::string path;
+
+        explicit TemporaryDatabase(const std::string& name)
+            : path(config::DATABASE_PATH + name + "_" + std::to_string(getpid()) +
+                   ".db")
+        {
+            Remove();
+        }
+
+        ~TemporaryDatabase()
+        {
+            Remove();
+        }
+
+        void Remove() const
+        {
+            std::error_code error;
+
+            for (const char* suffix : { "", "-wal", "-shm" })
+            {
+                std::filesystem::remove(path + suffix, error);
+            }
+        }
+};
+
+class SlowQueryLogTest : public testing::Test
+{
+    protected:
+        TemporaryDatabase m_database;
+        DBManager         m_dbManager;
+
+        SlowQueryLogTest()
+            : m_database("slow_query_log_test"),
+              m_dbManager(m_database.path)
+        { }
+};
+
+TEST_F(SlowQueryLogTest, Threshold)
+{
+    SlowQueryLog slowQueryLog(LogManager::GetInstance(), std::chrono::milliseconds(5));
+
+    EXPECT_FALSE(slowQueryLog.IsSlow(std::chrono::milliseconds(4)));
+    EXPECT_TRUE(slowQueryLog.IsSlow(std::chrono::milliseconds(5)));
+
+    slowQueryLog.SetThreshold(std::chrono::seconds(1));
+    EXPECT_EQ(std::chrono::seconds(1), slowQueryLog.GetThreshold());
+    EXPECT_FALSE(slowQueryLog.IsSlow(std::chrono::milliseconds(5)));
+}
+
+TEST_F(SlowQueryLogTest, FastStatementsAreNotLogged)
+{
+    m_dbManager.SetSlowQueryThreshold(std::chrono::hours(1));
+
+    uint64_t count = m_dbManager.GetSlowQueryCount();
+
+    ASSERT_TRUE(m_dbManager.Execute(query::INSERT_WALLET, "fast", 1.0));
+    EXPECT_EQ(count, m_dbManager.GetSlowQueryCount());
+}
+
+TEST_F(SlowQueryLogTest, SlowStatementsAreLoggedWithPlan)
+{
+    m_dbManager.SetSlowQueryThreshold(std::chrono::nanoseconds(0));
+
+    uint64_t count = m_dbManager.GetSlowQueryCount();
+
+    m_dbManager.QueryOne<double_t>(query::SELECT_CREDIT_CARD_PENDING_DEBT, "1234");
+
+    EXPECT_LT(count, m_dbManager.GetSlowQueryCount());
+
+    std::string plan =
+        m_dbManager.GetSlowQueryPlan(query::SELECT_CREDIT_CARD_PENDING_DEBT);
+
+    EXPECT_NE(std::string::npos, plan.find("idx_credit_card_payment_pending")) << plan;
+}
@@ -0,0 +1,160 @@
+/*
+ * Filename: statement_cache_test.cc
+ * Created on: October 16, 2026
+ * Author: Lucas Araújo <araujolucas@dcc.ufmg.br>
+ */
+
+#include <gtest/gtest.h>
+#include <sqlite3.h>
+#include <string>
+
+#include "statement_cache.h"
+
+class StatementCacheTest : public testing::Test
+{
+    protected:
+        sqlite3* m_db;
+
+        void SetUp() override
+        {
+            ASSERT_EQ(SQLITE_OK, sqlite3_open(":memory:", &m_db));
+            ASSERT_EQ(SQLITE_OK,
+                      sqlite3_exec(m_db,
+                                   "CREATE TABLE T (name TEXT, value INTEGER);",
+                                   nullptr,
+                                   nullptr,
+                                   nullptr));
+        }
+
+        void TearDown() override
+        {
+            sqlite3_close(m_db);
+        }
+};
+
+TEST_F(StatementCacheTest, NormalizeCollapsesWhitespace)
+{
+    EXPECT_EQ("SELECT name FROM T WHERE value = ?",
+              StatementCache::Normalize("  SELECT name\n FROM T\tWHERE value = ?; "));
+
+    // Quoted literals are kept untouched
+    EXPECT_EQ("SELECT 'a  b' FROM T",
+              StatementCache::Normalize("SELECT 'a  b'  FROM T"));
+}
+
+TEST_F(StatementCacheTest, StatementWithComments)
+{
+    EXPECT_EQ("SELECT name FROM T WHERE '--' = ?",
+              StatementCache::Normalize("SELECT name -- x\nFROM /* y */ T\n"
+                                        "WHERE '--' = ? /* z"));
+
+    StatementCache cache(m_db, 4);
+
+    {
+        StatementCache::Lease stmt = cache.Acquire("SELECT 1 -- x\nFROM T");
+        ASSERT_TRUE(stmt);
+        EXPECT_EQ(SQLITE_DONE, sqlite3_step(stmt.Get()));
+    }
+
+    // The text left in a comment does not share the entry of a statement
+    StatementCache::Lease stmt = cache.Acquire("SELECT 1 -- x FROM T");
+    ASSERT_TRUE(stmt);
+    EXPECT_EQ(0, cache.GetStats().hits);
+    EXPECT_EQ(SQLITE_ROW, sqlite3_step(stmt.Get()));
+}
+
+TEST_F(StatementCacheTest, ReuseStatement)
+{
+    StatementCache cache(m_db, 4);
+
+    {
+        StatementCache::Lease stmt = cache.Acquire("SELECT COUNT(*) FROM T;");
+        ASSERT_TRUE(stmt);
+        ASSERT_EQ(SQLITE_ROW, sqlite3_step(stmt.Get()));
+    }
+
+    sqlite3_stmt* first = nullptr;
+
+    {
+        StatementCache::Lease stmt = cache.Acquire("SELECT  COUNT(*)\nFROM T");
+        ASSERT_TRUE(stmt);
+        first = stmt.Get();
+
+        // The statement was reset when it went back to the cache
+        ASSERT_EQ(SQLITE_ROW, sqlite3_step(stmt.Get()));
+        EXPECT_EQ(0, sqlite3_column_int(stmt.Get(), 0));
+    }
+
+    StatementCache::Lease stmt = cache.Acquire("SELECT COUNT(*) FROM T");
+
+    EXPECT_EQ(first, stmt.Get());
+    EXPECT_EQ(2, cache.GetStats().hits);
+    EXPECT_EQ(1, cache.GetStats().misses);
+}
+
+TEST_F(StatementCacheTest, NestedAcquireOfSameStatement)
+{
+    StatementCache cache(m_db, 4);
+
+    StatementCache::Lease outer = cache.Acquire("SELECT value FROM T");
+    StatementCache::Lease inner = cache.Acquire("SELECT value FROM T");
+
+    ASSERT_TRUE(outer);
+    ASSERT_TRUE(inner);
+    EXPECT_NE(outer.Get(), inner.Get());
+    EXPECT_EQ(2, cache.GetStats().misses);
+}
+
+TEST_F(StatementCacheTest, EvictLeastRecentlyUsed)
+{
+    StatementCache cache(m_db, 2);
+
+    for (int i = 0; i < 3; i++)
+    {
+        StatementCache::Lease stmt =
+            cache.Acquire("SELECT value FROM T WHERE value = " + std::to_string(i));
+        ASSERT_TRUE(stmt);
+    }
+
+    EXPECT_EQ(2, cache.GetStats().size);
+    EXPECT_EQ(1, cache.GetStats().evictions);
+
+    // The first statement was evicted, the last one is still cached
+    {
+        StatementCache::Lease stmt =
+            cache.Acquire("SELECT value FROM T WHERE value = 2");
+    }
+    EXPECT_EQ(1, cache.GetStats().hits);
+
+    {
+        StatementCache::Lease stmt =
+            cache.Acquire("SELECT value FROM T WHERE value = 0");
+    }
+    EXPECT_EQ(4, cache.GetStats().misses);
+}
+
+TEST_F(StatementCacheTest, ClearBindingsOnRelease)
+{
+    StatementCache cache(m_db, 4);
+
+    {
+        StatementCache::Lease stmt = cache.Acquire("SELECT ?");
+        ASSERT_TRUE(stmt);
+        sqlite3_bind_int(stmt.Get(), 1, 42);
+    }
+
+    StatementCache::Lease stmt = cache.Acquire("SELECT ?");
+    ASSERT_EQ(SQLITE_ROW, sqlite3_step(stmt.Get()));
+    EXPECT_EQ(SQLITE_NULL, sqlite3_column_type(stmt.Get(), 0));
+}
+
+TEST_F(StatementCacheTest, ScriptIsNotCached)
+{
+    StatementCache cache(m_db, 4);
+
+    StatementCache::Lease stmt = cache.Acquire("SELECT 1; SELECT 2;");
+
+    EXPECT_FALSE(stmt);
+    EXPECT_TRUE(stmt.HasTail());
+    EXPECT_EQ(0, cache.GetStats().size);
+}
@@ -5,31 +5,33 @@
  */
 
 #include <cmath>
+#include <filesystem>
+#include <future>
 #include <gtest/gtest.h>
 #include <iostream>
 #include <string>
 #include <vector>
 
 #include "db_manager.h"
+#include "sql_queries.h"
 #include "wallet_manager.h"
 
 class WalletManagerTest : public testing::Test
 {
     protected:
         WalletManager* m_walletManager;
-        DBManager&     m_dbManager;
+        DBManager      m_dbManager;
 
         void SetUp() override
         {
-            m_dbManager.ResetDatabase();
-            m_walletManager = new WalletManager();
+            m_walletManager = new WalletManager(m_dbManager);
         }
 
         void TearDown() override { }
 
     public:
         WalletManagerTest()
-            : m_dbManager(DBManager::GetInstance())
+            : m_dbManager(config::IN_MEMORY_DATABASE)
         { }
 
         ~WalletManagerTest()
@@ -50,7 +52,7 @@ TEST_F(WalletManagerTest, CreateValidWallet)
 
     EXPECT_EQ(3, wallets.size());
 
-    m_walletManager->CreateWallet("w4", 100);
+    m_walletManager->CreateWallet("w4", Money(100));
 
     m_walletManager->GetWallets(wallets);
 
@@ -118,107 +120,383 @@ TEST_F(WalletManagerTest, DeleteInvalidWallet)
 
 TEST_F(WalletManagerTest, IncomeValidValue)
 {
-    m_walletManager->CreateWallet("w1", 100);
-    m_walletManager->CreateWallet("w2", 200);
+    m_walletManager->CreateWallet("w1", Money(100));
+    m_walletManager->CreateWallet("w2", Money(200));
 
-    m_walletManager->Income("w1", "", "", "", 50);
-    m_walletManager->Income("w2", "", "", "", 100);
+    m_walletManager->Income("w1", "", "", "", Money(50));
+    m_walletManager->Income("w2", "", "", "", Money(100));
 
     std::vector<std::string> wallets;
-    std::vector<double_t>    balances;
+    std::vector<Money>       balances;
 
     m_walletManager->GetWallets(wallets, balances);
 
     EXPECT_EQ(2, wallets.size());
-    EXPECT_EQ(150, balances[0]);
-    EXPECT_EQ(300, balances[1]);
+    EXPECT_EQ(Money(150), balances[0]);
+    EXPECT_EQ(Money(300), balances[1]);
 }
 
 TEST_F(WalletManagerTest, IncomeInvalidValue)
 {
-    m_walletManager->CreateWallet("w1", 100);
-    m_walletManager->CreateWallet("w2", 200);
+    m_walletManager->CreateWallet("w1", Money(100));
+    m_walletManager->CreateWallet("w2", Money(200));
 
-    m_walletManager->Income("w1", "", "", "", -50);
-    m_walletManager->Income("w2", "", "", "", 0);
+    m_walletManager->Income("w1", "", "", "", Money(-50));
+    m_walletManager->Income("w2", "", "", "", Money(0));
 
     std::vector<std::string> wallets;
-    std::vector<double_t>    balances;
+    std::vector<Money>       balances;
 
     m_walletManager->GetWallets(wallets, balances);
 
     EXPECT_EQ(2, wallets.size());
-    EXPECT_EQ(100, balances[0]);
-    EXPECT_EQ(200, balances[1]);
+    EXPECT_EQ(Money(100), balances[0]);
+    EXPECT_EQ(Money(200), balances[1]);
 }
 
 TEST_F(WalletManagerTest, ExpenseValidValue)
 {
-    m_walletManager->CreateWallet("w1", 100);
-    m_walletManager->CreateWallet("w2", 200);
+    m_walletManager->CreateWallet("w1", Money(100));
+    m_walletManager->CreateWallet("w2", Money(200));
 
-    m_walletManager->Expense("w1", "", "", "", 50);
-    m_walletManager->Expense("w2", "", "", "", 100);
+    m_walletManager->Expense("w1", "", "", "", Money(50));
+    m_walletManager->Expense("w2", "", "", "", Money(100));
 
     std::vector<std::string> wallets;
-    std::vector<double_t>    balances;
+    std::vector<Money>       balances;
 
     m_walletManager->GetWallets(wallets, balances);
 
     EXPECT_EQ(2, wallets.size());
-    EXPECT_EQ(50, balances[0]);
-    EXPECT_EQ(100, balances[1]);
+    EXPECT_EQ(Money(50), balances[0]);
+    EXPECT_EQ(Money(100), balances[1]);
 }
 
 TEST_F(WalletManagerTest, ExpenseInvalidValue)
 {
-    m_walletManager->CreateWallet("w1", 100);
-    m_walletManager->CreateWallet("w2", 200);
+    m_walletManager->CreateWallet("w1", Money(100));
+    m_walletManager->CreateWallet("w2", Money(200));
 
-    m_walletManager->Expense("w1", "", "", "", -50);
-    m_walletManager->Expense("w2", "", "", "", 0);
+    m_walletManager->Expense("w1", "", "", "", Money(-50));
+    m_walletManager->Expense("w2", "", "", "", Money(0));
 
     std::vector<std::string> wallets;
-    std::vector<double_t>    balances;
+    std::vector<Money>       balances;
 
     m_walletManager->GetWallets(wallets, balances);
 
     EXPECT_EQ(2, wallets.size());
-    EXPECT_EQ(100, balances[0]);
-    EXPECT_EQ(200, balances[1]);
+    EXPECT_EQ(Money(100), balances[0]);
+    EXPECT_EQ(Money(200), balances[1]);
 }
 
 TEST_F(WalletManagerTest, TransferValidValue)
 {
-    m_walletManager->CreateWallet("w1", 100);
-    m_walletManager->CreateWallet("w2", 200);
+    m_walletManager->CreateWallet("w1", Money(100));
+    m_walletManager->CreateWallet("w2", Money(200));
 
-    m_walletManager->Transfer("w1", "w2", "", 50);
+    m_walletManager->Transfer("w1", "w2", "", Money(50));
 
     std::vector<std::string> wallets;
-    std::vector<double_t>    balances;
+    std::vector<Money>       balances;
 
     m_walletManager->GetWallets(wallets, balances);
 
     EXPECT_EQ(2, wallets.size());
-    EXPECT_EQ(50, balances[0]);
-    EXPECT_EQ(250, balances[1]);
+    EXPECT_EQ(Money(50), balances[0]);
+    EXPECT_EQ(Money(250), balances[1]);
 }
 
 TEST_F(WalletManagerTest, TransferInvalidValue)
 {
-    m_walletManager->CreateWallet("w1", 100);
-    m_walletManager->CreateWallet("w2", 200);
+    m_walletManager->CreateWallet("w1", Money(100));
+    m_walletManager->CreateWallet("w2", Money(200));
 
-    m_walletManager->Transfer("w1", "w2", "", -50);
-    m_walletManager->Transfer("w1", "w2", "", 0);
+    m_walletManager->Transfer("w1", "w2", "", Money(-50));
+    m_walletManager->Transfer("w1", "w2", "", Money(0));
 
     std::vector<std::string> wallets;
-    std::vector<double_t>    balances;
+    std::vector<Money>       balances;
 
     m_walletManager->GetWallets(wallets, balances);
 
     EXPECT_EQ(2, wallets.size());
-    EXPECT_EQ(100, balances[0]);
-    EXPECT_EQ(200, balances[1]);
+    EXPECT_EQ(Money(100), balances[0]);
+    EXPECT_EQ(Money(200), balances[1]);
+}
+
+TEST_F(WalletManagerTest, AsyncExpenseAndIncome)
+{
+    m_walletManager->CreateWallet("w1", Money(100));
+
+    std::future<bool> expense = m_walletManager->ExpenseAsync("w1",
+                                                              "",
+                                                              "",
+                                                              "",
+                                                              Money(30));
+    std::future<bool> income  = m_walletManager->IncomeAsync("w1",
+                                                             "",
+                                                             "",
+                                                             "",
+                                                             Money(50));
+    std::future<bool> invalid = m_walletManager->ExpenseAsync("w1",
+                                                              "",
+                                                              "",
+                                                              "",
+                                                              Money(500));
+
+    EXPECT_TRUE(expense.get());
+    EXPECT_TRUE(income.get());
+    EXPECT_FALSE(invalid.get());
+
+    std::vector<std::string> wallets;
+    std::vector<Money>       balances;
+
+    m_walletManager->GetWallets(wallets, balances);
+
+    EXPECT_EQ(1, wallets.size());
+    EXPECT_EQ(Money(120), balances[0]);
+}
+
+TEST_F(WalletManagerTest, InvalidateBalanceCache)
+{
+    m_walletManager->CreateWallet("w1", Money(100));
+
+    // Changed behind the manager, so the cached balance is stale
+    m_dbManager.Execute("UPDATE Wallet SET balance = 1000 WHERE name = 'w1';");
+    m_dbManager.Execute("INSERT INTO Wallet (name, balance) VALUES ('w2', 0);");
+
+    m_walletManager->InvalidateCache();
+
+    EXPECT_FALSE(m_walletManager->Expense("w1", "", "", "", Money(50)));
+    EXPECT_TRUE(m_walletManager->Expense("w1", "", "", "", Money(5)));
+
+    m_walletManager->Transfer("w1", "w2", "", Money(5));
+
+    std::vector<std::string> wallets;
+    std::vector<Money>       balances;
+
+    m_walletManager->GetWallets(wallets, balances);
+
+    EXPECT_EQ(2, wallets.size());
+    EXPECT_EQ(Money(0), balances[0]);
+    EXPECT_EQ(Money(5), balances[1]);
+}
+
+TEST_F(WalletManagerTest, RestoreReloadsBalanceCache)
+{
+    const std::string backup = config::DATABASE_PATH + "wallet_manager_backup.db";
+
+    m_walletManager->CreateWallet("w1", Money(100));
+    ASSERT_TRUE(m_dbManager.Backup(backup).get());
+
+    // The cache forgets the wallet, which the restore brings back
+    m_walletManager->DeleteWallet("w1");
+    ASSERT_TRUE(m_dbManager.Restore(backup));
+    std::filesystem::remove(backup);
+
+    EXPECT_TRUE(m_walletManager->Expense("w1", "", "", "", Money(30)));
+
+    std::vector<std::string> wallets;
+    std::vector<Money>       balances;
+
+    m_walletManager->GetWallets(wallets, balances);
+
+    ASSERT_EQ(1, wallets.size());
+    EXPECT_EQ(Money(70), balances[0]);
+}
+
+TEST_F(WalletManagerTest, RolledBackOuterTransactionKeepsCache)
+{
+    m_walletManager->CreateWallet("w1", Money(100));
+
+    {
+        // The deletion only releases a savepoint, which the outer scope discards
+        DBManager::Transaction outer(m_dbManager);
+        m_walletManager->DeleteWallet("w1");
+        m_walletManager->CreateWallet("w2", Money(50));
+    }
+
+    EXPECT_TRUE(m_walletManager->Expense("w1", "", "", "", Money(30)));
+    EXPECT_FALSE(m_walletManager->Expense("w2", "", "", "", Money(10)));
+
+    m_walletManager->CreateWallet("w2", Money(50));
+
+    std::vector<std::string> wallets;
+    m_walletManager->GetWallets(wallets);
+
+    EXPECT_EQ(2, wallets.size());
+}
+
+TEST_F(WalletManagerTest, GuardedDebitIgnoresStaleCache)
+{
+    m_walletManager->CreateWallet("w1", Money(100));
+    m_walletManager->CreateWallet("w2", Money(0));
+
+    // Another writer spent most of the balance behind the manager
+    m_dbManager.Execute("UPDATE Wallet SET balance = 1000 WHERE name = 'w1';");
+
+    EXPECT_FALSE(m_walletManager->Expense("w1", "", "", "", Money(50)));
+    m_walletManager->Transfer("w1", "w2", "", Money(20));
+
+    EXPECT_TRUE(m_walletManager->Income("w1", "", "", "", Money(5)));
+    EXPECT_TRUE(m_walletManager->Expense("w1", "", "", "", Money(15)));
+
+    std::vector<std::string> wallets;
+    std::vector<Money>       balances;
+
+    m_walletManager->GetWallets(wallets, balances);
+
+    EXPECT_EQ(Money(0), balances[0]);
+    EXPECT_EQ(Money(0), balances[1]);
+    EXPECT_EQ(2,
+              m_dbManager.QueryOne<int64_t>("SELECT COUNT(*) FROM WalletTransaction;")
+                  .value_or(0));
+    EXPECT_EQ(0, m_dbManager.QueryOne<int64_t>("SELECT COUNT(*) FROM Transfer;")
+                     .value_or(-1));
+}
+
+TEST_F(WalletManagerTest, RecordBatch)
+{
+    using Type   = WalletOp::Type;
+    using Status = WalletManager::OpStatus;
+
+    m_walletManager->CreateWallet("w1", Money(100));
+    m_walletManager->CreateWallet("w2", Money(0));
+
+    std::vector<WalletOp> ops = {
+        { Type::Expense, "w1", "", "Food", "2024-01-02", "Market", Money(30) },
+        { Type::Income, "w2", "", "Job", "2024-01-03", "Salary", Money(50) },
+        { Type::Transfer, "w1", "w2", "", "2024-01-04", "", Money(60) },
+        { Type::Expense, "w1", "", "Food", "2024-01-05", "Bakery", Money(20) },
+        { Type::Expense, "w3", "", "Food", "2024-01-05", "Bakery", Money(1) },
+        { Type::Transfer, "w2", "w2", "", "2024-01-06", "", Money(1) },
+        { Type::Income, "w1", "", "Job", "2024-01-06", "Bonus", Money(-5) },
+        { Type::Expense, "w2", "", "Food", "2024-01-07", "Dinner", Money(110) },
+    };
+
+    std::vector<Status> results;
+
+    ASSERT_TRUE(m_walletManager->RecordBatch(ops, results));
+
+    std::vector<Status> expected = { Status::Recorded,
+                                     Status::Recorded,
+                                     Status::Recorded,
+                                     Status::InsufficientBalance,
+                                     Status::WalletNotFound,
+                                     Status::SameWallet,
+                                     Status::InvalidAmount,
+                                     Status::Recorded };
+
+    EXPECT_EQ(expected, results);
+
+    std::vector<std::string> wallets;
+    std::vector<Money>       balances;
+
+    m_walletManager->GetWallets(wallets, balances);
+
+    EXPECT_EQ(Money(10), balances[0]);
+    EXPECT_EQ(Money(0), balances[1]);
+    EXPECT_EQ(3,
+              m_dbManager.QueryOne<int64_t>("SELECT COUNT(*) FROM WalletTransaction;")
+                  .value_or(0));
+    EXPECT_EQ(1, m_dbManager.QueryOne<int64_t>("SELECT COUNT(*) FROM Transfer;")
+                     .value_or(0));
+}
+
+TEST_F(WalletManagerTest, RecordBatchWithStaleBalance)
+{
+    m_walletManager->CreateWallet("w1", Money(100));
+
+    m_dbManager.Execute("UPDATE Wallet SET balance = 1000 WHERE name = 'w1';");
+
+    WalletOp op = { WalletOp::Type::Expense, "w1", "", "", "", "", Money(0.5) };
+    std::vector<WalletOp>                ops(200, op);
+    std::vector<WalletManager::OpStatus> results;
+
+    // The cached balance covers the batch, but the guarded update does not
+    EXPECT_FALSE(m_walletManager->RecordBatch(ops, results));
+    EXPECT_EQ(WalletManager::OpStatus::Failed, results.back());
+    EXPECT_EQ(0,
+              m_dbManager.QueryOne<int64_t>("SELECT COUNT(*) FROM WalletTransaction;")
+                  .value_or(-1));
+
+    // The cache was dropped, so the retry sees the real balance
+    EXPECT_TRUE(m_walletManager->RecordBatch(ops, results));
+    EXPECT_EQ(WalletManager::OpStatus::Recorded, results[19]);
+    EXPECT_EQ(WalletManager::OpStatus::InsufficientBalance, results[20]);
+    EXPECT_EQ(20,
+              m_dbManager.QueryOne<int64_t>("SELECT COUNT(*) FROM WalletTransaction;")
+                  .value_or(-1));
+}
+
+TEST_F(WalletManagerTest, DailyBalanceSeries)
+{
+    m_walletManager->CreateWallet("w1", Money(100));
+    m_walletManager->CreateWallet("w2", Money(0));
+
+    m_walletManager->Income("w1", "Job", "2024-01-05", "Salary", Money(50));
+    m_walletManager->Expense("w1", "Food", "2024-01-10", "Market", Money(30));
+    m_walletManager->Transfer("w1", "w2", "2024-01-10", Money(20));
+
+    // Back-dated, so only the days from the 3rd on are patched
+    m_walletManager->Expense("w1", "Food", "2024-01-03", "Bakery", Money(10));
+
+    Money balance;
+
+    ASSERT_TRUE(m_walletManager->GetBalanceAsOf("w1", "2024-01-01", balance));
+    EXPECT_EQ(Money(100), balance);
+    ASSERT_TRUE(m_walletManager->GetBalanceAsOf("w1", "2024-01-04", balance));
+    EXPECT_EQ(Money(90), balance);
+    ASSERT_TRUE(m_walletManager->GetBalanceAsOf("w1", "2024-01-31", balance));
+    EXPECT_EQ(Money(90), balance);
+    ASSERT_TRUE(m_walletManager->GetBalanceAsOf("w2", "2024-01-09", balance));
+    EXPECT_EQ(Money(0), balance);
+    EXPECT_FALSE(m_walletManager->GetBalanceAsOf("w3", "2024-01-09", balance));
+
+    std::vector<std::string> dates;
+    std::vector<Money>       balances;
+
+    ASSERT_TRUE(
+        m_walletManager->GetBalanceSeries("w1", "2024-01-04", "2024-01-10", dates,
+                                          balances));
+
+    EXPECT_EQ(std::vector<std::string>({ "2024-01-05", "2024-01-10" }), dates);
+    EXPECT_EQ(std::vector<Money>({ Money(140), Money(90) }), balances);
+
+    // Filling the series from the history gives the same days
+    ASSERT_TRUE(m_dbManager.Execute("DELETE FROM WalletDailyBalance;"));
+    ASSERT_TRUE(m_dbManager.Execute(query::MIGRATION_WALLET_DAILY_BALANCES));
+
+    ASSERT_TRUE(
+        m_walletManager->GetBalanceSeries("w1", "2024-01-01", "2024-01-31", dates,
+                                          balances));
+
+    EXPECT_EQ(std::vector<std::string>({ "2024-01-03", "2024-01-05", "2024-01-10" }),
+              dates);
+    EXPECT_EQ(std::vector<Money>({ Money(90), Money(140), Money(90) }), balances);
+}
+
+TEST_F(WalletManagerTest, RecordBatchUpdatesDailyBalances)
+{
+    m_walletManager->CreateWallet("w1", Money(100));
+
+    std::vector<WalletOp> ops = {
+        { WalletOp::Type::Income, "w1", "", "Job", "2024-02-01", "", Money(40) },
+        { WalletOp::Type::Expense, "w1", "", "Food", "2024-01-01", "", Money(40) }
+    };
+    std::vector<WalletManager::OpStatus> results;
+
+    // The net change is zero, but both days still move
+    ASSERT_TRUE(m_walletManager->RecordBatch(ops, results));
+
+    std::vector<std::string> dates;
+    std::vector<Money>       balances;
+
+    ASSERT_TRUE(
+        m_walletManager->GetBalanceSeries("w1", "2024-01-01", "2024-12-31", dates,
+                                          balances));
+
+    EXPECT_EQ(std::vector<std::string>({ "2024-01-01", "2024-02-01" }), dates);
+    EXPECT_EQ(std::vector<Money>({ Money(60), Money(100) }), balances);
 }